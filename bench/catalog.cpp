@@ -0,0 +1,336 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/bench/catalog.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <numeric>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static std::string to_dims(const std::vector<std::size_t>& lens) { return to_string_range(lens, "x"); }
+
+static std::string to_dims(const std::vector<shape>& inputs)
+{
+    std::vector<std::string> result(inputs.size());
+    std::transform(inputs.begin(), inputs.end(), result.begin(), [](const shape& s) {
+        return to_dims(s.lens());
+    });
+    return join_strings(result, ",");
+}
+
+// Return every element of a tuple so the whole output is computed
+static void add_return(module& m, instruction_ref ins)
+{
+    if(ins->get_shape().type() != shape::tuple_type)
+    {
+        m.add_return({ins});
+        return;
+    }
+    std::vector<instruction_ref> outputs;
+    for(std::size_t i = 0; i < ins->get_shape().sub_shapes().size(); i++)
+        outputs.push_back(m.add_instruction(make_op("get_tuple_elem", {{"index", i}}), ins));
+    m.add_return(outputs);
+}
+
+// An operator applied to parameters of the given shapes, where the tag tells apart cases that
+// only differ by attributes
+static bench_case single(const std::string& name,
+                         const std::vector<shape>& inputs,
+                         const value& attributes = {},
+                         const std::string& tag  = "")
+{
+    auto case_name = name + "/" + to_dims(inputs) + (tag.empty() ? "" : ":" + tag);
+    return {case_name, name, [=] {
+                program p;
+                auto* mm = p.get_main_module();
+                std::vector<instruction_ref> args;
+                for(const auto& s : inputs)
+                    args.push_back(mm->add_parameter("x" + std::to_string(args.size()), s));
+                auto op = attributes.empty() ? make_op(name) : make_op(name, attributes);
+                add_return(*mm, mm->add_instruction(op, args));
+                return p;
+            }};
+}
+
+static shape float_shape(std::vector<std::size_t> lens)
+{
+    return {shape::float_type, std::move(lens)};
+}
+
+static void add_dot(std::vector<bench_case>& cases)
+{
+    cases.push_back(single("dot", {float_shape({64, 64}), float_shape({64, 64})}));
+    cases.push_back(single("dot", {float_shape({256, 256}), float_shape({256, 256})}));
+    cases.push_back(single("dot", {float_shape({128, 768}), float_shape({768, 768})}));
+    cases.push_back(single("dot", {float_shape({8, 128, 64}), float_shape({8, 64, 128})}));
+}
+
+static void add_convolution(std::vector<bench_case>& cases)
+{
+    cases.push_back(single("convolution",
+                           {float_shape({1, 64, 56, 56}), float_shape({64, 64, 3, 3})},
+                           {{"padding", {1, 1}}}));
+    cases.push_back(single("convolution",
+                           {float_shape({1, 3, 224, 224}), float_shape({32, 3, 3, 3})},
+                           {{"padding", {1, 1}}, {"stride", {2, 2}}}));
+    cases.push_back(
+        single("convolution", {float_shape({1, 256, 14, 14}), float_shape({64, 256, 1, 1})}));
+    cases.push_back(single("convolution",
+                           {float_shape({1, 32, 112, 112}), float_shape({32, 1, 3, 3})},
+                           {{"padding", {1, 1}}, {"group", 32}}));
+}
+
+static void add_contiguous(std::vector<bench_case>& cases)
+{
+    auto transposed = [](std::vector<std::size_t> lens, std::vector<int64_t> perm) {
+        auto s = float_shape(std::move(lens));
+        return bench_case{"contiguous/" + to_dims(s.lens()) + ":" + to_string_range(perm, ","),
+                          "contiguous",
+                          [=] {
+                              program p;
+                              auto* mm = p.get_main_module();
+                              auto x   = mm->add_parameter("x", s);
+                              auto t   = mm->add_instruction(
+                                  make_op("transpose", {{"permutation", perm}}), x);
+                              add_return(*mm, mm->add_instruction(make_op("contiguous"), t));
+                              return p;
+                          }};
+    };
+    // A single axis of the input is broadcast to the output lens
+    auto broadcast = [](std::vector<std::size_t> out_lens, std::size_t axis) {
+        auto s = float_shape({out_lens[axis]});
+        return bench_case{"contiguous/" + to_dims(out_lens) + ":broadcast" + std::to_string(axis),
+                          "contiguous",
+                          [=] {
+                              program p;
+                              auto* mm = p.get_main_module();
+                              auto x   = mm->add_parameter("x", s);
+                              auto b   = mm->add_instruction(
+                                  make_op("broadcast", {{"axis", axis}, {"out_lens", out_lens}}),
+                                  x);
+                              add_return(*mm, mm->add_instruction(make_op("contiguous"), b));
+                              return p;
+                          }};
+    };
+    cases.push_back(transposed({64, 128, 128}, {0, 2, 1}));
+    cases.push_back(transposed({2048, 2048}, {1, 0}));
+    cases.push_back(transposed({1, 64, 56, 56}, {0, 2, 3, 1}));
+    cases.push_back(transposed({16, 56, 56, 64}, {0, 3, 1, 2}));
+    cases.push_back(transposed({8, 128, 12, 64}, {0, 2, 1, 3}));
+    cases.push_back(broadcast({16, 64, 56, 56}, 1));
+    cases.push_back(broadcast({2048, 2048}, 1));
+}
+
+static void add_softmax(std::vector<bench_case>& cases)
+{
+    cases.push_back(single("softmax", {float_shape({64, 1000})}, {{"axis", 1}}));
+    cases.push_back(single("softmax", {float_shape({8, 12, 128, 128})}, {{"axis", 3}}));
+}
+
+static void add_reductions(std::vector<bench_case>& cases)
+{
+    cases.push_back(single("reduce_sum", {float_shape({64, 1024})}, {{"axes", {1}}}));
+    cases.push_back(single("reduce_mean", {float_shape({8, 64, 56, 56})}, {{"axes", {2, 3}}}));
+    cases.push_back(single("reduce_max", {float_shape({1024, 1024})}, {{"axes", {0}}}));
+}
+
+static void add_gather(std::vector<bench_case>& cases)
+{
+    auto gather = [](std::vector<std::size_t> lens, int64_t axis, std::size_t n) {
+        auto s = float_shape(std::move(lens));
+        shape is{shape::int32_type, {n}};
+        return bench_case{"gather/" + to_dims(s.lens()) + ":" + std::to_string(axis) + "," +
+                              std::to_string(n),
+                          "gather",
+                          [=] {
+                              program p;
+                              auto* mm = p.get_main_module();
+                              auto x   = mm->add_parameter("x", s);
+                              // Spread the indices evenly over the gathered axis
+                              std::vector<int32_t> indices(n);
+                              auto len = s.lens()[axis];
+                              std::generate(indices.begin(), indices.end(), [&, i = 0]() mutable {
+                                  return (i++ * 7919) % len;
+                              });
+                              auto idx = mm->add_literal(literal{is, indices});
+                              add_return(*mm,
+                                         mm->add_instruction(
+                                             make_op("gather", {{"axis", axis}}), x, idx));
+                              return p;
+                          }};
+    };
+    cases.push_back(gather({10000, 256}, 0, 128));
+    cases.push_back(gather({64, 1000}, 1, 100));
+}
+
+static void add_topk(std::vector<bench_case>& cases)
+{
+    cases.push_back(single("topk", {float_shape({64, 1000})}, {{"k", 5}, {"axis", 1}}, "5"));
+    cases.push_back(single("topk", {float_shape({8, 10000})}, {{"k", 100}, {"axis", 1}}, "100"));
+}
+
+static void add_nonmaxsuppression(std::vector<bench_case>& cases)
+{
+    auto nms = [](std::size_t boxes, std::size_t classes) {
+        auto boxes_s  = float_shape({1, boxes, 4});
+        auto scores_s = float_shape({1, classes, boxes});
+        return bench_case{"nonmaxsuppression/" + to_dims({boxes_s, scores_s}),
+                          "nonmaxsuppression",
+                          [=] {
+                              program p;
+                              auto* mm    = p.get_main_module();
+                              auto b      = mm->add_parameter("boxes", boxes_s);
+                              auto s      = mm->add_parameter("scores", scores_s);
+                              auto max_out = mm->add_literal(int64_t{100});
+                              auto iou     = mm->add_literal(0.5f);
+                              auto score   = mm->add_literal(0.0f);
+                              add_return(*mm,
+                                         mm->add_instruction(make_op("nonmaxsuppression"),
+                                                             b,
+                                                             s,
+                                                             max_out,
+                                                             iou,
+                                                             score));
+                              return p;
+                          }};
+    };
+    cases.push_back(nms(1000, 1));
+    cases.push_back(nms(1000, 4));
+}
+
+static void add_resize(std::vector<bench_case>& cases)
+{
+    cases.push_back(single("resize",
+                           {float_shape({1, 64, 56, 56})},
+                           {{"scales", {1.0f, 1.0f, 2.0f, 2.0f}},
+                            {"nearest_mode", "floor"},
+                            {"coordinate_transformation_mode", "asymmetric"}},
+                           "up"));
+    cases.push_back(single("resize",
+                           {float_shape({1, 64, 112, 112})},
+                           {{"scales", {1.0f, 1.0f, 0.5f, 0.5f}},
+                            {"nearest_mode", "round_prefer_floor"},
+                            {"coordinate_transformation_mode", "half_pixel"}},
+                           "down"));
+}
+
+static void add_pointwise(std::vector<bench_case>& cases)
+{
+    // A fused module of ops applied to two inputs, as fuse_pointwise would create
+    auto fused = [](const std::string& name, std::vector<std::string> ops, shape s) {
+        return bench_case{"pointwise/" + name + "/" + to_dims(s.lens()), "pointwise", [=] {
+                              program p;
+                              auto* mm = p.get_main_module();
+                              auto x   = mm->add_parameter("x", s);
+                              auto y   = mm->add_parameter("y", s);
+                              auto* pm = p.create_module("pointwise");
+                              pm->set_bypass();
+                              auto px = pm->add_parameter("x0", shape{s.type()});
+                              auto py = pm->add_parameter("x1", shape{s.type()});
+                              auto r  = pm->add_instruction(make_op(ops.front()), px, py);
+                              for(auto it = ops.begin() + 1; it != ops.end(); ++it)
+                                  r = pm->add_instruction(make_op(*it), r);
+                              pm->add_return({r});
+                              add_return(*mm,
+                                         mm->add_instruction(make_op("pointwise"), {x, y}, {pm}));
+                              return p;
+                          }};
+    };
+    cases.push_back(fused("add_relu", {"add", "relu"}, float_shape({64, 1024})));
+    cases.push_back(fused("mul_sigmoid", {"mul", "sigmoid"}, float_shape({1, 256, 56, 56})));
+    cases.push_back(fused("sub_exp_neg", {"sub", "exp", "neg"}, float_shape({4096, 1024})));
+}
+
+static void add_group_query_attention(std::vector<bench_case>& cases)
+{
+    // A single token decode step against a key-value cache
+    auto gqa = [](std::size_t num_heads, std::size_t kv_heads, std::size_t seq, std::size_t head) {
+        shape q_s{shape::float_type, {1, 1, (num_heads + 2 * kv_heads) * head}};
+        shape kv_s{shape::float_type, {1, kv_heads, seq, head}};
+        shape cs_s{shape::float_type, {seq, head / 2}};
+        shape seq_s{shape::int64_type, {1, 1}};
+        return bench_case{"group_query_attention/" + to_dims({q_s, kv_s}),
+                          "group_query_attention",
+                          [=] {
+                              program p;
+                              auto* mm = p.get_main_module();
+                              auto q   = mm->add_parameter("query", q_s);
+                              auto k_cache = mm->add_parameter("k_cache", kv_s);
+                              auto v_cache = mm->add_parameter("v_cache", kv_s);
+                              auto cos = mm->add_parameter("cos_cache", cs_s);
+                              auto sin = mm->add_parameter("sin_cache", cs_s);
+                              auto past = mm->add_literal(
+                                  literal{seq_s, std::vector<int64_t>{int64_t(seq / 2)}});
+                              auto total = mm->add_literal(
+                                  literal{seq_s, std::vector<int64_t>{int64_t(seq / 2 + 1)}});
+                              auto key   = mm->add_literal(0.0f);
+                              auto value = mm->add_literal(0.0f);
+                              auto r     = mm->add_instruction(
+                                  make_op("group_query_attention",
+                                          {{"do_rotary", 1},
+                                           {"kv_num_heads", kv_heads},
+                                           {"local_window_size", -1},
+                                           {"num_heads", num_heads},
+                                           {"rotary_interleaved", 0}}),
+                                  q,
+                                  key,
+                                  value,
+                                  k_cache,
+                                  v_cache,
+                                  past,
+                                  total,
+                                  cos,
+                                  sin);
+                              add_return(*mm, r);
+                              return p;
+                          }};
+    };
+    cases.push_back(gqa(8, 8, 512, 64));
+    cases.push_back(gqa(16, 4, 1024, 64));
+}
+
+std::vector<bench_case> get_catalog()
+{
+    std::vector<bench_case> cases;
+    add_dot(cases);
+    add_convolution(cases);
+    add_contiguous(cases);
+    add_softmax(cases);
+    add_reductions(cases);
+    add_gather(cases);
+    add_topk(cases);
+    add_nonmaxsuppression(cases);
+    add_resize(cases);
+    add_pointwise(cases);
+    add_group_query_attention(cases);
+    return cases;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/time.hpp>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+// Times memory_coloring on synthetic modules with tens of thousands of instructions, and compares
+// the planned scratch memory with the most memory that is live at once.
+
+struct allocate
+{
+    migraphx::shape s{};
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.s, "shape"));
+    }
+
+    std::string name() const { return "allocate"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        migraphx::check_shapes{inputs, *this}.has(0);
+        return s;
+    }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape& output_shape,
+                               const std::vector<migraphx::argument>&) const
+    {
+        return migraphx::argument{output_shape};
+    }
+};
+
+// Writes its first input, which is the allocation, and reads the others
+struct pass_op
+{
+    std::string name() const { return "pass"; }
+    migraphx::argument compute(const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        return args.front();
+    }
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+    int output_alias(const std::vector<migraphx::shape>&) const { return 0; }
+};
+
+// Creates n allocations, each one written by a pass that also reads a few results from a window
+// of recent passes. Returns the most bytes that are live at once.
+static std::size_t create_module(migraphx::module& m, std::size_t n, std::size_t window)
+{
+    std::mt19937 gen(n);
+    std::vector<migraphx::instruction_ref> results;
+    std::vector<std::size_t> bytes;
+    std::vector<std::size_t> last_use;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        // Sizes vary from a few bytes up to 1MB
+        std::size_t elements = std::size_t{1} << (gen() % 18);
+        auto alloc = m.add_instruction(allocate{{migraphx::shape::float_type, {elements}}});
+        std::vector<migraphx::instruction_ref> inputs = {alloc};
+        std::size_t w                                 = std::min(results.size(), window);
+        for(std::size_t j = 0; j < std::min<std::size_t>(w, 3); j++)
+        {
+            auto k = results.size() - 1 - gen() % w;
+            inputs.push_back(results[k]);
+            last_use[k] = i;
+        }
+        results.push_back(m.add_instruction(pass_op{}, inputs));
+        bytes.push_back(alloc->get_shape().bytes());
+        last_use.push_back(i);
+    }
+    m.add_instruction(pass_op{}, {results.end() - 1, results.end()});
+
+    std::vector<std::ptrdiff_t> live(n + 1);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        live[i] += bytes[i];
+        live[last_use[i] + 1] -= bytes[i];
+    }
+    std::partial_sum(live.begin(), live.end(), live.begin());
+    return *std::max_element(live.begin(), live.end());
+}
+
+static void run_benchmark(std::size_t n, std::size_t window)
+{
+    migraphx::module m;
+    auto max_live      = create_module(m, n, window);
+    auto ninstructions = m.size();
+    double ms          = migraphx::time<std::chrono::duration<double, std::milli>>(
+        [&] { migraphx::memory_coloring{"allocate"}.apply(m); });
+    auto scratch = m.get_parameter_shape("scratch").bytes();
+    std::cout << ninstructions << " instructions, window " << window << ": " << ms << "ms, "
+              << scratch << " bytes planned, " << max_live << " bytes live at most ("
+              << 100.0 * scratch / max_live << "%)" << std::endl;
+    if(scratch < max_live)
+        MIGRAPHX_THROW("Planned less memory than is live at once");
+}
+
+int main()
+{
+    run_benchmark(5000, 64);
+    run_benchmark(50000, 64);
+    run_benchmark(50000, 1024);
+}
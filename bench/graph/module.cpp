@@ -0,0 +1,138 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/time.hpp>
+#include <iostream>
+#include <string>
+#include <random>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Times building, copying and running passes over modules with tens of thousands of
+// instructions, and reports the peak memory of the process after each step.
+
+static std::size_t peak_memory_kb()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#endif
+}
+
+// A pointwise operator whose shape computation is trivial, so the timings measure the module and
+// the passes rather than the operators
+struct bench_op
+{
+    std::string op_name;
+    std::string name() const { return op_name; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front();
+    }
+    friend bool operator==(const bench_op& x, const bench_op& y) { return x.op_name == y.op_name; }
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.op_name, "name"));
+    }
+};
+
+// Creates a graph of pointwise operators where every instruction reads a few recent results, and
+// about a quarter of the instructions are duplicates for eliminate_common_subexpression to merge
+static void create_module(migraphx::module& m, std::size_t n)
+{
+    std::mt19937 gen(n);
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<migraphx::instruction_ref> results = {
+        m.add_parameter("x", s), m.add_literal(migraphx::literal{s, {1, 2, 3, 4}})};
+    const std::vector<std::string> ops = {"add", "mul", "sub", "max"};
+    auto recent                        = [&] {
+        return results[results.size() - 1 - gen() % std::min<std::size_t>(results.size(), 8)];
+    };
+    while(m.size() < n)
+    {
+        auto a   = recent();
+        auto b   = recent();
+        auto op  = bench_op{ops[gen() % ops.size()]};
+        auto ins = m.add_instruction(op, a, b);
+        if(gen() % 4 == 0)
+            ins = m.add_instruction(op, a, b);
+        results.push_back(ins);
+    }
+    m.add_return({results.back()});
+}
+
+static void run_benchmark(std::size_t n)
+{
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    auto start_kb      = peak_memory_kb();
+    migraphx::module m;
+    double build_ms = migraphx::time<milliseconds>([&] { create_module(m, n); });
+    auto build_kb   = peak_memory_kb();
+
+    std::size_t found = 0;
+    double lookup_ms  = migraphx::time<milliseconds>([&] {
+        for(auto ins : migraphx::iterator_for(m))
+            found += std::count_if(ins->inputs().begin(),
+                                   ins->inputs().end(),
+                                   [&](auto input) { return m.has_instruction(input); });
+    });
+
+    double copy_ms = 0;
+    {
+        migraphx::module copy;
+        copy_ms = migraphx::time<milliseconds>([&] { copy = m; });
+    }
+
+    auto ninstructions = m.size();
+    double passes_ms   = migraphx::time<milliseconds>([&] {
+        // Apply the passes directly, since validating the module after each pass is quadratic
+        migraphx::eliminate_common_subexpression{}.apply(m);
+        migraphx::dead_code_elimination{}.apply(m);
+    });
+    auto end_kb = peak_memory_kb();
+
+    std::cout << ninstructions << " instructions: build " << build_ms << "ms, has_instruction "
+              << lookup_ms << "ms (" << found << " found), copy " << copy_ms << "ms, passes "
+              << passes_ms << "ms (" << m.size() << " instructions left)" << std::endl;
+    std::cout << "Peak memory: " << (build_kb - start_kb) << "KB after build, "
+              << (end_kb - start_kb) << "KB after passes" << std::endl;
+}
+
+int main()
+{
+    run_benchmark(5000);
+    run_benchmark(50000);
+    run_benchmark(200000);
+}
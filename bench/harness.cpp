@@ -0,0 +1,184 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/bench/harness.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/op_cost.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/time.hpp>
+#include <migraphx/version.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <numeric>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    auto index = static_cast<std::size_t>(std::ceil(p * sorted.size())) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+summary summary::compute(std::vector<double> times)
+{
+    summary result;
+    if(times.empty())
+        return result;
+    std::sort(times.begin(), times.end());
+    auto n        = times.size();
+    result.n      = n;
+    result.min    = times.front();
+    result.max    = times.back();
+    result.mean   = std::accumulate(times.begin(), times.end(), 0.0) / n;
+    result.median = n % 2 == 0 ? (times[n / 2 - 1] + times[n / 2]) / 2.0 : times[n / 2];
+    double sq     = std::accumulate(times.begin(), times.end(), 0.0, [&](double acc, double t) {
+        return acc + (t - result.mean) * (t - result.mean);
+    });
+    result.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0.0;
+    result.p90    = percentile(times, 0.90);
+    result.p99    = percentile(times, 0.99);
+    return result;
+}
+
+bench_result run(const bench_case& c, const std::string& target, const bench_options& options)
+{
+    bench_result result;
+    result.name   = c.name;
+    result.op     = c.op;
+    result.target = target;
+
+    auto p   = c.create();
+    auto* mm = p.get_main_module();
+    // Estimate the cost before the target lowers the operators
+    for(auto ins : iterator_for(*mm))
+    {
+        auto cost = estimate_cost(ins);
+        result.flops += cost.flops;
+        result.bytes += cost.bytes;
+    }
+
+    p.compile(make_target(target));
+    parameter_map params;
+    unsigned long seed = 0;
+    for(auto&& [name, s] : p.get_parameter_shapes())
+        params[name] = generate_argument(s, seed++);
+
+    for(std::size_t i = 0; i < options.warmup; i++)
+    {
+        p.eval(params);
+        p.finish();
+    }
+    std::vector<double> times;
+    times.reserve(options.iterations);
+    for(std::size_t i = 0; i < options.iterations; i++)
+    {
+        times.push_back(time<milliseconds>([&] {
+            p.eval(params);
+            p.finish();
+        }));
+    }
+    result.time = summary::compute(std::move(times));
+    return result;
+}
+
+value results_to_value(const std::vector<bench_result>& results, const bench_options& options)
+{
+    value v;
+    v["version"] = std::to_string(MIGRAPHX_VERSION_MAJOR) + "." +
+                   std::to_string(MIGRAPHX_VERSION_MINOR) + "." +
+                   std::to_string(MIGRAPHX_VERSION_PATCH);
+    v["warmup"]     = options.warmup;
+    v["iterations"] = options.iterations;
+    v["results"]    = migraphx::to_value(results);
+    return v;
+}
+
+std::vector<bench_result> results_from_value(const value& v)
+{
+    return from_value<std::vector<bench_result>>(v.at("results"));
+}
+
+void print(std::ostream& os, const bench_result& r)
+{
+    os << r.target << " " << r.name << ": " << r.time.median << "ms";
+    os << " (min: " << r.time.min << "ms, mean: " << r.time.mean
+       << "ms, stddev: " << r.time.stddev << "ms, p90: " << r.time.p90 << "ms)";
+    if(r.time.median > 0 and r.flops > 0)
+        os << ", " << r.flops / r.time.median / 1.0e6 << " GFLOP/s";
+    if(r.time.median > 0 and r.bytes > 0)
+        os << ", " << r.bytes / r.time.median / 1.0e6 << " GB/s";
+    os << std::endl;
+}
+
+std::vector<comparison> compare(const std::vector<bench_result>& baseline,
+                                const std::vector<bench_result>& current)
+{
+    std::map<std::pair<std::string, std::string>, double> base_times;
+    for(const auto& r : baseline)
+        base_times[{r.target, r.name}] = r.time.median;
+    std::vector<comparison> result;
+    for(const auto& r : current)
+    {
+        auto it = base_times.find({r.target, r.name});
+        if(it == base_times.end() or it->second <= 0)
+            continue;
+        result.push_back({r.name, r.target, it->second, r.time.median});
+    }
+    return result;
+}
+
+std::size_t
+print_comparisons(std::ostream& os, const std::vector<comparison>& comparisons, double threshold)
+{
+    std::size_t regressions = 0;
+    for(const auto& c : comparisons)
+    {
+        auto change = c.change();
+        os << c.target << " " << c.name << ": " << c.baseline << "ms -> " << c.current << "ms ("
+           << std::showpos << std::round(change * 1000.0) / 10.0 << std::noshowpos << "%)";
+        if(change > threshold)
+        {
+            os << " REGRESSION";
+            regressions++;
+        }
+        else if(change < -threshold)
+        {
+            os << " improved";
+        }
+        os << std::endl;
+    }
+    return regressions;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_BENCH_HARNESS_HPP
+#define MIGRAPHX_GUARD_BENCH_HARNESS_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/value.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// A program that runs one operator on a representative set of shapes
+struct bench_case
+{
+    /// Unique name of the case, such as `dot/256x256x256`
+    std::string name;
+    /// Name of the operator being measured
+    std::string op;
+    std::function<program()> create;
+};
+
+struct bench_options
+{
+    /// Runs before timing starts, to warm the caches and trigger any lazy compilation
+    std::size_t warmup = 5;
+    std::size_t iterations = 100;
+};
+
+/// Statistics of the time, in milliseconds, of each iteration
+struct summary
+{
+    std::size_t n = 0;
+    double min    = 0;
+    double max    = 0;
+    double mean   = 0;
+    double median = 0;
+    double stddev = 0;
+    double p90    = 0;
+    double p99    = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.n, "n"),
+                    f(self.min, "min"),
+                    f(self.max, "max"),
+                    f(self.mean, "mean"),
+                    f(self.median, "median"),
+                    f(self.stddev, "stddev"),
+                    f(self.p90, "p90"),
+                    f(self.p99, "p99"));
+    }
+
+    static summary compute(std::vector<double> times);
+};
+
+struct bench_result
+{
+    std::string name;
+    std::string op;
+    std::string target;
+    summary time;
+    /// Estimated arithmetic and bytes moved by the operators in the case
+    double flops = 0;
+    double bytes = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.name, "name"),
+                    f(self.op, "op"),
+                    f(self.target, "target"),
+                    f(self.time, "time"),
+                    f(self.flops, "flops"),
+                    f(self.bytes, "bytes"));
+    }
+};
+
+/// Compile the case for the target and time its evaluation
+bench_result run(const bench_case& c, const std::string& target, const bench_options& options);
+
+/// The results, along with the options used, as the object written to the json output
+value results_to_value(const std::vector<bench_result>& results, const bench_options& options);
+
+std::vector<bench_result> results_from_value(const value& v);
+
+void print(std::ostream& os, const bench_result& r);
+
+struct comparison
+{
+    std::string name;
+    std::string target;
+    double baseline = 0;
+    double current  = 0;
+
+    /// Relative change of the median time, where positive is slower
+    double change() const { return current / baseline - 1.0; }
+};
+
+/// Match the cases run on the same target in both results
+std::vector<comparison> compare(const std::vector<bench_result>& baseline,
+                                const std::vector<bench_result>& current);
+
+/// Print the comparisons and return the number that got slower by more than the threshold
+std::size_t
+print_comparisons(std::ostream& os, const std::vector<comparison>& comparisons, double threshold);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_BENCH_HARNESS_HPP
@@ -0,0 +1,132 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/bench/catalog.hpp>
+#include <migraphx/bench/harness.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/stringutils.hpp>
+#include <iostream>
+
+using namespace migraphx;        // NOLINT
+using namespace migraphx::bench; // NOLINT
+
+static void usage()
+{
+    std::cout << "Usage: migraphx-bench [--target ref,cpu] [--filter <name>] [--iterations <n>]"
+                 " [--warmup <n>] [--output <file.json>] [--list]"
+              << std::endl;
+    std::cout << "       migraphx-bench compare <baseline.json> <current.json> [--threshold <pct>]"
+              << std::endl;
+}
+
+static std::vector<std::string> default_targets()
+{
+    std::vector<std::string> targets = {"ref"};
+#ifdef HAVE_CPU
+    targets.push_back("cpu");
+#endif
+    return targets;
+}
+
+static int compare_files(const std::vector<std::string>& args)
+{
+    if(args.size() < 4)
+    {
+        usage();
+        return 1;
+    }
+    double threshold = 5;
+    for(std::size_t i = 4; i + 1 < args.size(); i += 2)
+    {
+        if(args[i] == "--threshold")
+            threshold = std::stod(args[i + 1]);
+    }
+    auto baseline = results_from_value(from_json_string(read_string(args[2])));
+    auto current  = results_from_value(from_json_string(read_string(args[3])));
+    auto regressions =
+        print_comparisons(std::cout, compare(baseline, current), threshold / 100.0);
+    if(regressions == 0)
+        return 0;
+    std::cout << regressions << " regression(s) over " << threshold << "%" << std::endl;
+    return 1;
+}
+
+int main(int argc, char const* argv[])
+{
+    std::vector<std::string> args(argv, argv + argc);
+    if(args.size() > 1 and args[1] == "compare")
+        return compare_files(args);
+
+    bench_options options;
+    std::vector<std::string> targets = default_targets();
+    std::string filter;
+    std::string output;
+    bool list = false;
+    for(std::size_t i = 1; i < args.size(); i++)
+    {
+        const auto& arg = args[i];
+        auto next       = [&]() -> const std::string& {
+            if(i + 1 >= args.size())
+                MIGRAPHX_THROW("Missing value for " + arg);
+            return args[++i];
+        };
+        if(arg == "--target")
+            targets = split_string(next(), ',');
+        else if(arg == "--filter")
+            filter = next();
+        else if(arg == "--iterations")
+            options.iterations = std::stoul(next());
+        else if(arg == "--warmup")
+            options.warmup = std::stoul(next());
+        else if(arg == "--output")
+            output = next();
+        else if(arg == "--list")
+            list = true;
+        else
+        {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<bench_result> results;
+    for(const auto& c : get_catalog())
+    {
+        if(c.name.find(filter) == std::string::npos)
+            continue;
+        if(list)
+        {
+            std::cout << c.name << std::endl;
+            continue;
+        }
+        for(const auto& t : targets)
+        {
+            results.push_back(run(c, t, options));
+            print(std::cout, results.back());
+        }
+    }
+    if(not output.empty())
+        write_string(output, to_pretty_json_string(results_to_value(results, options)));
+}
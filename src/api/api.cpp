@@ -27,6 +27,7 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/session.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/tf.hpp>
 #include <migraphx/instruction_ref.hpp>
@@ -292,6 +293,8 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(session& s, const parameter_map& params) { return s.eval(params); }
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }
@@ -614,6 +617,17 @@ struct migraphx_program
     migraphx::program object;
 };
 
+extern "C" struct migraphx_session;
+struct migraphx_session
+{
+    template <class... Ts>
+    migraphx_session(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::session object;
+};
+
 extern "C" struct migraphx_operation;
 struct migraphx_operation
 {
@@ -1762,6 +1776,54 @@ migraphx_program_experimental_get_context(migraphx_context_t* out, const_migraph
     return api_error_result;
 }
 
+extern "C" migraphx_status migraphx_session_destroy(migraphx_session_t session)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((session)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_session_assign_to(migraphx_session_t output,
+                                                      const_migraphx_session_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_session_create(migraphx_session_t* session,
+                                                   const_migraphx_program_t p)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(p == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter p: Null pointer");
+        *session = object_cast<migraphx_session_t>(allocate<migraphx::session>((p->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_session_run(migraphx_arguments_t* out,
+                                                migraphx_session_t session,
+                                                migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(session == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter session: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_arguments_t>(migraphx::run((session->object), (params->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_session_finish(const_migraphx_session_t session)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(session == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter session: Null pointer");
+        (session->object).finish();
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_operation_destroy(migraphx_operation_t operation)
 {
     auto api_error_result = migraphx::try_([&] { destroy((operation)); });
@@ -120,6 +120,9 @@ typedef const struct migraphx_module* const_migraphx_module_t;
 typedef struct migraphx_program* migraphx_program_t;
 typedef const struct migraphx_program* const_migraphx_program_t;
 
+typedef struct migraphx_session* migraphx_session_t;
+typedef const struct migraphx_session* const_migraphx_session_t;
+
 typedef struct migraphx_operation* migraphx_operation_t;
 typedef const struct migraphx_operation* const_migraphx_operation_t;
 
@@ -473,6 +476,20 @@ MIGRAPHX_C_EXPORT migraphx_status migraphx_program_equal(bool* out,
 MIGRAPHX_C_EXPORT migraphx_status migraphx_program_experimental_get_context(
     migraphx_context_t* out, const_migraphx_program_t program);
 
+MIGRAPHX_C_EXPORT migraphx_status migraphx_session_destroy(migraphx_session_t session);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_session_assign_to(migraphx_session_t output,
+                                                             const_migraphx_session_t input);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_session_create(migraphx_session_t* session,
+                                                          const_migraphx_program_t p);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_session_run(migraphx_arguments_t* out,
+                                                       migraphx_session_t session,
+                                                       migraphx_program_parameters_t params);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_session_finish(const_migraphx_session_t session);
+
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_destroy(migraphx_operation_t operation);
 
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_assign_to(migraphx_operation_t output,
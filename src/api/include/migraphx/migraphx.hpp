@@ -1255,6 +1255,33 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
     friend bool operator!=(const program& px, const program& py) { return not(px == py); }
 };
 
+/// An independent execution state for a compiled program, with its own contexts and scratch
+/// buffers. Sessions of the same program share its instructions and literals and can be run
+/// concurrently from different threads.
+struct session : MIGRAPHX_HANDLE_BASE(session)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(session)
+
+    session(const program& p) : prog(p)
+    {
+        this->make_handle(&migraphx_session_create, p.get_handle_ptr());
+    }
+
+    /// Run the program using the inputs passed in
+    arguments eval(const program_parameters& pparams) const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_session_run, &pout, this->get_handle_ptr(), pparams.get_handle_ptr());
+        return arguments(pout, own{});
+    }
+
+    void finish() const { call(&migraphx_session_finish, this->get_handle_ptr()); }
+
+    private:
+    // Keep the program alive while the session uses it
+    program prog;
+};
+
 // options for migraphx file format options
 struct file_options : MIGRAPHX_HANDLE_BASE(file_options)
 {
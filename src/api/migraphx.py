@@ -297,6 +297,17 @@ def program(h):
              returns='migraphx::context')
 
 
+@auto_handle()
+def session(h):
+    h.constructor('create', api.params(p='const migraphx::program&'))
+    h.method('run',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>'),
+             invoke='migraphx::run($@)',
+             returns='std::vector<migraphx::argument>')
+    h.method('finish', const=True)
+
+
 @auto_handle()
 def operation(h):
     h.constructor('create',
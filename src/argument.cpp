@@ -23,6 +23,7 @@
  */
 #include <migraphx/argument.hpp>
 #include <migraphx/functional.hpp>
+#include <algorithm>
 #include <unordered_map>
 
 namespace migraphx {
@@ -151,6 +152,14 @@ argument argument::reshape(const shape& s) const
     return {s, this->m_data};
 }
 
+argument argument::view(const shape& s, std::size_t offset) const
+{
+    assert(m_shape.type() != shape::tuple_type);
+    data_t d = m_data;
+    d.get    = [get = m_data.get, offset]() mutable { return get() + offset; };
+    return {s, d};
+}
+
 argument::data_t argument::data_t::share() const
 {
     data_t result;
@@ -159,12 +168,27 @@ argument::data_t argument::data_t::share() const
         auto self  = std::make_shared<data_t>(*this);
         result.get = [self]() mutable { return self->get(); };
     }
+    result.read_only = this->read_only;
     std::transform(sub.begin(), sub.end(), std::back_inserter(result.sub), [](const auto& d) {
         return d.share();
     });
     return result;
 }
 
+void argument::data_t::set_read_only()
+{
+    read_only = true;
+    for(auto& d : sub)
+        d.set_read_only();
+}
+
+bool argument::data_t::any_read_only() const
+{
+    return read_only or std::any_of(sub.begin(), sub.end(), [](const auto& d) {
+               return d.any_read_only();
+           });
+}
+
 argument::data_t argument::data_t::from_args(const std::vector<argument>& args)
 {
     data_t result;
@@ -182,6 +206,22 @@ argument argument::copy() const
     return result;
 }
 
+bool argument::is_read_only() const { return m_data.any_read_only(); }
+
+argument argument::writable() const
+{
+    if(not this->is_read_only())
+        return *this;
+    if(m_shape.type() == shape::tuple_type)
+    {
+        auto subs = this->get_sub_objects();
+        std::transform(
+            subs.begin(), subs.end(), subs.begin(), [](const auto& a) { return a.writable(); });
+        return argument{subs};
+    }
+    return this->copy();
+}
+
 argument argument::share() const { return {m_shape, m_data.share()}; }
 
 std::vector<argument> argument::get_sub_objects() const
@@ -0,0 +1,245 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/calibration.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/float_equal.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+std::string to_string(calibration_method method)
+{
+    switch(method)
+    {
+    case calibration_method::max: return "max";
+    case calibration_method::percentile: return "percentile";
+    case calibration_method::entropy: return "entropy";
+    }
+    MIGRAPHX_THROW("Unknown calibration method");
+}
+
+calibration_histogram::calibration_histogram(std::size_t nbins) : bins(nbins, 0) {}
+
+template <class F>
+static void visit_abs(const argument& arg, F f)
+{
+    arg.visit([&](auto v) {
+        for(auto x : v)
+        {
+            auto a = std::fabs(static_cast<float>(x));
+            // Values that can not be represented are left out of the range
+            if(std::isfinite(a))
+                f(a);
+        }
+    });
+}
+
+void calibration_histogram::add(const argument& arg)
+{
+    float arg_max = 0;
+    visit_abs(arg, [&](float a) { arg_max = std::max(arg_max, a); });
+    max_val = std::max(max_val, arg_max);
+    count += arg.get_shape().elements();
+    if(bins.empty())
+        return;
+    grow(arg_max);
+    visit_abs(arg, [&](float a) {
+        auto i = (width > 0) ? static_cast<std::size_t>(a / width) : 0;
+        bins[std::min(i, bins.size() - 1)]++;
+    });
+}
+
+void calibration_histogram::grow(float x)
+{
+    auto n = bins.size();
+    if(x <= width * n)
+        return;
+    // Before the first nonzero value every value is in the first bin, so the range can be set
+    if(float_equal(width, 0.0f))
+    {
+        width = x / n;
+        return;
+    }
+    while(x > width * n)
+    {
+        std::vector<std::size_t> merged(n, 0);
+        for(std::size_t i = 0; i < n; i++)
+            merged[i / 2] += bins[i];
+        bins = std::move(merged);
+        width *= 2;
+    }
+}
+
+bool calibration_histogram::empty() const { return count == 0; }
+
+float calibration_histogram::max_abs() const { return max_val; }
+
+const std::vector<std::size_t>& calibration_histogram::get_bins() const { return bins; }
+
+float calibration_histogram::bin_width() const { return width; }
+
+float calibration_histogram::get_threshold(const calibration_options& options,
+                                           std::size_t levels) const
+{
+    if(bins.empty() or float_equal(width, 0.0f))
+        return max_val;
+    switch(options.method)
+    {
+    case calibration_method::max: return max_val;
+    case calibration_method::percentile: return percentile_threshold(options.percentile);
+    case calibration_method::entropy: return entropy_threshold(levels);
+    }
+    MIGRAPHX_THROW("Unknown calibration method");
+}
+
+float calibration_histogram::percentile_threshold(double p) const
+{
+    auto total       = std::accumulate(bins.begin(), bins.end(), std::size_t{0});
+    auto target      = static_cast<double>(total) * p / 100.0;
+    std::size_t seen = 0;
+    for(std::size_t i = 0; i < bins.size(); i++)
+    {
+        seen += bins[i];
+        if(seen >= target)
+            return std::min(max_val, (i + 1) * width);
+    }
+    return max_val;
+}
+
+// Picks the number of bins to keep that minimizes the KL divergence between the clipped
+// histogram and the same histogram quantized to levels steps
+float calibration_histogram::entropy_threshold(std::size_t levels) const
+{
+    auto n = bins.size();
+    if(levels == 0 or n <= levels)
+        return max_val;
+    std::vector<double> prefix(n + 1, 0);
+    std::partial_sum(bins.begin(), bins.end(), prefix.begin() + 1);
+    std::vector<double> p(n);
+    std::vector<double> q(n);
+    const double eps   = 1e-4;
+    double best        = std::numeric_limits<double>::infinity();
+    std::size_t best_i = n;
+    for(std::size_t i = levels; i <= n; i++)
+    {
+        std::copy(bins.begin(), bins.begin() + i, p.begin());
+        // Values past the clipping point are saturated into the last bin
+        p[i - 1] += prefix[n] - prefix[i];
+        std::fill(q.begin(), q.begin() + i, 0.0);
+        for(std::size_t j = 0; j < levels; j++)
+        {
+            auto start   = j * i / levels;
+            auto last    = (j + 1) * i / levels;
+            auto nonzero = std::count_if(
+                bins.begin() + start, bins.begin() + last, [](auto b) { return b != 0; });
+            if(nonzero == 0)
+                continue;
+            auto avg = (prefix[last] - prefix[start]) / nonzero;
+            for(auto k = start; k < last; k++)
+            {
+                if(bins[k] != 0)
+                    q[k] = avg;
+            }
+        }
+        auto psum = std::accumulate(p.begin(), p.begin() + i, 0.0);
+        auto qsum = std::accumulate(q.begin(), q.begin() + i, 0.0);
+        if(psum == 0 or qsum == 0)
+            continue;
+        double kl = 0;
+        for(std::size_t k = 0; k < i; k++)
+        {
+            if(p[k] == 0)
+                continue;
+            // The saturated bin can be empty in q, so it is smoothed instead of being infinite
+            auto pk = p[k] / psum;
+            auto qk = (q[k] == 0) ? eps : q[k] / qsum;
+            kl += pk * std::log(pk / qk);
+        }
+        if(kl < best)
+        {
+            best   = kl;
+            best_i = i;
+        }
+    }
+    return std::min(max_val, best_i * width);
+}
+
+// The options that change the ranges, and the program they were computed for. The values are
+// strings so they compare the same after a round trip through json.
+static value calibration_key(const calibration_options& options, const std::string& fingerprint)
+{
+    value result = {{"method", to_string(options.method)}, {"program", fingerprint}};
+    if(options.method != calibration_method::max)
+        result["bins"] = std::to_string(options.bins);
+    if(options.method == calibration_method::percentile)
+        result["percentile"] = std::to_string(options.percentile);
+    return result;
+}
+
+// The json keys are sorted when the file is written, so the fields are compared by name
+static bool same_key(const value& stored, const value& key)
+{
+    return stored.size() == key.size() and
+           std::all_of(key.begin(), key.end(), [&](const auto& x) {
+               return stored.contains(x.get_key()) and stored.at(x.get_key()) == x;
+           });
+}
+
+optional<std::vector<float>> load_calibration(const fs::path& file,
+                                              const calibration_options& options,
+                                              const std::string& fingerprint,
+                                              std::size_t n)
+{
+    if(not fs::exists(file))
+        return nullopt;
+    auto v = from_json_string(read_string(file));
+    if(not v.contains("key") or not v.contains("thresholds"))
+        return nullopt;
+    if(not same_key(v.at("key"), calibration_key(options, fingerprint)))
+        return nullopt;
+    auto thresholds = v.at("thresholds").to_vector<float>();
+    if(thresholds.size() != n)
+        return nullopt;
+    return thresholds;
+}
+
+void save_calibration(const fs::path& file,
+                      const calibration_options& options,
+                      const std::string& fingerprint,
+                      const std::vector<float>& thresholds)
+{
+    value v = {{"key", calibration_key(options, fingerprint)},
+               {"thresholds", to_value(thresholds)}};
+    write_string(file, to_pretty_json_string(v));
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
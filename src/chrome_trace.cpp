@@ -0,0 +1,185 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/chrome_trace.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/stringutils.hpp>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using trace_clock = tracer::clock;
+
+struct trace_event
+{
+    std::string name;
+    std::string category;
+    trace_clock::time_point start;
+    trace_clock::time_point stop;
+    std::size_t tid = 0;
+    value args      = value::object{};
+};
+
+struct chrome_trace_impl
+{
+    trace_clock::time_point epoch = trace_clock::now();
+    std::mutex m;
+    std::vector<trace_event> events;
+    std::unordered_map<std::thread::id, std::size_t> threads;
+    // Start times of the instructions that are still running on each thread, innermost last
+    std::unordered_map<std::thread::id, std::vector<trace_clock::time_point>> running;
+
+    // Must be called with the lock held
+    std::size_t thread_index(std::thread::id id)
+    {
+        return threads.emplace(id, threads.size()).first->second;
+    }
+
+    void start()
+    {
+        auto now = trace_clock::now();
+        std::lock_guard<std::mutex> lock(m);
+        running[std::this_thread::get_id()].push_back(now);
+    }
+
+    void stop(std::string name, std::string category, value args)
+    {
+        auto now = trace_clock::now();
+        auto id  = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(m);
+        auto& starts = running[id];
+        if(starts.empty())
+            MIGRAPHX_THROW("chrome_trace: mark_stop without a matching mark_start");
+        auto start = starts.back();
+        starts.pop_back();
+        events.push_back(
+            {std::move(name), std::move(category), start, now, thread_index(id), std::move(args)});
+    }
+
+    void add(std::string name,
+             std::string category,
+             trace_clock::time_point start,
+             trace_clock::time_point stop,
+             value args)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        events.push_back({std::move(name),
+                          std::move(category),
+                          start,
+                          stop,
+                          thread_index(std::this_thread::get_id()),
+                          std::move(args)});
+    }
+
+    double microseconds(trace_clock::duration d) const
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+};
+
+chrome_trace::chrome_trace() : impl(std::make_shared<chrome_trace_impl>()) {}
+
+void chrome_trace::mark_start(instruction_ref) { impl->start(); }
+
+void chrome_trace::mark_stop(instruction_ref ins)
+{
+    const auto& s  = ins->get_shape();
+    auto inputs    = to_shapes(ins->inputs());
+    value args     = value::object{};
+    args["shape"]  = to_string(s);
+    args["inputs"] = shape::to_sizes_string(inputs);
+    // An instruction that aliases one of its inputs doesn't allocate its output
+    bool aliases  = ins->get_operator().output_alias(inputs) >= 0;
+    args["bytes"] = (s.dynamic() or aliases) ? 0 : s.bytes();
+    impl->stop(ins->name(), "instruction", args);
+}
+
+void chrome_trace::mark_start(const program&) { impl->start(); }
+
+void chrome_trace::mark_stop(const program&) { impl->stop("eval", "program", value::object{}); }
+
+tracer chrome_trace::get_tracer() const
+{
+    auto i = impl;
+    return tracer{[=](const std::string& pass,
+                      const std::string& mod,
+                      trace_clock::time_point start,
+                      trace_clock::time_point stop) {
+        value args = value::object{};
+        if(not mod.empty())
+            args["module"] = mod;
+        i->add(pass, "pass", start, stop, args);
+    }};
+}
+
+std::size_t chrome_trace::size() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    return impl->events.size();
+}
+
+value chrome_trace::to_value() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    value events = value::array{};
+    for(const auto& [id, tid] : impl->threads)
+    {
+        (void)id;
+        events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", 0},
+                          {"tid", tid},
+                          {"args", {{"name", "thread " + std::to_string(tid)}}}});
+    }
+    for(const auto& e : impl->events)
+    {
+        events.push_back({{"name", e.name},
+                          {"cat", e.category},
+                          {"ph", "X"},
+                          {"ts", impl->microseconds(e.start - impl->epoch)},
+                          {"dur", impl->microseconds(e.stop - e.start)},
+                          {"pid", 0},
+                          {"tid", e.tid},
+                          {"args", e.args}});
+    }
+    return {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+}
+
+void chrome_trace::write(std::ostream& os) const { os << to_json_string(to_value()); }
+
+void chrome_trace::save(const std::string& filename) const
+{
+    auto s = to_json_string(to_value());
+    write_buffer(filename, s.data(), s.size());
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -34,6 +34,7 @@
 #include "marker_roctx.hpp"
 
 #include <migraphx/tf.hpp>
+#include <migraphx/chrome_trace.hpp>
 #include <migraphx/onnx.hpp>
 #ifdef MIGRAPHX_ENABLE_PYTHON
 #include <migraphx/py.hpp>
@@ -104,6 +105,10 @@ struct loader
         ap(file_type, {"--tf"}, ap.help("Load as tensorflow"), ap.set_value("tf"));
         ap(file_type, {"--migraphx"}, ap.help("Load as MIGraphX"), ap.set_value("migraphx"));
         ap(file_type, {"--migraphx-json"}, ap.help("Load as MIGraphX JSON"), ap.set_value("json"));
+        ap(file_type,
+           {"--migraphx-mmap"},
+           ap.help("Load as memory-mapped MIGraphX"),
+           ap.set_value("mmap"));
         ap(batch,
            {"--batch"},
            ap.help("For a static model, sets default_dim_value size (commonly batch size). For a "
@@ -168,6 +173,10 @@ struct loader
            {"--binary"},
            ap.help("Print out program in binary format."),
            ap.set_value("binary"));
+        ap(output_type,
+           {"--mmap"},
+           ap.help("Print out program in binary format that can be loaded with memory mapping."),
+           ap.set_value("mmap"));
         ap(output_type,
            {"--netron"},
            ap.help("Print out program as Netron readable json."),
@@ -345,6 +354,12 @@ struct loader
                 options.format = "json";
                 p              = migraphx::load(file, options);
             }
+            else if(file_type == "mmap")
+            {
+                file_options options;
+                options.format = "mmap";
+                p              = migraphx::load(file, options);
+            }
 #ifdef MIGRAPHX_ENABLE_PYTHON
             else if(file_type == "py")
             {
@@ -424,6 +439,8 @@ struct loader
             *os << to_json_string(p.to_value()) << std::endl;
         else if(type == "binary")
             write(*os, save_buffer(p));
+        else if(type == "mmap")
+            write(*os, save_buffer(p, file_options{"mmap"}));
         else if(type == "netron")
             *os << make_netron_output(p) << std::endl;
     }
@@ -741,6 +758,7 @@ struct perf : command<perf>
     compiler c;
     unsigned n    = 100;
     bool detailed = false;
+    std::string trace_file;
     void parse(argument_parser& ap)
     {
         c.parse(ap);
@@ -749,16 +767,28 @@ struct perf : command<perf>
            {"--detailed", "-d"},
            ap.help("Show a more detailed summary report"),
            ap.set_value(true));
+        ap(trace_file,
+           {"--trace"},
+           ap.help("Write a Chrome trace of the passes and one run of the program to the file"));
     }
 
     void run()
     {
+        chrome_trace trace;
+        if(not trace_file.empty())
+            c.co.trace = trace.get_tracer();
         std::cout << "Compiling ... " << std::endl;
         auto p = c.compile();
         std::cout << "Allocating params ... " << std::endl;
         auto m = c.params(p);
         std::cout << "Running performance report ... " << std::endl;
         p.perf_report(std::cout, n, m, c.l.batch, detailed);
+        if(not trace_file.empty())
+        {
+            std::cout << "Writing trace to " << trace_file << " ... " << std::endl;
+            p.mark(m, trace);
+            trace.save(trace_file);
+        }
     }
 };
 
@@ -26,51 +26,105 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/ranges.hpp>
-#include <migraphx/functional.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/time.hpp>
+#include <migraphx/env.hpp>
 
-#include <unordered_set>
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-template <class Range>
-void cse_range(module& m, Range&& r)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_ELIMINATE_COMMON_SUBEXPRESSION)
+
+static bool is_commutative(instruction_ref ins)
 {
-    std::unordered_multimap<std::string, instruction_ref> instructions;
-    std::unordered_set<instruction_ref> processed_ins;
-    for(auto ins : r)
+    return ins->inputs().size() == 2 and
+           ins->get_operator().attributes().get("commutative", false);
+}
+
+static std::size_t hash_instruction(instruction_ref ins, bool commutative)
+{
+    std::size_t seed = hash_value(ins->get_operator().to_value());
+    hash_combine(seed, ins->name());
+    const auto& s = ins->get_shape();
+    hash_combine(seed, s.type());
+    for(auto len : s.lens())
+        hash_combine(seed, len);
+    // Inputs are compared by identity, since equivalent inputs have already been merged
+    std::vector<instruction*> inputs;
+    std::transform(ins->inputs().begin(),
+                   ins->inputs().end(),
+                   std::back_inserter(inputs),
+                   [](auto input) { return as_address(input); });
+    if(commutative)
+        std::sort(inputs.begin(), inputs.end());
+    for(auto* input : inputs)
+        hash_combine(seed, input);
+    for(auto* mod : ins->module_inputs())
+        hash_combine(seed, mod);
+    if(ins->name() == "@literal")
+    {
+        // Only hash the start of the data, the full literal is compared on a hash match
+        const auto& lit  = ins->get_literal();
+        std::size_t size = std::min<std::size_t>(lit.get_shape().bytes(), 256);
+        if(not lit.empty())
+            hash_combine(seed, std::string_view{lit.data(), size});
+    }
+    return seed;
+}
+
+static bool is_equivalent(instruction_ref x, instruction_ref y, bool commutative)
+{
+    if(*x == *y)
+        return true;
+    if(not commutative)
+        return false;
+    // Check if the inputs of a commutative operator are swapped
+    return x->inputs().front() == y->inputs().back() and
+           x->inputs().back() == y->inputs().front() and x->get_shape() == y->get_shape() and
+           x->module_inputs() == y->module_inputs() and
+           x->get_operator() == y->get_operator();
+}
+
+void eliminate_common_subexpression::apply(module& m) const
+{
+    timer t{};
+    std::size_t merged = 0;
+    // Value numbering table from the hash of an instruction to the instructions with that hash.
+    // Instructions are visited in order, so the inputs of an instruction have already been
+    // replaced by their representative and equivalent instructions have identical inputs.
+    std::unordered_multimap<std::size_t, instruction_ref> table;
+    for(auto ins : iterator_for(m))
     {
         // Skip dead instructions
         if(ins->outputs().empty())
             continue;
 
-        // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
-        for(const auto& pp : found_instructions)
+        const bool commutative = is_commutative(ins);
+        auto h                 = hash_instruction(ins, commutative);
+        auto candidates        = range(table.equal_range(h));
+        auto it = std::find_if(candidates.begin(), candidates.end(), [&](const auto& p) {
+            return is_equivalent(p.second, ins, commutative);
+        });
+        if(it != candidates.end())
         {
-            auto eq = pp.second;
-            if(contains(processed_ins, eq))
-                continue;
-            if(*eq != *ins)
-                continue;
-            m.replace_instruction(ins, eq);
-            processed_ins.emplace(ins);
-            std::vector<instruction_ref> outputs;
-            std::copy_if(eq->outputs().begin(),
-                         eq->outputs().end(),
-                         std::back_inserter(outputs),
-                         [&](auto x) { return m.has_instruction(x); });
-
-            std::sort(outputs.begin(), outputs.end(), [&](auto x, auto y) {
-                return std::distance(eq, x) < std::distance(eq, y);
-            });
-            cse_range(m, outputs);
+            m.replace_instruction(ins, it->second);
+            merged++;
+            continue;
         }
-        instructions.emplace(ins->name(), ins);
+        table.emplace(h, ins);
+    }
+    if(enabled(MIGRAPHX_TRACE_ELIMINATE_COMMON_SUBEXPRESSION{}))
+    {
+        std::cout << "eliminate_common_subexpression: merged " << merged << " of " << m.size()
+                  << " instructions in " << t.record<std::chrono::duration<double, std::milli>>()
+                  << "ms" << std::endl;
     }
 }
 
-void eliminate_common_subexpression::apply(module& m) const { cse_range(m, iterator_for(m)); }
-
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
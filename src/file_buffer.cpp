@@ -27,6 +27,17 @@
 #include <fstream>
 #include <iostream>
 
+#ifdef _WIN32
+// cppcheck-suppress definePrefix
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
@@ -81,5 +92,62 @@ void write_buffer(const fs::path& filename, const std::vector<char>& buffer)
     write_buffer(filename, buffer.data(), buffer.size());
 }
 
+#ifdef _WIN32
+mapped_buffer map_buffer(const fs::path& filename)
+{
+    HANDLE file = CreateFileW(filename.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        MIGRAPHX_THROW("Failure opening file: " + filename);
+    LARGE_INTEGER size;
+    if(GetFileSizeEx(file, &size) == 0 or size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        MIGRAPHX_THROW("Invalid size for: " + filename);
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if(mapping == nullptr)
+        MIGRAPHX_THROW("Failure mapping file: " + filename);
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if(ptr == nullptr)
+        MIGRAPHX_THROW("Failure mapping file: " + filename);
+    mapped_buffer result;
+    result.size = size.QuadPart;
+    result.data = {static_cast<const char*>(ptr), [](const char* p) { UnmapViewOfFile(p); }};
+    return result;
+}
+#else
+mapped_buffer map_buffer(const fs::path& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        MIGRAPHX_THROW("Failure opening file: " + filename);
+    struct stat st = {};
+    if(fstat(fd, &st) != 0 or st.st_size == 0)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Invalid size for: " + filename);
+    }
+    std::size_t size = st.st_size;
+    void* ptr        = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(ptr == MAP_FAILED) // NOLINT
+        MIGRAPHX_THROW("Failure mapping file: " + filename);
+    mapped_buffer result;
+    result.size = size;
+    result.data = {static_cast<const char*>(ptr), [size](const char* p) {
+                       munmap(const_cast<char*>(p), size); // NOLINT
+                   }};
+    return result;
+}
+#endif
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -0,0 +1,606 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_pointwise.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/fileutils.hpp>
+#include <migraphx/simple_par_for.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_HOST_POINTWISE_JIT)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_HOST_POINTWISE_JIT)
+
+namespace {
+
+// Number of elements evaluated at a time
+constexpr std::size_t tile_size = 1024;
+
+// Evaluates n elements, the pointers are the outputs followed by the inputs
+using pointwise_function = std::function<void(std::size_t n, char** ptrs)>;
+
+// The functions mirror the reference implementation of the operators so the compiled kernel
+// gives the same results as the interpreter
+// NOLINTNEXTLINE
+const std::string_view host_preamble = R"__migraphx__(
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+using std::make_tuple;
+
+namespace migraphx_host {
+
+using std::acos;
+using std::acosh;
+using std::asin;
+using std::asinh;
+using std::atan;
+using std::atanh;
+using std::ceil;
+using std::cos;
+using std::cosh;
+using std::erf;
+using std::exp;
+using std::floor;
+using std::fmod;
+using std::log;
+using std::log2;
+using std::max;
+using std::min;
+using std::pow;
+using std::sin;
+using std::sinh;
+using std::sqrt;
+using std::tan;
+using std::tanh;
+
+template <class T>
+typename std::conditional_t<std::is_integral<T>{}, std::make_signed<T>, std::enable_if<true, T>>::
+    type
+    make_signed(T x)
+{
+    return x;
+}
+
+template <class T>
+auto abs(T x)
+{
+    return std::abs(make_signed(x));
+}
+
+template <class T>
+auto rsqrt(T x)
+{
+    return 1 / std::sqrt(x);
+}
+
+template <class T, class U>
+auto mod(T x, U y)
+{
+    return std::fmod((std::remainder(x, y)) + y, y);
+}
+
+template <class T>
+bool isnan(T x)
+{
+    return std::isnan(static_cast<double>(x));
+}
+
+template <class T>
+bool isinf(T x)
+{
+    return std::isinf(static_cast<double>(x));
+}
+
+template <class T, class U>
+U convert(U x)
+{
+    using limits = std::numeric_limits<T>;
+    auto y       = x;
+    if(std::isnan(static_cast<double>(x)))
+    {
+        y = limits::quiet_NaN();
+    }
+    else if constexpr(std::is_integral<T>{} and std::is_floating_point<U>{})
+    {
+        y = T(std::min(std::max(static_cast<double>(x), static_cast<double>(limits::lowest())),
+                       static_cast<double>(limits::max())));
+    }
+    else
+    {
+        y = std::min(std::max(T(x), limits::lowest()), limits::max());
+    }
+    return y;
+}
+
+} // namespace migraphx_host
+
+)__migraphx__";
+
+// Operators that have a point_op matching their reference implementation
+const std::unordered_set<std::string>& jit_ops()
+{
+    static const std::unordered_set<std::string> ops = {
+        "abs",     "acos",  "acosh",   "add",     "asin",        "asinh",      "atan",
+        "atanh",   "ceil",  "clip",    "convert", "cos",         "cosh",       "div",
+        "equal",   "erf",   "exp",     "floor",   "fmod",        "greater",    "isinf",
+        "isnan",   "less",  "log",     "log2",    "logical_and", "logical_or", "max",
+        "min",     "mod",   "mul",     "neg",     "not",         "pow",        "prelu",
+        "recip",   "relu",  "rsqrt",   "sigmoid", "sign",        "sin",        "sinh",
+        "sqdiff",  "sqrt",  "sub",     "tan",     "tanh",        "where"};
+    return ops;
+}
+
+bool is_jit_type(shape::type_t t)
+{
+    switch(t)
+    {
+    case shape::bool_type:
+    case shape::float_type:
+    case shape::double_type:
+    case shape::uint8_type:
+    case shape::int8_type:
+    case shape::uint16_type:
+    case shape::int16_type:
+    case shape::int32_type:
+    case shape::int64_type:
+    case shape::uint32_type:
+    case shape::uint64_type: return true;
+    default: return false;
+    }
+}
+
+std::vector<std::string> sorted_parameter_names(const module& m)
+{
+    auto pnames = m.get_parameter_names();
+    std::sort(pnames.begin(), pnames.end());
+    return pnames;
+}
+
+bool can_jit(const module& m)
+{
+    return std::all_of(m.begin(), m.end(), [](const instruction& ins) {
+        if(ins.name() == "@return")
+            return true;
+        if(not is_jit_type(ins.get_shape().type()))
+            return false;
+        if(ins.name() == "@param" or ins.name() == "@literal")
+            return true;
+        return contains(jit_ops(), ins.name());
+    });
+}
+
+std::string generate_kernel(const module& m)
+{
+    auto pnames        = sorted_parameter_names(m);
+    auto pshapes       = m.get_parameter_shapes();
+    auto output_shapes = m.get_output_shapes();
+
+    cpp_generator g;
+    g.fmap([](const std::string& name) { return "migraphx_host::" + name; });
+    // Store every intermediate result in its type like the reference implementation
+    g.fresult([](const shape& s) { return shape::cpp_type(s.type()); });
+    auto f = g.generate_module(m);
+    f.set_name("pointwise_op").set_attributes({"static inline"});
+    if(output_shapes.size() > 1)
+        f.return_type = "auto";
+    g.create_function(f);
+
+    std::vector<std::string> args;
+    std::stringstream ss;
+    ss << "extern \"C\" EXPORT void migraphx_pointwise_kernel(std::size_t n, char** ptrs)\n{\n";
+    for(auto k : range(output_shapes.size()))
+    {
+        ss << "    auto* y" << k << " = reinterpret_cast<"
+           << shape::cpp_type(output_shapes[k].type()) << "*>(ptrs[" << k << "]);\n";
+    }
+    for(auto j : range(pnames.size()))
+    {
+        ss << "    auto* x" << j << " = reinterpret_cast<const "
+           << shape::cpp_type(pshapes.at(pnames[j]).type()) << "*>(ptrs["
+           << output_shapes.size() + j << "]);\n";
+        args.push_back("x" + std::to_string(j) + "[i]");
+    }
+    ss << "    for(std::size_t i = 0; i < n; i++)\n    {\n";
+    ss << "        auto r = pointwise_op(" << join_strings(args, ", ") << ");\n";
+    if(output_shapes.size() == 1)
+    {
+        ss << "        y0[i] = r;\n";
+    }
+    else
+    {
+        for(auto k : range(output_shapes.size()))
+            ss << "        y" << k << "[i] = std::get<" << k << ">(r);\n";
+    }
+    ss << "    }\n}\n";
+    return std::string{host_preamble} + g.str() + ss.str();
+}
+
+pointwise_function compile_kernel(const module& m)
+{
+    auto src = generate_kernel(m);
+    if(enabled(MIGRAPHX_TRACE_HOST_POINTWISE_JIT{}))
+        std::cout << src << std::endl;
+    src_compiler compiler;
+    compiler.flags = {
+        "-std=c++17", "-O3", "-ffp-contract=off", "-fno-math-errno", "-shared", "-w"};
+#ifndef _WIN32
+    compiler.flags.emplace_back("-fPIC");
+    compiler.flags.emplace_back("-march=native");
+    compiler.flags.emplace_back("-DEXPORT=\"\"");
+#else
+    compiler.flags.emplace_back("-DEXPORT=__declspec(dllexport)");
+#endif
+    compiler.output = make_shared_object_filename("pointwise");
+    auto image      = compiler.compile({src_file{"pointwise.cpp", src}});
+    return dynamic_loader{image}.get_function<void(std::size_t, char**)>(
+        "migraphx_pointwise_kernel");
+}
+
+struct pointwise_step
+{
+    operation op                    = {};
+    literal lit                     = {};
+    std::vector<std::size_t> inputs = {};
+};
+
+// Evaluates each instruction of the module over a tile of elements. The instructions are
+// flattened into steps that refer to their inputs by slot index.
+struct pointwise_interpreter
+{
+    std::vector<shape::type_t> param_types;
+    std::vector<pointwise_step> steps;
+    std::vector<std::size_t> outputs;
+
+    explicit pointwise_interpreter(const module& m)
+    {
+        std::unordered_map<instruction_ref, std::size_t> slots;
+        auto pnames = sorted_parameter_names(m);
+        for(const auto& pname : pnames)
+        {
+            auto ins   = m.get_parameter(pname);
+            slots[ins] = param_types.size();
+            param_types.push_back(ins->get_shape().type());
+        }
+        for(auto ins : iterator_for(m))
+        {
+            if(ins->name() == "@param")
+                continue;
+            if(ins->name() == "@return")
+            {
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(outputs),
+                               [&](auto input) { return slots.at(input); });
+                continue;
+            }
+            pointwise_step step;
+            if(ins->name() == "@literal")
+            {
+                step.lit = ins->get_literal();
+                if(step.lit.get_shape().elements() != 1)
+                    MIGRAPHX_THROW("Literals in pointwise modules must have a single element");
+            }
+            else
+            {
+                if(not ins->module_inputs().empty())
+                    MIGRAPHX_THROW("Unsupported module input in pointwise module: " +
+                                   ins->name());
+                step.op = ins->get_operator();
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(step.inputs),
+                               [&](auto input) { return slots.at(input); });
+            }
+            slots[ins] = param_types.size() + steps.size();
+            steps.push_back(std::move(step));
+        }
+        if(outputs.empty())
+            outputs.push_back(slots.at(std::prev(m.end())));
+    }
+
+    void operator()(std::size_t n, char** ptrs) const
+    {
+        std::vector<argument> slots;
+        slots.reserve(param_types.size() + steps.size());
+        for(auto j : range(param_types.size()))
+            slots.emplace_back(shape{param_types[j], {n}}, ptrs[outputs.size() + j]);
+        for(const auto& step : steps)
+        {
+            if(step.inputs.empty() and not step.lit.empty())
+            {
+                // Broadcast the literal over the tile
+                slots.emplace_back(shape{step.lit.get_shape().type(), {n}, {0}},
+                                   const_cast<char*>(step.lit.data())); // NOLINT
+                continue;
+            }
+            std::vector<argument> inputs;
+            std::transform(step.inputs.begin(),
+                           step.inputs.end(),
+                           std::back_inserter(inputs),
+                           [&](auto i) { return slots[i]; });
+            auto s = step.op.compute_shape(to_shapes(inputs));
+            slots.push_back(step.op.compute(s, inputs));
+        }
+        for(auto k : range(outputs.size()))
+        {
+            slots[outputs[k]].visit([&](auto r) {
+                using type = typename decltype(r)::value_type;
+                std::copy(r.begin(), r.end(), reinterpret_cast<type*>(ptrs[k]));
+            });
+        }
+    }
+};
+
+// Key a module by its instructions so identical modules share the same kernel
+std::string module_key(const module& m, bool jit)
+{
+    std::stringstream ss;
+    ss << jit << ";";
+    std::unordered_map<instruction_ref, std::size_t> ids;
+    for(auto ins : iterator_for(m))
+    {
+        ids[ins] = ids.size();
+        ss << ins->get_operator() << ":" << ins->get_shape();
+        if(ins->name() == "@literal")
+        {
+            const auto& l = ins->get_literal();
+            ss << "[" << std::string(l.data(), l.get_shape().bytes()) << "]";
+        }
+        for(auto input : ins->inputs())
+            ss << "," << ids.at(input);
+        ss << ";";
+    }
+    return ss.str();
+}
+
+pointwise_function make_pointwise_function(const module& m, bool jit)
+{
+    if(jit and can_jit(m))
+    {
+        try
+        {
+            return compile_kernel(m);
+        }
+        catch(const std::exception& e)
+        {
+            if(enabled(MIGRAPHX_TRACE_HOST_POINTWISE_JIT{}))
+                std::cout << "Falling back to the pointwise interpreter: " << e.what()
+                          << std::endl;
+        }
+    }
+    auto interpreter = std::make_shared<pointwise_interpreter>(m);
+    return [=](std::size_t n, char** ptrs) { (*interpreter)(n, ptrs); };
+}
+
+// Kernels are shared by identical modules. Programs rarely have more than a few distinct
+// pointwise modules, so only the most recently used ones are kept.
+struct pointwise_function_cache
+{
+    static constexpr std::size_t max_size = 256;
+
+    using entry = std::pair<std::string, pointwise_function>;
+
+    pointwise_function find(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if(it == index.end())
+            return nullptr;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+
+    pointwise_function insert(const std::string& key, pointwise_function f)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if(it != index.end())
+            return it->second->second;
+        entries.emplace_front(key, std::move(f));
+        index.emplace(key, entries.begin());
+        if(entries.size() > max_size)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        return entries.front().second;
+    }
+
+    private:
+    std::mutex mutex;
+    std::list<entry> entries;
+    std::unordered_map<std::string, std::list<entry>::iterator> index;
+};
+
+pointwise_function get_pointwise_function(const module& m, bool jit)
+{
+    static pointwise_function_cache cache;
+    auto key = module_key(m, jit);
+    auto f   = cache.find(key);
+    if(f)
+        return f;
+    // Compile outside of the lock so other modules are not blocked
+    return cache.insert(key, make_pointwise_function(m, jit));
+}
+
+struct tile_tensor
+{
+    char* data            = nullptr;
+    shape s               = {};
+    std::size_t type_size = 0;
+    // Element i is stored at offset i
+    bool direct = false;
+    // A single broadcasted value
+    bool scalar = false;
+};
+
+} // namespace
+
+host_pointwise::host_pointwise(const module& m, bool jit)
+    : f(get_pointwise_function(m, jit and not enabled(MIGRAPHX_DISABLE_HOST_POINTWISE_JIT{})))
+{
+}
+
+bool host_pointwise::is_supported(const module& m)
+{
+    return std::all_of(m.begin(), m.end(), [](const instruction& ins) {
+        if(starts_with(ins.name(), "@"))
+            return true;
+        return ins.module_inputs().empty() and is_context_free(ins.get_operator());
+    });
+}
+
+argument host_pointwise::compute(const shape& output_shape,
+                                 const std::vector<argument>& args) const
+{
+    if(not f)
+        MIGRAPHX_THROW("host_pointwise: module has not been prepared");
+    argument output{output_shape};
+    auto outputs = output_shape.type() == shape::tuple_type ? output.share().get_sub_objects()
+                                                            : std::vector<argument>{output.share()};
+    auto n = args.front().get_shape().elements();
+    if(n == 0)
+        return output;
+
+    std::vector<argument> all_args = outputs;
+    all_args.insert(all_args.end(), args.begin(), args.end());
+    const auto& first = all_args.front().get_shape();
+    // When everything has the same packed layout the elements can be visited in memory order
+    bool same_layout = std::all_of(all_args.begin(), all_args.end(), [&](const auto& a) {
+        const auto& s = a.get_shape();
+        return s.packed() and s.lens() == first.lens() and s.strides() == first.strides();
+    });
+    std::vector<tile_tensor> tensors;
+    std::transform(all_args.begin(), all_args.end(), std::back_inserter(tensors), [&](auto& a) {
+        tile_tensor t;
+        t.data      = a.data();
+        t.s         = a.get_shape();
+        t.type_size = t.s.type_size();
+        t.direct    = same_layout or t.s.standard();
+        t.scalar    = not t.direct and t.s.element_space() == 1;
+        return t;
+    });
+
+    std::size_t tile_bytes = 0;
+    for(const auto& t : tensors)
+        tile_bytes = std::max(tile_bytes, tile_size * t.type_size);
+    // Broadcasted scalars are filled once and shared by all tiles
+    std::vector<std::vector<char>> broadcasts(tensors.size());
+    for(auto j : range(outputs.size(), tensors.size()))
+    {
+        const auto& t = tensors[j];
+        if(not t.scalar)
+            continue;
+        broadcasts[j].resize(tile_size * t.type_size);
+        for(std::size_t k = 0; k < tile_size; k++)
+            std::memcpy(broadcasts[j].data() + k * t.type_size, t.data, t.type_size);
+    }
+
+    std::vector<std::vector<char>> buffers(get_num_threads());
+    auto ntiles = (n + tile_size - 1) / tile_size;
+    simple_par_for(ntiles, 1, [&](std::size_t tile, std::size_t tid) {
+        auto start  = tile * tile_size;
+        auto len    = std::min(tile_size, n - start);
+        auto& local = buffers[tid];
+        if(local.empty())
+            local.resize(tensors.size() * tile_bytes);
+        std::vector<char*> ptrs(tensors.size());
+        for(auto j : range(tensors.size()))
+        {
+            const auto& t = tensors[j];
+            if(t.direct)
+            {
+                ptrs[j] = t.data + start * t.type_size;
+            }
+            else if(t.scalar)
+            {
+                ptrs[j] = broadcasts[j].data();
+            }
+            else
+            {
+                ptrs[j] = local.data() + j * tile_bytes;
+                if(j < outputs.size())
+                    continue;
+                for(std::size_t k = 0; k < len; k++)
+                    std::memcpy(ptrs[j] + k * t.type_size,
+                                t.data + t.s.index(start + k) * t.type_size,
+                                t.type_size);
+            }
+        }
+        f(len, ptrs.data());
+        for(auto j : range(outputs.size()))
+        {
+            const auto& t = tensors[j];
+            if(t.direct)
+                continue;
+            for(std::size_t k = 0; k < len; k++)
+                std::memcpy(t.data + t.s.index(start + k) * t.type_size,
+                            ptrs[j] + k * t.type_size,
+                            t.type_size);
+        }
+    });
+    return output;
+}
+
+const host_pointwise& lazy_host_pointwise::get(const module& m)
+{
+    std::call_once(flag, [&] { prepared = host_pointwise{m}; });
+    return prepared;
+}
+
+argument compute_host_pointwise(const module& m,
+                                const shape& output_shape,
+                                const std::vector<argument>& args,
+                                bool jit)
+{
+    return host_pointwise{m, jit}.compute(output_shape, args);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -69,6 +69,15 @@ struct MIGRAPHX_EXPORT argument : raw_data<argument>
         assign_buffer([d] { return reinterpret_cast<char*>(d.get()); });
     }
 
+    /// Shares a buffer that must not be written to, such as the data of a literal
+    template <class T>
+    argument(shape s, std::shared_ptr<const T> d)
+        : m_shape(std::move(s))
+    {
+        assign_buffer([d] { return reinterpret_cast<char*>(const_cast<T*>(d.get())); });
+        m_data.set_read_only();
+    }
+
     argument(shape s, std::nullptr_t);
     
     argument(const std::vector<argument>& args);
@@ -83,8 +92,17 @@ struct MIGRAPHX_EXPORT argument : raw_data<argument>
 
     argument reshape(const shape& s) const;
 
+    /// Views the data starting offset bytes into the buffer with a new shape
+    argument view(const shape& s, std::size_t offset) const;
+
     argument copy() const;
 
+    /// Whether the data is shared with a buffer that must not be written to
+    bool is_read_only() const;
+
+    /// Returns the argument itself, or a copy of it when the data is read-only
+    argument writable() const;
+
     /// Make copy of the argument that is always sharing the data
     argument share() const;
 
@@ -109,7 +127,10 @@ struct MIGRAPHX_EXPORT argument : raw_data<argument>
     {
         std::function<char*()> get = nullptr;
         std::vector<data_t> sub = {};
+        bool read_only = false;
         data_t share() const;
+        void set_read_only();
+        bool any_read_only() const;
         static data_t from_args(const std::vector<argument>& args);
     };
     argument(const shape& s, const data_t& d);
@@ -0,0 +1,115 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_CALIBRATION_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_CALIBRATION_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/optional.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+enum class calibration_method
+{
+    max,
+    percentile,
+    entropy
+};
+
+MIGRAPHX_EXPORT std::string to_string(calibration_method method);
+
+struct calibration_options
+{
+    calibration_method method = calibration_method::max;
+    /// Percentage of the values that are kept in range by the percentile method
+    double percentile = 99.99;
+    /// Number of histogram bins used by the percentile and entropy methods
+    std::size_t bins = 2048;
+    /// File the calibrated ranges are saved to. When it already holds ranges computed for the
+    /// same program with the same options they are reused and calibration is skipped.
+    std::string cache_file = "";
+    /// Number of calibration batches that are run at the same time, each in its own session of
+    /// the program. With 0 the host targets (ref and cpu) run one batch per thread, and the
+    /// other targets run one batch at a time, since the sessions would share the device.
+    std::size_t concurrency = 0;
+};
+
+/**
+ * @brief Histogram of the absolute values seen by one captured tensor
+ *
+ * Arguments are read in place. The range of the bins starts at the largest value of the first
+ * argument and is doubled, by merging neighbouring bins, whenever a larger value is added. With
+ * no bins only the largest absolute value is tracked.
+ */
+struct MIGRAPHX_EXPORT calibration_histogram
+{
+    calibration_histogram() = default;
+    explicit calibration_histogram(std::size_t nbins);
+
+    void add(const argument& arg);
+
+    /// Returns true when no argument has been added
+    bool empty() const;
+
+    float max_abs() const;
+
+    /// Returns the absolute value that is mapped to the end of a quantized range with `levels`
+    /// positive steps
+    float get_threshold(const calibration_options& options, std::size_t levels) const;
+
+    const std::vector<std::size_t>& get_bins() const;
+
+    float bin_width() const;
+
+    private:
+    void grow(float x);
+    float percentile_threshold(double p) const;
+    float entropy_threshold(std::size_t levels) const;
+
+    std::vector<std::size_t> bins;
+    float width       = 0;
+    float max_val     = 0;
+    std::size_t count = 0;
+};
+
+/// Returns the ranges stored in a calibration cache file when they were computed with the same
+/// options for the program with the same fingerprint, and there are n of them
+MIGRAPHX_EXPORT optional<std::vector<float>> load_calibration(const fs::path& file,
+                                                              const calibration_options& options,
+                                                              const std::string& fingerprint,
+                                                              std::size_t n);
+
+MIGRAPHX_EXPORT void save_calibration(const fs::path& file,
+                                      const calibration_options& options,
+                                      const std::string& fingerprint,
+                                      const std::vector<float>& thresholds);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHLIB_CALIBRATION_HPP
@@ -0,0 +1,77 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_CHROME_TRACE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_CHROME_TRACE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/tracer.hpp>
+#include <migraphx/value.hpp>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct program;
+struct chrome_trace_impl;
+
+/**
+ * Records a timeline of the instructions evaluated and the passes run while compiling, in the
+ * Chrome trace event format that chrome://tracing and Perfetto load.
+ *
+ * It implements the marker interface, so the instructions are recorded by passing it to
+ * `program::mark`, and the passes are recorded through the tracer returned by `get_tracer`.
+ * Copies share the same events.
+ */
+struct MIGRAPHX_EXPORT chrome_trace
+{
+    chrome_trace();
+
+    void mark_start(instruction_ref ins);
+    void mark_stop(instruction_ref ins);
+    void mark_start(const program& p);
+    void mark_stop(const program& p);
+
+    /// A tracer for `compile_options` that records the time of each pass
+    tracer get_tracer() const;
+
+    /// Number of events recorded
+    std::size_t size() const;
+
+    /// The events as a trace event object with a `traceEvents` array
+    value to_value() const;
+
+    void write(std::ostream& os) const;
+    void save(const std::string& filename) const;
+
+    private:
+    std::shared_ptr<chrome_trace_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_CHROME_TRACE_HPP
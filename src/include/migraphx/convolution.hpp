@@ -25,78 +25,494 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONVOLUTION_HPP
 
 #include <migraphx/config.hpp>
-#include <migraphx/dfor.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/gemm.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <ostream>
 #include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-template <class Output, class T, class Padding, class Stride, class Dilation>
-void convolution(
-    Output output, T input, T weights, Padding padding, Stride stride, Dilation dilation, int group)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DETERMINISTIC_CONVOLUTION)
+
+enum class convolution_algorithm
 {
-    auto output_shape = output.get_shape();
-    auto in_lens      = input.get_shape().lens();
+    direct,
+    im2col,
+    winograd_2x3,
+    winograd_4x3
+};
 
-    auto wei_lens = weights.get_shape().lens();
-    auto wei_n    = wei_lens[0];
-    auto wei_c    = wei_lens[1];
-    std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+inline std::ostream& operator<<(std::ostream& os, convolution_algorithm algo)
+{
+    switch(algo)
+    {
+    case convolution_algorithm::direct: return os << "direct";
+    case convolution_algorithm::im2col: return os << "im2col";
+    case convolution_algorithm::winograd_2x3: return os << "winograd_2x3";
+    case convolution_algorithm::winograd_4x3: return os << "winograd_4x3";
+    }
+    return os;
+}
 
-    par_for(output_shape.elements(), [&](auto i) {
-        auto idx_o = output_shape.multi(i);
-        auto w     = idx_o[1];
-        auto n_dim = idx_o.size();
+namespace detail {
 
-        std::vector<std::ptrdiff_t> win_start;
-        for(std::size_t dim = 2; dim < n_dim; ++dim)
+// Precomputed offsets for one convolution. The window is walked in the same order as the
+// weights are stored (channel first, then the kernel dimensions), and the input offsets of each
+// window element are relative to the start of the window so they can be reused for every output.
+struct convolution_geometry
+{
+    std::size_t kdims      = 0;
+    std::size_t batch      = 0;
+    std::size_t in_c       = 0;
+    std::size_t out_c      = 0;
+    std::size_t wei_c      = 0;
+    std::size_t group_size = 0;
+    std::size_t out_plane  = 0;
+    std::vector<std::ptrdiff_t> in_lens;
+    std::vector<std::ptrdiff_t> in_strides;
+    std::vector<std::size_t> out_lens;
+    std::vector<std::ptrdiff_t> win_start;
+    std::vector<std::ptrdiff_t> win_step;
+    std::vector<std::ptrdiff_t> win_extent;
+    // Spatial position of every window element relative to the window start
+    std::vector<std::ptrdiff_t> win_pos;
+    std::vector<std::ptrdiff_t> in_offsets;
+    std::vector<std::size_t> wei_offsets;
+
+    template <class Padding, class Stride, class Dilation>
+    convolution_geometry(const shape& output_shape,
+                         const shape& input_shape,
+                         const shape& weights_shape,
+                         const Padding& padding,
+                         const Stride& stride,
+                         const Dilation& dilation,
+                         int group)
+    {
+        const auto& wei_lens = weights_shape.lens();
+        kdims                = wei_lens.size() - 2;
+        batch                = input_shape.lens()[0];
+        in_c                 = input_shape.lens()[1];
+        out_c                = wei_lens[0];
+        wei_c                = wei_lens[1];
+        group_size           = out_c / group;
+        in_lens.assign(input_shape.lens().begin(), input_shape.lens().end());
+        in_strides.assign(input_shape.strides().begin(), input_shape.strides().end());
+        out_lens.assign(output_shape.lens().begin() + 2, output_shape.lens().end());
+        out_plane = std::accumulate(
+            out_lens.begin(), out_lens.end(), std::size_t{1}, std::multiplies<>{});
+        for(std::size_t d = 0; d < kdims; d++)
         {
-            auto d_2 = dim - 2;
-            win_start.push_back(std::ptrdiff_t(idx_o[dim] * stride[d_2]) -
-                                std::ptrdiff_t(padding[d_2]));
+            win_start.push_back(-std::ptrdiff_t(padding[d]));
+            win_step.push_back(stride[d]);
+            win_extent.push_back(std::ptrdiff_t(dilation[d]) *
+                                 (std::ptrdiff_t(wei_lens[d + 2]) - 1));
         }
-        const auto group_id = w / (wei_n / group);
-
-        shape win_shape{output_shape.type(), win_size};
-
-        double acc = 0.0;
-        shape_for_each(win_shape, [&](const auto& idx_win) {
-            auto k           = idx_win[0];
-            const auto in_ch = group_id * wei_c + k;
-            std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-            idx[1] = in_ch;
-            std::vector<std::ptrdiff_t> idx_dil(idx_win.size() - 1);
-            std::transform(idx_win.cbegin() + 1,
-                           idx_win.cend(),
-                           dilation.cbegin(),
-                           idx_dil.begin(),
-                           [](std::ptrdiff_t ii, std::ptrdiff_t d) { return d * ii; });
-            std::transform(idx_dil.begin(),
-                           idx_dil.end(),
-                           win_start.begin(),
-                           idx.begin() + 2,
-                           [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-            std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-            idx_wei[0] = w;
-            std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
-            if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-               std::equal(idx.begin(),
-                          idx.end(),
-                          in_lens.begin(),
-                          in_lens.end(),
-                          std::less<std::ptrdiff_t>{}))
+
+        std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+        const auto& wei_strides = weights_shape.strides();
+        shape_for_each(shape{shape::float_type, win_size}, [&](const auto& idx_win) {
+            std::size_t wei_offset   = idx_win[0] * wei_strides[1];
+            std::ptrdiff_t in_offset = idx_win[0] * in_strides[1];
+            for(std::size_t d = 0; d < kdims; d++)
             {
-                acc += input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
+                auto pos = std::ptrdiff_t(dilation[d] * idx_win[d + 1]);
+                win_pos.push_back(pos);
+                wei_offset += idx_win[d + 1] * wei_strides[d + 2];
+                in_offset += pos * in_strides[d + 2];
             }
+            wei_offsets.push_back(wei_offset);
+            in_offsets.push_back(in_offset);
         });
+    }
+
+    std::size_t window_size() const { return wei_offsets.size(); }
+
+    // Calls f(start, interior) for every output position of a plane in order, where start is the
+    // input position of the window and interior is true when the window does not touch padding
+    template <class F>
+    void for_each_window(F f) const
+    {
+        std::vector<std::size_t> idx(kdims, 0);
+        std::vector<std::ptrdiff_t> start(win_start);
+        for(std::size_t i = 0; i < out_plane; i++)
+        {
+            bool interior = true;
+            for(std::size_t d = 0; d < kdims; d++)
+            {
+                if(start[d] < 0 or start[d] + win_extent[d] >= in_lens[d + 2])
+                    interior = false;
+            }
+            f(i, start, interior);
+            for(std::size_t d = kdims; d > 0; d--)
+            {
+                if(++idx[d - 1] < out_lens[d - 1])
+                {
+                    start[d - 1] += win_step[d - 1];
+                    break;
+                }
+                idx[d - 1]   = 0;
+                start[d - 1] = win_start[d - 1];
+            }
+        }
+    }
+
+    std::ptrdiff_t start_offset(const std::vector<std::ptrdiff_t>& start) const
+    {
+        std::ptrdiff_t result = 0;
+        for(std::size_t d = 0; d < kdims; d++)
+            result += start[d] * in_strides[d + 2];
+        return result;
+    }
+
+    bool in_bounds(const std::vector<std::ptrdiff_t>& start, std::size_t e) const
+    {
+        for(std::size_t d = 0; d < kdims; d++)
+        {
+            auto pos = start[d] + win_pos[e * kdims + d];
+            if(pos < 0 or pos >= in_lens[d + 2])
+                return false;
+        }
+        return true;
+    }
+};
 
-        output[i] = acc;
+template <std::size_t M>
+struct winograd_matrices;
+
+// F(2x2, 3x3)
+template <>
+struct winograd_matrices<2>
+{
+    static constexpr std::size_t alpha = 4;
+    static constexpr double bt[4][4]   = {
+        {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+    static constexpr double g[4][3]  = {{1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+    static constexpr double at[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+// F(4x4, 3x3)
+template <>
+struct winograd_matrices<4>
+{
+    static constexpr std::size_t alpha = 6;
+    static constexpr double bt[6][6]   = {{4, 0, -5, 0, 1, 0},
+                                          {0, -4, -4, 1, 1, 0},
+                                          {0, 4, -4, -1, 1, 0},
+                                          {0, -2, -1, 2, 1, 0},
+                                          {0, 2, -1, -2, 1, 0},
+                                          {0, 4, 0, -5, 0, 1}};
+    static constexpr double g[6][3]    = {{1.0 / 4, 0, 0},
+                                          {-1.0 / 6, -1.0 / 6, -1.0 / 6},
+                                          {-1.0 / 6, 1.0 / 6, -1.0 / 6},
+                                          {1.0 / 24, 1.0 / 12, 1.0 / 6},
+                                          {1.0 / 24, -1.0 / 12, 1.0 / 6},
+                                          {0, 0, 1}};
+    static constexpr double at[4][6]   = {{1, 1, 1, 1, 1, 0},
+                                          {0, 1, -1, 2, -2, 0},
+                                          {0, 1, 1, 4, 4, 0},
+                                          {0, 1, -1, 8, -8, 1}};
+};
+
+// Computes y = l * x * transpose(l) for an R x C matrix l and a row-major C x C matrix x
+template <std::size_t R, std::size_t C>
+void winograd_transform(const double (&l)[R][C], const double* x, double* y)
+{
+    double t[R][C];
+    for(std::size_t i = 0; i < R; i++)
+    {
+        for(std::size_t j = 0; j < C; j++)
+        {
+            double acc = 0;
+            for(std::size_t k = 0; k < C; k++)
+                acc += l[i][k] * x[k * C + j];
+            t[i][j] = acc;
+        }
+    }
+    for(std::size_t i = 0; i < R; i++)
+    {
+        for(std::size_t j = 0; j < R; j++)
+        {
+            double acc = 0;
+            for(std::size_t k = 0; k < C; k++)
+                acc += t[i][k] * l[j][k];
+            y[i * R + j] = acc;
+        }
+    }
+}
+
+} // namespace detail
+
+// Direct convolution. Every output is accumulated in double over the window in the same order
+// as the weights are laid out, so the result does not depend on the number of threads.
+template <class Output, class T, class Padding, class Stride, class Dilation>
+void convolution_direct(Output output,
+                        T input,
+                        T weights,
+                        const Padding& padding,
+                        const Stride& stride,
+                        const Dilation& dilation,
+                        int group)
+{
+    const auto& output_shape = output.get_shape();
+    detail::convolution_geometry geo{
+        output_shape, input.get_shape(), weights.get_shape(), padding, stride, dilation, group};
+    const auto& in_strides  = input.get_shape().strides();
+    const auto& wei_strides = weights.get_shape().strides();
+    auto nwin               = geo.window_size();
+    auto* in_data           = input.data();
+    auto* wei_data          = weights.data();
+
+    par_for(geo.batch * geo.out_c, [&](auto p) {
+        auto n        = p / geo.out_c;
+        auto w        = p % geo.out_c;
+        auto group_id = w / geo.group_size;
+        std::ptrdiff_t in_base = n * in_strides[0] + group_id * geo.wei_c * in_strides[1];
+        const auto* wei = wei_data + w * wei_strides[0];
+        geo.for_each_window([&](std::size_t i, const auto& start, bool interior) {
+            const auto* in = in_data + in_base + geo.start_offset(start);
+            double acc     = 0.0;
+            if(interior)
+            {
+                for(std::size_t e = 0; e < nwin; e++)
+                    acc += in[geo.in_offsets[e]] * wei[geo.wei_offsets[e]];
+            }
+            else
+            {
+                for(std::size_t e = 0; e < nwin; e++)
+                {
+                    if(geo.in_bounds(start, e))
+                        acc += in[geo.in_offsets[e]] * wei[geo.wei_offsets[e]];
+                }
+            }
+            output[p * geo.out_plane + i] = acc;
+        });
+    });
+}
+
+// Lowers each group of every batch to a gemm of the packed weights [out_c / group, K] with the
+// unfolded input [K, outputs], where K is the window size. The output must be standard.
+template <class Output, class T, class Padding, class Stride, class Dilation>
+void convolution_im2col(Output output,
+                        T input,
+                        T weights,
+                        const Padding& padding,
+                        const Stride& stride,
+                        const Dilation& dilation,
+                        int group)
+{
+    using type     = typename T::value_type;
+    using out_type = typename Output::value_type;
+    const auto& output_shape = output.get_shape();
+    detail::convolution_geometry geo{
+        output_shape, input.get_shape(), weights.get_shape(), padding, stride, dilation, group};
+    const auto& in_strides  = input.get_shape().strides();
+    const auto& wei_strides = weights.get_shape().strides();
+    auto k                  = geo.window_size();
+    auto m                  = geo.group_size;
+    auto p                  = geo.out_plane;
+    auto* in_data           = input.data();
+    auto* wei_data          = weights.data();
+
+    std::vector<type> wmat(geo.out_c * k);
+    par_for(geo.out_c, [&](auto w) {
+        std::transform(geo.wei_offsets.begin(),
+                       geo.wei_offsets.end(),
+                       wmat.begin() + w * k,
+                       [&](auto off) { return wei_data[w * wei_strides[0] + off]; });
+    });
+
+    std::vector<type> col(k * p);
+    shape a_shape{shape::get_type<type>{}, {m, k}};
+    shape b_shape{shape::get_type<type>{}, {k, p}};
+    shape c_shape{shape::get_type<out_type>{}, {m, p}};
+    for(std::size_t n = 0; n < geo.batch; n++)
+    {
+        for(std::size_t g = 0; g < std::size_t(group); g++)
+        {
+            const auto* in = in_data + n * in_strides[0] + g * geo.wei_c * in_strides[1];
+            par_for(k, [&](auto e) {
+                auto* row = col.data() + e * p;
+                geo.for_each_window([&](std::size_t i, const auto& start, bool interior) {
+                    if(interior or geo.in_bounds(start, e))
+                        row[i] = in[geo.start_offset(start) + geo.in_offsets[e]];
+                    else
+                        row[i] = type(0);
+                });
+            });
+            auto* out = output.data() + (n * geo.out_c + g * m) * p;
+            std::fill(out, out + m * p, out_type(0));
+            gemm(tensor_view<out_type>{c_shape, out},
+                 tensor_view<type>{a_shape, wmat.data() + g * m * k},
+                 tensor_view<type>{b_shape, col.data()},
+                 1.0f,
+                 0.0f);
+        }
+    }
+}
+
+// Winograd F(MxM, 3x3) for 2D convolutions with unit stride and dilation and a single group.
+// The weights are transformed once, then each input tile is transformed and multiplied with
+// every output channel, with the transforms and the channel sums done in double. The output
+// must be standard.
+template <std::size_t M, class Output, class T, class Padding>
+void convolution_winograd(Output output, T input, T weights, const Padding& padding)
+{
+    using mat            = detail::winograd_matrices<M>;
+    constexpr auto alpha = mat::alpha;
+    constexpr auto tsize = alpha * alpha;
+    const auto& in_lens  = input.get_shape().lens();
+    const auto& out_lens = output.get_shape().lens();
+    auto batch           = in_lens[0];
+    auto in_c            = in_lens[1];
+    auto out_c           = out_lens[1];
+    auto ih              = std::ptrdiff_t(in_lens[2]);
+    auto iw              = std::ptrdiff_t(in_lens[3]);
+    auto oh              = out_lens[2];
+    auto ow              = out_lens[3];
+    auto th              = (oh + M - 1) / M;
+    auto tw              = (ow + M - 1) / M;
+    auto pad_h           = std::ptrdiff_t(padding[0]);
+    auto pad_w           = std::ptrdiff_t(padding[1]);
+
+    // Transformed weights laid out as [tsize][out_c][in_c]
+    std::vector<double> u(tsize * out_c * in_c);
+    par_for(out_c * in_c, [&](auto i) {
+        auto w = i / in_c;
+        auto c = i % in_c;
+        double g[9];
+        for(std::size_t j = 0; j < 9; j++)
+            g[j] = weights(w, c, j / 3, j % 3);
+        double y[tsize];
+        detail::winograd_transform(mat::g, g, y);
+        for(std::size_t t = 0; t < tsize; t++)
+            u[(t * out_c + w) * in_c + c] = y[t];
+    });
+
+    par_for(batch * th * tw, [&](auto i) {
+        auto n  = i / (th * tw);
+        auto y0 = (i / tw) % th * M;
+        auto x0 = i % tw * M;
+        // Transformed input tile laid out as [tsize][in_c]
+        std::vector<double> v(tsize * in_c);
+        for(std::size_t c = 0; c < in_c; c++)
+        {
+            double d[tsize];
+            for(std::size_t r = 0; r < alpha; r++)
+            {
+                auto y = std::ptrdiff_t(y0 + r) - pad_h;
+                for(std::size_t s = 0; s < alpha; s++)
+                {
+                    auto x = std::ptrdiff_t(x0 + s) - pad_w;
+                    bool inside = y >= 0 and y < ih and x >= 0 and x < iw;
+                    d[r * alpha + s] = inside ? double(input(n, c, y, x)) : 0.0;
+                }
+            }
+            double y[tsize];
+            detail::winograd_transform(mat::bt, d, y);
+            for(std::size_t t = 0; t < tsize; t++)
+                v[t * in_c + c] = y[t];
+        }
+        for(std::size_t w = 0; w < out_c; w++)
+        {
+            double prod[tsize];
+            for(std::size_t t = 0; t < tsize; t++)
+            {
+                const auto* ut = u.data() + (t * out_c + w) * in_c;
+                const auto* vt = v.data() + t * in_c;
+                double acc     = 0.0;
+                for(std::size_t c = 0; c < in_c; c++)
+                    acc += ut[c] * vt[c];
+                prod[t] = acc;
+            }
+            double y[M * M];
+            detail::winograd_transform(mat::at, prod, y);
+            auto* out = output.data() + (n * out_c + w) * oh * ow;
+            for(std::size_t r = 0; r < M and y0 + r < oh; r++)
+            {
+                for(std::size_t s = 0; s < M and x0 + s < ow; s++)
+                    out[(y0 + r) * ow + x0 + s] = y[r * M + s];
+            }
+        }
     });
 }
 
+// Picks the algorithm for a convolution from its shapes. Winograd is used for 2D 3x3 floating
+// point convolutions with unit stride and dilation, im2col when the window is large enough for
+// the gemm to pay off, and the direct loop otherwise. MIGRAPHX_DETERMINISTIC_CONVOLUTION forces
+// the direct loop, which accumulates in a fixed order regardless of the shapes.
+template <class Stride, class Dilation>
+convolution_algorithm select_convolution_algorithm(const shape& output_shape,
+                                                   const shape& weights_shape,
+                                                   const Stride& stride,
+                                                   const Dilation& dilation,
+                                                   int group)
+{
+    if(enabled(MIGRAPHX_DETERMINISTIC_CONVOLUTION{}) or not output_shape.standard())
+        return convolution_algorithm::direct;
+    const auto& wei_lens = weights_shape.lens();
+    const auto& out_lens = output_shape.lens();
+    auto is_one          = [](auto x) { return x == 1; };
+    bool unit = std::all_of(stride.begin(), stride.end(), is_one) and
+                std::all_of(dilation.begin(), dilation.end(), is_one);
+    if(not shape::is_integral(output_shape.type()) and wei_lens.size() == 4 and wei_lens[2] == 3 and
+       wei_lens[3] == 3 and unit and group == 1 and wei_lens[0] >= 4 and wei_lens[1] >= 4)
+    {
+        if(out_lens[2] >= 8 and out_lens[3] >= 8)
+            return convolution_algorithm::winograd_4x3;
+        if(out_lens[2] >= 2 and out_lens[3] >= 2)
+            return convolution_algorithm::winograd_2x3;
+    }
+    auto window = std::accumulate(
+        wei_lens.begin() + 1, wei_lens.end(), std::size_t{1}, std::multiplies<>{});
+    if(window >= 16)
+        return convolution_algorithm::im2col;
+    return convolution_algorithm::direct;
+}
+
+template <class Output, class T, class Padding, class Stride, class Dilation>
+void convolution(convolution_algorithm algo,
+                 Output output,
+                 T input,
+                 T weights,
+                 const Padding& padding,
+                 const Stride& stride,
+                 const Dilation& dilation,
+                 int group)
+{
+    switch(algo)
+    {
+    case convolution_algorithm::im2col:
+        convolution_im2col(output, input, weights, padding, stride, dilation, group);
+        break;
+    case convolution_algorithm::winograd_2x3:
+        convolution_winograd<2>(output, input, weights, padding);
+        break;
+    case convolution_algorithm::winograd_4x3:
+        convolution_winograd<4>(output, input, weights, padding);
+        break;
+    case convolution_algorithm::direct:
+        convolution_direct(output, input, weights, padding, stride, dilation, group);
+        break;
+    }
+}
+
+template <class Output, class T, class Padding, class Stride, class Dilation>
+void convolution(
+    Output output, T input, T weights, Padding padding, Stride stride, Dilation dilation, int group)
+{
+    auto algo = select_convolution_algorithm(
+        output.get_shape(), weights.get_shape(), stride, dilation, group);
+    convolution(algo, output, input, weights, padding, stride, dilation, group);
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
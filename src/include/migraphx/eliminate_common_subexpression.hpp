@@ -34,7 +34,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 
 /**
- * Remove identical instructions.
+ * Remove identical instructions. Instructions are hashed into a value numbering table in a single
+ * pass over the module, and the inputs of commutative operators are compared in either order.
  */
 struct MIGRAPHX_EXPORT eliminate_common_subexpression
 {
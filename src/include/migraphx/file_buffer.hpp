@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -40,6 +41,16 @@ MIGRAPHX_EXPORT void write_string(const fs::path& filename, const std::string& b
 MIGRAPHX_EXPORT void write_buffer(const fs::path& filename, const char* buffer, std::size_t size);
 MIGRAPHX_EXPORT void write_buffer(const fs::path& filename, const std::vector<char>& buffer);
 
+struct mapped_buffer
+{
+    std::shared_ptr<const char> data;
+    std::size_t size = 0;
+};
+
+/// Maps the whole file read-only into memory. The mapping is released once the last
+/// shared_ptr referring to it (including aliasing pointers into it) is destroyed.
+MIGRAPHX_EXPORT mapped_buffer map_buffer(const fs::path& filename);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
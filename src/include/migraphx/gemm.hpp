@@ -28,34 +28,108 @@
 #include <migraphx/dfor.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Computes alpha * (A x B) + beta * C over the last two dimensions. The output is split into
+// tiles that run in parallel, and the inner dimension is walked in blocks with both operands
+// packed as doubles so the innermost loop is contiguous and can be vectorized. Every output is
+// still accumulated in double and in order of k, so the result is the same as taking a dot
+// product per element, independent of the blocking and the number of threads.
 template <class T, class U, class F>
 void gemm(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
+    const std::size_t mb = 32;
+    const std::size_t nb = 64;
+    const std::size_t kb = 256;
+
+    const auto& as     = amat.get_shape();
+    const auto& bs     = bmat.get_shape();
+    const auto& cs     = cmat.get_shape();
+    std::size_t n_dims = cs.lens().size();
     std::size_t dim_0  = n_dims - 2;
     std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
+    auto m             = cs.lens()[dim_0];
+    auto n             = cs.lens()[dim_1];
+    auto k             = as.lens()[dim_1];
+
+    assert(as.lens()[dim_1] == bs.lens()[dim_0]);
+    assert(cs.lens()[dim_0] == as.lens()[dim_0]);
+    assert(cs.lens()[dim_1] == bs.lens()[dim_1]);
+    if(m == 0 or n == 0)
+        return;
+
+    auto batches   = cs.elements() / (m * n);
+    auto row_tiles = (m + mb - 1) / mb;
+    auto col_tiles = (n + nb - 1) / nb;
+    auto a_row     = as.strides()[dim_0];
+    auto a_col     = as.strides()[dim_1];
+    auto b_row     = bs.strides()[dim_0];
+    auto b_col     = bs.strides()[dim_1];
+    auto c_row     = cs.strides()[dim_0];
+    auto c_col     = cs.strides()[dim_1];
+
+    auto batch_offset = [&](const shape& s, std::size_t b) {
+        std::size_t offset = 0;
+        for(auto d = dim_0; d > 0; d--)
+        {
+            auto len = cs.lens()[d - 1];
+            offset += (b % len) * s.strides()[d - 1];
+            b /= len;
+        }
+        return offset;
+    };
 
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
+    par_for(batches * row_tiles * col_tiles, [&](auto tile) {
+        auto b     = tile / (row_tiles * col_tiles);
+        auto i0    = (tile / col_tiles) % row_tiles * mb;
+        auto j0    = tile % col_tiles * nb;
+        auto mt    = std::min(mb, m - i0);
+        auto nt    = std::min(nb, n - j0);
+        const U* a = amat.data() + batch_offset(as, b) + i0 * a_row;
+        const U* w = bmat.data() + batch_offset(bs, b) + j0 * b_col;
+        T* c       = cmat.data() + batch_offset(cs, b) + i0 * c_row + j0 * c_col;
 
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += static_cast<double>(amat(a_idx.begin(), a_idx.end())) *
-                 static_cast<double>(bmat(b_idx.begin(), b_idx.end()));
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+        std::vector<double> acc(mt * nt, 0.0);
+        std::vector<double> apack(mt * std::min(kb, k));
+        std::vector<double> bpack(std::min(kb, k) * nt);
+        for(std::size_t k0 = 0; k0 < k; k0 += kb)
+        {
+            auto kt = std::min(kb, k - k0);
+            for(std::size_t i = 0; i < mt; i++)
+            {
+                for(std::size_t kk = 0; kk < kt; kk++)
+                    apack[i * kt + kk] = static_cast<double>(a[i * a_row + (k0 + kk) * a_col]);
+            }
+            for(std::size_t kk = 0; kk < kt; kk++)
+            {
+                for(std::size_t j = 0; j < nt; j++)
+                    bpack[kk * nt + j] = static_cast<double>(w[(k0 + kk) * b_row + j * b_col]);
+            }
+            for(std::size_t i = 0; i < mt; i++)
+            {
+                double* acc_row = acc.data() + i * nt;
+                for(std::size_t kk = 0; kk < kt; kk++)
+                {
+                    auto x             = apack[i * kt + kk];
+                    const double* brow = bpack.data() + kk * nt;
+                    for(std::size_t j = 0; j < nt; j++)
+                        acc_row[j] += x * brow[j];
+                }
+            }
+        }
+        for(std::size_t i = 0; i < mt; i++)
+        {
+            for(std::size_t j = 0; j < nt; j++)
+            {
+                // The output is not read when beta is zero, so it can be uninitialized
+                auto& y = c[i * c_row + j * c_col];
+                y       = beta == 0 ? alpha * acc[i * nt + j] : alpha * acc[i * nt + j] + y * beta;
+            }
+        }
     });
 }
 
@@ -0,0 +1,76 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_HOST_POINTWISE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_HOST_POINTWISE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/shape.hpp>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/// A pointwise module prepared to be evaluated elementwise over the arguments on the host. The
+/// module is compiled into a native loop with the host C++ compiler, and identical modules share
+/// the kernel through a bounded cache. When jit is false, or the module can't be compiled, it is
+/// run with a tiled interpreter instead, which evaluates each instruction over blocks of elements.
+struct MIGRAPHX_EXPORT host_pointwise
+{
+    host_pointwise() = default;
+    explicit host_pointwise(const module& m, bool jit = true);
+
+    /// Returns false when the module has operators that need a context to run, such as the ones
+    /// a target lowered, which must be evaluated through the program instead
+    static bool is_supported(const module& m);
+
+    argument compute(const shape& output_shape, const std::vector<argument>& args) const;
+
+    private:
+    std::function<void(std::size_t, char**)> f;
+};
+
+/// Prepares the module the first time it is used, so an instruction compiles it only once
+struct MIGRAPHX_EXPORT lazy_host_pointwise
+{
+    const host_pointwise& get(const module& m);
+
+    private:
+    std::once_flag flag;
+    host_pointwise prepared;
+};
+
+MIGRAPHX_EXPORT argument compute_host_pointwise(const module& m,
+                                                const shape& output_shape,
+                                                const std::vector<argument>& args,
+                                                bool jit = true);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_HOST_POINTWISE_HPP
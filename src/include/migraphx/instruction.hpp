@@ -47,6 +47,8 @@ MIGRAPHX_EXPORT std::vector<shape> try_compute_shape(const operation& op,
 
 MIGRAPHX_EXPORT bool reaches(instruction_ref start, instruction_ref end);
 
+struct module_impl;
+
 struct MIGRAPHX_EXPORT instruction
 {
     instruction() {}
@@ -151,6 +153,9 @@ struct MIGRAPHX_EXPORT instruction
                       const std::unordered_map<instruction_ref, std::string>& names);
 
     private:
+    // The module sets and clears the owner of its instructions
+    friend struct module_impl;
+
     // internal
     void replace(operation o, const shape& r, std::vector<instruction_ref> args);
 
@@ -174,6 +179,9 @@ struct MIGRAPHX_EXPORT instruction
 
     void replace(const shape& r);
 
+    // Bumps the version of the module the instruction is in
+    void update_version();
+
     operation op;
     shape result{};
     std::vector<instruction_ref> output;
@@ -182,6 +190,9 @@ struct MIGRAPHX_EXPORT instruction
     literal lit;
     bool normalized       = false;
     std::size_t target_id = 0;
+    // The module the instruction is in, which is used to check that it belongs to a module and to
+    // record that the module was modified
+    module_impl* owner = nullptr;
 };
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -87,6 +87,12 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Shares the buffer, which must hold s.bytes(), instead of copying it
+    literal(const shape& s, std::shared_ptr<const char> x)
+        : buffer(std::const_pointer_cast<char>(std::move(x))), m_shape(s)
+    {
+    }
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -97,12 +103,9 @@ struct literal : raw_data<literal>
 
     std::vector<literal> get_sub_objects() const { return {}; }
 
-    /// Convert the data to an argument
-    argument get_argument() const
-    {
-        auto b = make_shared_array<char>(buffer.get(), buffer.get() + m_shape.bytes());
-        return {m_shape, [b]() { return b.get(); }};
-    }
+    /// Convert the data to a read-only argument that shares the buffer of the literal. Use
+    /// argument::writable to get a copy that can be modified.
+    argument get_argument() const { return {m_shape, std::shared_ptr<const char>(buffer)}; }
 
     private:
     std::shared_ptr<char> buffer;
@@ -32,11 +32,15 @@
 #include <migraphx/optional.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/type_name.hpp>
+#include <migraphx/rank.hpp>
 #include <migraphx/source_location.hpp>
 #include <migraphx/config.hpp>
 #include <array>
+#include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #ifndef MIGRAPHX_USE_TYPE_ERASED_MATCHERS
 #define MIGRAPHX_USE_TYPE_ERASED_MATCHERS 0
@@ -135,22 +139,62 @@ function_matcher<F> make_function_matcher(F f)
     return {f};
 }
 
+template <class M>
+auto get_root_names_impl(rank<1>, const M& m) -> decltype(m.root_names())
+{
+    return m.root_names();
+}
+
+template <class M>
+std::vector<std::string> get_root_names_impl(rank<0>, const M&)
+{
+    return {};
+}
+
+/// Get the operator names the matched instruction is restricted to. The matcher can only match
+/// an instruction with one of these names, and an empty list means any instruction can match.
+template <class M>
+std::vector<std::string> get_root_names(const M& m)
+{
+    return get_root_names_impl(rank<1>{}, m);
+}
+
+/// Wraps a matcher with the operator names the matched instruction is restricted to
+template <class M>
+struct root_matcher
+{
+    M m;
+    std::vector<std::string> names;
+
+    std::vector<std::string> root_names() const { return names; }
+
+    auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+};
+
+template <class M>
+root_matcher<M> make_root_matcher(M m, std::vector<std::string> names)
+{
+    return {m, std::move(names)};
+}
+
 /// Converts a matcher to bind the instruction to name
 template <class M>
 auto bind_match(M m, std::string name)
 {
-    return make_function_matcher(
-        [=, m_name = std::move(name)](matcher_context& ctx,
-                                      instruction_ref ins) -> optional<instruction_ref> {
-            auto result = m.match(ctx, ins);
-            if(result)
-            {
-                if(not ctx.has_instruction(ins))
-                    return nullopt;
-                ctx.instructions[m_name] = ins;
-            }
-            return result;
-        });
+    return make_root_matcher(
+        make_function_matcher(
+            [=, m_name = std::move(name)](matcher_context& ctx,
+                                          instruction_ref ins) -> optional<instruction_ref> {
+                auto result = m.match(ctx, ins);
+                if(result)
+                {
+                    if(not ctx.has_instruction(ins))
+                        return nullopt;
+                    ctx.instructions[m_name] = ins;
+                }
+                return result;
+            }),
+        get_root_names(m));
 }
 
 /// Convert a matcher to a bindable matcher
@@ -161,6 +205,8 @@ struct bindable_matcher
 
     auto bind(std::string name) const { return bind_match(m, std::move(name)); }
 
+    std::vector<std::string> root_names() const { return get_root_names(m); }
+
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
 };
 
@@ -231,32 +277,39 @@ struct basic_matcher
     {
         // Copy m because we cant capture `this` by value
         auto mm = m;
-        return make_basic_fun_matcher([=](matcher_context& ctx,
-                                          instruction_ref ins) -> optional<instruction_ref> {
-            auto result = mm.match(ctx, ins);
-            if(result)
-            {
-                bool matches =
-                    fold([&](auto x, auto y) { return x and ctx.matched(y, result); })(true, ms...);
-                if(matches)
-                    return result;
-            }
-            return nullopt;
-        });
+        return make_basic_matcher(make_root_matcher(
+            make_function_matcher(
+                [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
+                    auto result = mm.match(ctx, ins);
+                    if(result)
+                    {
+                        bool matches = fold([&](auto x, auto y) {
+                            return x and ctx.matched(y, result);
+                        })(true, ms...);
+                        if(matches)
+                            return result;
+                    }
+                    return nullopt;
+                }),
+            get_root_names(m)));
     }
 
     auto bind(std::string name) const { return bind_match(m, std::move(name)); }
 
+    std::vector<std::string> root_names() const { return get_root_names(m); }
+
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
 };
 
 /// Create a typed-erased matcher
-using any_matcher_base = basic_matcher<
-    function_matcher<std::function<optional<instruction_ref>(matcher_context&, instruction_ref)>>>;
+using any_matcher_base = basic_matcher<root_matcher<
+    function_matcher<std::function<optional<instruction_ref>(matcher_context&, instruction_ref)>>>>;
 struct any_matcher : any_matcher_base
 {
     template <class M>
-    any_matcher(M mm) : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }})
+    any_matcher(M mm)
+        : any_matcher_base({{{[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }},
+                             get_root_names(mm)}})
     {
     }
 };
@@ -402,61 +455,126 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES_FOR)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_VALIDATE_MATCHES)
 
+/// Apply the finder if the matcher matches the instruction
+template <class Mod, class Finder, class M>
+bool apply_finder(Mod& mod,
+                  instruction_ref ins,
+                  const Finder& finder,
+                  const M& matcher,
+                  const std::string& matcher_name,
+                  int trace,
+                  bool trace_for,
+                  bool validate)
+{
+    if(trace > 1 and trace_for)
+        std::cout << "Match: " << matcher_name << std::endl;
+    auto r = match_instruction(get_module(mod), ins, matcher);
+    if(r.result == get_module(mod).end())
+        return false;
+    if(trace > 0 or trace_for)
+    {
+        std::cout << "Matched by " << matcher_name << std::endl;
+        get_module(mod).debug_print(ins);
+    }
+    // If its already invalid dont validate it again
+    bool invalidated = validate and get_module(mod).validate() != get_module(mod).end();
+    finder.apply(mod, r);
+    if(validate and not invalidated)
+    {
+        auto invalid = get_module(mod).validate();
+        if(invalid != get_module(mod).end())
+        {
+            std::cout << "Invalid program from match: " << matcher_name << std::endl;
+            std::cout << "Invalid instructions: " << std::endl;
+            get_module(mod).debug_print(invalid->inputs());
+            get_module(mod).debug_print(invalid);
+        }
+    }
+    return true;
+}
+
+inline bool trace_matches_for(source_location location, const std::string& trace_filter)
+{
+    return not trace_filter.empty() and
+           (contains(std::string{location.file_name()}, trace_filter) or
+            contains(std::string{location.function_name()}, trace_filter));
+}
+
 /// Find matches for an instruction in the module for per section of matchers
 template <class Mod, class... Ms>
 void find_matches_for(source_location location, Mod& mod, instruction_ref ins, Ms&&... ms)
 {
-    const int trace         = value_of(MIGRAPHX_TRACE_MATCHES{});
-    const bool validate     = enabled(MIGRAPHX_VALIDATE_MATCHES{});
-    const auto trace_filter = string_value_of(MIGRAPHX_TRACE_MATCHES_FOR{});
-    bool match              = false;
+    const int trace           = value_of(MIGRAPHX_TRACE_MATCHES{});
+    const bool validate       = enabled(MIGRAPHX_VALIDATE_MATCHES{});
+    const auto& trace_filter  = string_value_of(MIGRAPHX_TRACE_MATCHES_FOR{});
+    const bool trace_location = trace_matches_for(location, trace_filter);
+    bool match                = false;
     each_args(
         [&](auto&& m) {
-            const auto& matcher_name = get_type_name(m);
-            const bool trace_for     = not trace_filter.empty() and
-                                   (contains(std::string{location.file_name()}, trace_filter) or
-                                    contains(std::string{location.function_name()}, trace_filter) or
-                                    contains(matcher_name, trace_filter));
             if(match)
                 return;
-            if(trace > 1 and trace_for)
-                std::cout << "Match: " << matcher_name << std::endl;
-            auto r = match_instruction(get_module(mod), ins, m.matcher());
-            if(r.result == get_module(mod).end())
-                return;
-            if(trace > 0 or trace_for)
-            {
-                std::cout << "Matched by " << matcher_name << std::endl;
-                get_module(mod).debug_print(ins);
-            }
-            // If its already invalid dont validate it again
-            bool invalidated = validate and get_module(mod).validate() != get_module(mod).end();
-            m.apply(mod, r);
-            if(validate and not invalidated)
-            {
-                auto invalid = get_module(mod).validate();
-                if(invalid != get_module(mod).end())
-                {
-                    std::cout << "Invalid program from match: " << matcher_name << std::endl;
-                    std::cout << "Invalid instructions: " << std::endl;
-                    get_module(mod).debug_print(invalid->inputs());
-                    get_module(mod).debug_print(invalid);
-                }
-            }
-            match = true;
+            const auto& matcher_name = get_type_name(m);
+            const bool trace_for     = trace_location or (not trace_filter.empty() and
+                                                      contains(matcher_name, trace_filter));
+            match =
+                apply_finder(mod, ins, m, m.matcher(), matcher_name, trace, trace_for, validate);
         },
         ms...);
 }
 
-/// Find matches in a module
+/// Maps operator names to the matchers that need to be tried on an instruction with that name
+struct MIGRAPHX_EXPORT matcher_dispatch
+{
+    matcher_dispatch() = default;
+    /// Takes the root names of each matcher, where an empty list means the matcher can match any
+    /// instruction
+    matcher_dispatch(const std::vector<std::vector<std::string>>& root_names);
+
+    /// Indices of the matchers to try in their original order
+    const std::vector<std::size_t>& get(const std::string& name) const;
+
+    private:
+    std::unordered_map<std::string, std::vector<std::size_t>> table;
+    std::vector<std::size_t> unrestricted;
+};
+
+/// Find matches in a module. Each finder's matcher is built once, and it is only tried on
+/// instructions that have one of the root names declared by the matcher.
 template <class Mod, class... Ms>
 struct find_matches
 {
     find_matches(Mod& mod, Ms&&... ms, source_location location = source_location::current())
     {
+        const int trace           = value_of(MIGRAPHX_TRACE_MATCHES{});
+        const bool validate       = enabled(MIGRAPHX_VALIDATE_MATCHES{});
+        const auto& trace_filter  = string_value_of(MIGRAPHX_TRACE_MATCHES_FOR{});
+        const bool trace_location = trace_matches_for(location, trace_filter);
+
+        std::vector<std::function<bool(instruction_ref)>> finders;
+        std::vector<std::vector<std::string>> root_names;
+        each_args(
+            [&](auto&& m) {
+                auto matcher = m.matcher();
+                root_names.push_back(get_root_names(matcher));
+                const auto* finder       = &m;
+                const auto* matcher_name = &get_type_name(m);
+                const bool trace_for     = trace_location or (not trace_filter.empty() and
+                                                          contains(*matcher_name, trace_filter));
+                finders.push_back([=, &mod](instruction_ref ins) {
+                    return apply_finder(
+                        mod, ins, *finder, matcher, *matcher_name, trace, trace_for, validate);
+                });
+            },
+            ms...);
+        matcher_dispatch dispatch{root_names};
+
         for(auto ins : iterator_for(get_module(mod)))
         {
-            find_matches_for(location, mod, ins, ms...);
+            for(auto i : dispatch.get(ins->name()))
+            {
+                if(finders[i](ins))
+                    break;
+            }
         }
     }
 };
@@ -530,16 +648,64 @@ struct match_fold_f
         return p([&](auto... ms) { return match_fold_f::fold_matchers(ctx, ins, ms...); });
     }
 
+    // Every restriction on the root has to hold when all matchers must match, whereas when any
+    // matcher can match the root is only restricted if all of the matchers restrict it
+    template <class... Ts>
+    static std::vector<std::string> fold_root_names(const Ts&... ms)
+    {
+        if(not Matches)
+            return {};
+        std::vector<std::vector<std::string>> names_list = {get_root_names(ms)...};
+        std::vector<std::string> result;
+        if(std::is_same<Op, lazy_and>{})
+        {
+            for(auto& names : names_list)
+            {
+                if(names.empty())
+                    continue;
+                if(result.empty())
+                {
+                    result = std::move(names);
+                    continue;
+                }
+                std::vector<std::string> common;
+                std::copy_if(names.begin(),
+                             names.end(),
+                             std::back_inserter(common),
+                             [&](const auto& name) { return contains(result, name); });
+                // An empty intersection never matches, so keeping the previous names is still
+                // correct
+                if(not common.empty())
+                    result = std::move(common);
+            }
+        }
+        else
+        {
+            for(auto& names : names_list)
+            {
+                if(names.empty())
+                    return {};
+                std::copy_if(names.begin(),
+                             names.end(),
+                             std::back_inserter(result),
+                             [&](const auto& name) { return not contains(result, name); });
+            }
+        }
+        return result;
+    }
+
     template <class... Ts>
     auto operator()(Ts... ms) const
     {
-        return make_bf_matcher(
-            [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
-                bool matches = match_fold_f::fold_matchers(ctx, ins, ms...);
-                if(matches == Matches)
-                    return {ins};
-                return nullopt;
-            });
+        return make_bindable_matcher(make_root_matcher(
+            make_function_matcher(
+                [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
+                    bool matches = match_fold_f::fold_matchers(ctx, ins, ms...);
+                    if(matches == Matches)
+                        return {ins};
+                    return nullopt;
+                }),
+            fold_root_names(ms...)));
     }
 
     template <class Selector>
@@ -774,8 +940,11 @@ inline auto var(std::string s)
 
 inline auto name(std::string s)
 {
-    return make_basic_pred_matcher(
-        [=, m_s = std::move(s)](instruction_ref ins) { return ins->name() == m_s; });
+    std::vector<std::string> names = {s};
+    return make_basic_matcher(make_root_matcher(
+        make_predicate_matcher(
+            [=, m_s = std::move(s)](instruction_ref ins) { return ins->name() == m_s; }),
+        std::move(names)));
 }
 
 inline auto name_contains(const std::string& name)
@@ -786,9 +955,12 @@ inline auto name_contains(const std::string& name)
 
 inline auto name(std::unordered_set<std::string> names)
 {
-    return make_basic_pred_matcher([=, m_names = std::move(names)](instruction_ref ins) {
-        return m_names.count(ins->name()) > 0;
-    });
+    std::vector<std::string> root_names(names.begin(), names.end());
+    return make_basic_matcher(make_root_matcher(
+        make_predicate_matcher([=, m_names = std::move(names)](instruction_ref ins) {
+            return m_names.count(ins->name()) > 0;
+        }),
+        std::move(root_names)));
 }
 
 template <class... Ts>
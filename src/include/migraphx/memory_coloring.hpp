@@ -33,8 +33,9 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 
 /**
- * Remove multiple memory allocations using graph coloring to find memory allocations that can be
- * reused.
+ * Replace the allocations with offsets into a single scratch buffer. The live intervals of the
+ * allocations are computed, and allocations that are never live at the same time can reuse the
+ * same memory. When verify is set, the pass checks that no live allocations overlap.
  */
 struct MIGRAPHX_EXPORT memory_coloring
 {
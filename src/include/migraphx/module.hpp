@@ -199,6 +199,8 @@ struct MIGRAPHX_EXPORT module
     std::vector<instruction_ref> get_returns() const;
 
     std::size_t size() const;
+    /// Returns a number that changes every time the module or one of its instructions is modified
+    std::size_t get_version() const;
     instruction_ref begin() const;
     instruction_ref end() const;
 
@@ -26,10 +26,12 @@
 
 #include <migraphx/op/name.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/dyn_output.hpp>
 #include <migraphx/par.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -57,7 +59,7 @@ struct binary : op_name<Derived>
     value base_attributes() const
     {
         const auto& self = static_cast<const Derived&>(*this);
-        return {{"pointwise", true}, {"point_op", self.point_op()}};
+        return {{"pointwise", true}, {"point_op", self.point_op()}, {"compute_into", true}};
     }
     value attributes() const { return base_attributes(); }
     shape compute_shape(std::vector<shape> inputs) const
@@ -92,15 +94,33 @@ struct binary : op_name<Derived>
         }
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return memory_cost(output, inputs, output.elements());
+    }
+
+    // The result is written into the argument after the inputs when one is given
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        argument result = args.size() > 2 ? args[2] : argument{dyn_out.computed_shape};
         visit_all(result, args[0], args[1])([&](auto output, auto input1, auto input2) {
-            par_transform(input1.begin(),
-                          input1.end(),
-                          input2.begin(),
-                          output.begin(),
-                          static_cast<const Derived&>(*this).apply());
+            auto f          = static_cast<const Derived&>(*this).apply();
+            const auto& s1  = input1.get_shape();
+            const auto& s2  = input2.get_shape();
+            auto* out       = output.data();
+            const auto* in1 = input1.data();
+            const auto* in2 = input2.data();
+            // Same packed layout, so the elements can be processed as flat memory
+            if(s1.packed() and s1 == s2 and s1 == output.get_shape())
+            {
+                par_transform(in1, in1 + s1.elements(), in2, out, f);
+            }
+            else
+            {
+                par_shape_for_each_offset(
+                    {output.get_shape(), s1, s2},
+                    [&](auto i, auto j, auto k) { out[i] = f(in1[j], in2[k]); });
+            }
         });
         return result;
     }
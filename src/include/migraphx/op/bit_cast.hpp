@@ -74,7 +74,7 @@ struct bit_cast : unary<bit_cast>
 
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        argument result = args.size() > 1 ? args[1] : argument{dyn_out.computed_shape};
         result.visit([&](auto output) {
             using otype = typename decltype(output)::value_type;
             args[0].visit([&](auto input) {
@@ -31,6 +31,8 @@
 #include <migraphx/convolution.hpp>
 #include <migraphx/pad_calc.hpp>
 #include <migraphx/value.hpp>
+#include <migraphx/op_cost.hpp>
+#include <numeric>
 #include <cmath>
 #include <utility>
 
@@ -72,7 +74,7 @@ struct convolution
         }
     }
 
-    value attributes() const { return {{"normalize_padding", "padding"}}; }
+    value attributes() const { return {{"normalize_padding", "padding"}, {"compute_into", true}}; }
 
     shape normalize_compute_shape(std::vector<shape> inputs) const
     {
@@ -201,6 +203,16 @@ struct convolution
         return stride.size();
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        // A multiply and an add for each weight that contributes to an output element
+        const auto& wlens = inputs.at(1).lens();
+        auto window       = std::accumulate(
+            wlens.begin() + 1, wlens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+        return memory_cost(output, inputs, 2.0 * output.elements() * window);
+    }
+
+    // The result is written into the argument after the inputs when one is given
     argument compute(shape output_shape, std::vector<argument> args) const
     {
         std::vector<std::size_t> new_padding;
@@ -227,7 +239,7 @@ struct convolution
             }
         }
 
-        argument result{output_shape};
+        argument result = args.size() > 2 ? args[2] : argument{output_shape};
         visit_all(result, args[0], args[1])([&](auto output, auto input, auto weights) {
             migraphx::convolution(output, input, weights, new_padding, stride, dilation, group);
         });
@@ -34,6 +34,8 @@
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/dyn_output.hpp>
+#include <migraphx/op_cost.hpp>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -139,6 +141,15 @@ struct convolution_backwards
         return x_shape.with_lens(output_lens);
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        // Each input element is scattered through the weights of its group
+        const auto& wlens = inputs.at(1).lens();
+        auto window       = std::accumulate(
+            wlens.begin() + 1, wlens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+        return memory_cost(output, inputs, 2.0 * inputs.front().elements() * window);
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
@@ -29,6 +29,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/gemm.hpp>
 #include <migraphx/dyn_output.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -123,6 +124,12 @@ struct dot
         }
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        // A multiply and an add for each element of the inner dimension
+        return memory_cost(output, inputs, 2.0 * output.elements() * inputs.front().lens().back());
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result = argument{dyn_out.computed_shape};
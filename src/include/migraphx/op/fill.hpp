@@ -54,10 +54,11 @@ struct fill
 
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        visit_all(args[0], args[1])([&](auto value, auto output) {
+        auto result = args[1].writable();
+        visit_all(args[0], result)([&](auto value, auto output) {
             par_for(dyn_out.computed_shape.elements(), [&](auto i) { output[i] = value.front(); });
         });
-        return args[1];
+        return result;
     }
 
     std::ptrdiff_t output_alias(const std::vector<shape>&) const { return 1; }
@@ -34,6 +34,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
+#include <migraphx/op_cost.hpp>
 #include <cmath>
 #include <utility>
 
@@ -105,6 +106,12 @@ struct gather
         }
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        // Only the gathered elements of the data are read
+        return {0, inputs.at(1).bytes() + 2.0 * output.bytes()};
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
@@ -125,15 +132,24 @@ struct gather
                     auto out_lens  = data.get_shape().lens();
                     out_lens[axis] = indices.get_shape().elements();
                     migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-                    shape_for_each(out_comp_shape, [&](const auto& out_idx_v, size_t out_idx) {
-                        auto data_idx   = out_idx_v;
-                        auto in_index   = indices[data_idx[axis]];
-                        in_index        = (in_index < 0) ? in_index + axis_dim_size : in_index;
+                    // Walk the data with the gathered axis pinned to zero and the position along
+                    // the axis as a separate offset, so the gathered element is a multiply-add
+                    auto data_strides  = data.get_shape().strides();
+                    auto axis_stride   = data_strides[axis];
+                    data_strides[axis] = 0;
+                    std::vector<std::size_t> pos_strides(out_lens.size());
+                    pos_strides[axis] = 1;
+                    shape data_shape{data.get_shape().type(), out_lens, data_strides};
+                    shape pos_shape{shape::uint64_type, out_lens, pos_strides};
+                    const auto* in = data.data();
+                    auto f         = [&](auto i, auto j, auto k) {
+                        auto in_index = indices[k];
+                        in_index      = (in_index < 0) ? in_index + axis_dim_size : in_index;
                         // don't go out of bounds: https://github.com/ROCm/AMDMIGraphX/issues/2838
                         assert(in_index >= 0 and in_index < axis_dim_size);
-                        data_idx[axis]  = in_index;
-                        output[out_idx] = data(data_idx.begin(), data_idx.end());
-                    });
+                        output[i] = in[j + static_cast<std::size_t>(in_index) * axis_stride];
+                    };
+                    shape_for_each_offset({out_comp_shape, data_shape, pos_shape}, f);
                 }
             });
         });
@@ -28,6 +28,7 @@
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -64,6 +65,12 @@ struct logsoftmax
         }
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        // The max, subtract, exp, sum and divide of each element
+        return memory_cost(output, inputs, 5.0 * output.elements());
+    }
+
     auto output() const
     {
         return [=](auto x, auto y) { return std::log(x / y); };
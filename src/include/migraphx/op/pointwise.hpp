@@ -29,7 +29,9 @@
 #include <migraphx/module.hpp>
 #include <migraphx/permutation.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/host_pointwise.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -37,6 +39,13 @@ namespace op {
 
 struct pointwise
 {
+    // The prepared module is not part of the operator's value
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return pack();
+    }
+
     std::string name() const { return "pointwise"; }
 
     shape compute_shape(const std::vector<shape>& inputs, std::vector<module_ref> mods) const
@@ -59,14 +68,42 @@ struct pointwise
         return shape{result};
     }
 
+    op_cost estimate_cost(const shape& output,
+                          const std::vector<shape>& inputs,
+                          const std::vector<module_ref>& mods) const
+    {
+        const auto& pm = *mods.front();
+        auto n         = std::count_if(pm.begin(), pm.end(), [](const auto& ins) {
+            return not starts_with(ins.name(), "@");
+        });
+        // The inputs all have the dimensions of the output, which may be a tuple
+        return memory_cost(output, inputs, 1.0 * inputs.front().elements() * n);
+    }
+
+    // Created in finalize, so each compiled instruction prepares its module only once
+    std::shared_ptr<lazy_host_pointwise> prepared = nullptr;
+
+    void finalize(context&, const shape&, const std::vector<shape>&)
+    {
+        prepared = std::make_shared<lazy_host_pointwise>();
+    }
+
     argument compute(const shape& output_shape,
                      const std::vector<argument>& args,
                      const std::vector<module_ref>& mods,
                      const std::function<std::vector<argument>(
                          module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
     {
+        auto* pm = mods.front();
+        if(host_pointwise::is_supported(*pm))
+        {
+            if(prepared != nullptr)
+                return prepared->get(*pm).compute(output_shape, args);
+            return compute_host_pointwise(*pm, output_shape, args);
+        }
+        // The module was lowered by a target, so evaluate it an element at a time with the
+        // target's context
         argument output{output_shape};
-        auto* pm    = mods.front();
         auto pnames = pm->get_parameter_names();
         std::sort(pnames.begin(), pnames.end());
 
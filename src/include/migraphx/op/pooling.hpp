@@ -33,6 +33,8 @@
 #include <migraphx/par_for.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/dyn_output.hpp>
+#include <migraphx/op_cost.hpp>
+#include <numeric>
 #include <cmath>
 #include <utility>
 
@@ -360,6 +362,9 @@ struct pooling
             auto pool_size    = win_shape.elements();
             double output_val = op.template init<Type>();
 
+            // the coordinates of the current window element; the batch and channel stay fixed
+            auto idx = idx_o;
+
             // for each element in the window...
             shape_for_each(win_shape, [&](const auto& idx_w) {
                 // Skip elements that belong to the dilated area
@@ -372,9 +377,6 @@ struct pooling
                     }
                 }
 
-                // the coordinates of this element
-                auto idx = idx_o;
-
                 // Add the kernel location idx_w and the offset win_start, for each dimension.
                 // Negative results are cast to very large unsigned integers.
                 std::transform(idx_w.begin(),
@@ -411,6 +413,16 @@ struct pooling
         });
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        auto window = lengths;
+        if(dyn_global)
+            window.assign(inputs.front().lens().begin() + 2, inputs.front().lens().end());
+        auto n = std::accumulate(
+            window.begin(), window.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+        return memory_cost(output, inputs, 1.0 * output.elements() * n);
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result;
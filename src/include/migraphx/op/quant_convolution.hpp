@@ -32,6 +32,8 @@
 #include <migraphx/convolution.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/fp8_types.hpp>
+#include <migraphx/op_cost.hpp>
+#include <numeric>
 #include <cmath>
 #include <utility>
 
@@ -124,6 +126,15 @@ struct quant_convolution
         return stride.size();
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        // A multiply and an add for each weight that contributes to an output element
+        const auto& wlens = inputs.at(1).lens();
+        auto window       = std::accumulate(
+            wlens.begin() + 1, wlens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+        return memory_cost(output, inputs, 2.0 * output.elements() * window);
+    }
+
     argument compute(shape output_shape, std::vector<argument> args) const
     {
         argument result{output_shape};
@@ -29,6 +29,7 @@
 #include <migraphx/gemm.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/fp8_types.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -83,7 +84,12 @@ struct quant_dot
         } // else int8 gemm
         return {shape::int32_type, out_lens};
     }
-};
+
+
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return memory_cost(output, inputs, 2.0 * output.elements() * inputs.front().lens().back());
+    }};
 
 } // namespace op
 } // namespace MIGRAPHX_INLINE_NS
@@ -34,6 +34,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
+#include <migraphx/op_cost.hpp>
 #include <vector>
 
 namespace migraphx {
@@ -233,6 +234,11 @@ struct reduce_op : op_name<Derived>
         return result;
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return memory_cost(output, inputs, inputs.front().elements());
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         auto&& data_arg = args[0];
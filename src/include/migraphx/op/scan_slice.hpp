@@ -80,7 +80,7 @@ struct scan_slice : op_name<scan_slice>
         idx = (1 - direction) * idx + direction * (max_idx - idx);
 
         auto offset = idx * input_sh.strides().at(axis) * input_sh.type_size();
-        return {output_shape, [=] { return input.data() + offset; }};
+        return input.view(output_shape, offset);
     }
 };
 
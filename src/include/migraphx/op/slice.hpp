@@ -402,7 +402,7 @@ struct slice
         if(args.size() == 1)
         {
             std::size_t offset = compute_offset(input_shape);
-            return {dyn_out.computed_shape, [=] { return input.data() + offset; }};
+            return input.view(dyn_out.computed_shape, offset);
         }
         else
         {
@@ -497,7 +497,7 @@ struct slice
                                                norm_inputs.at("norm_ends"),
                                                norm_inputs.at("norm_axes")),
                                      input_shape.strides()};
-            return {calc_shape, [=] { return input.data() + offset; }};
+            return input.view(calc_shape, offset);
         }
     }
 
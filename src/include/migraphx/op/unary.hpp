@@ -32,6 +32,7 @@
 #include <migraphx/value.hpp>
 #include <migraphx/dyn_output.hpp>
 #include <migraphx/par.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -59,7 +60,7 @@ struct unary : op_name<Derived>
     value base_attributes() const
     {
         const auto& self = static_cast<const Derived&>(*this);
-        return {{"pointwise", true}, {"point_op", self.point_op()}};
+        return {{"pointwise", true}, {"point_op", self.point_op()}, {"compute_into", true}};
     }
     value attributes() const { return base_attributes(); }
     shape compute_shape(std::vector<shape> inputs) const
@@ -80,15 +81,33 @@ struct unary : op_name<Derived>
         }
     }
 
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return memory_cost(output, inputs, output.elements());
+    }
+
+    // The result is written into the argument after the input when one is given
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        argument result = args.size() > 1 ? args[1] : argument{dyn_out.computed_shape};
         result.visit([&](auto output) {
             args[0].visit([&](auto input) {
-                par_transform(input.begin(),
-                              input.end(),
-                              output.begin(),
-                              static_cast<const Derived&>(*this).apply());
+                auto f            = static_cast<const Derived&>(*this).apply();
+                const auto& in_s  = input.get_shape();
+                const auto& out_s = output.get_shape();
+                auto* out         = output.data();
+                const auto* in    = input.data();
+                // Same packed layout, so the elements can be processed as flat memory
+                if(in_s.packed() and in_s.lens() == out_s.lens() and
+                   in_s.strides() == out_s.strides())
+                {
+                    par_transform(in, in + in_s.elements(), out, f);
+                }
+                else
+                {
+                    par_shape_for_each_offset({out_s, in_s},
+                                              [&](auto i, auto j) { out[i] = f(in[j]); });
+                }
             });
         });
         return result;
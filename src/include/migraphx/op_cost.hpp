@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_OP_COST_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_OP_COST_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/shape.hpp>
+#include <ostream>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// The work done by an operation, estimated analytically from its shapes and attributes
+struct MIGRAPHX_EXPORT op_cost
+{
+    /// Arithmetic operations, where a multiply-add counts as two
+    double flops = 0;
+    /// Bytes read from the inputs plus the bytes written to the output
+    double bytes = 0;
+
+    /// Operations per byte moved, or zero when no memory is moved
+    double intensity() const;
+
+    op_cost& operator+=(const op_cost& x);
+
+    friend op_cost operator+(op_cost x, const op_cost& y) { return x += y; }
+    friend bool operator==(const op_cost& x, const op_cost& y)
+    {
+        return x.flops == y.flops and x.bytes == y.bytes;
+    }
+    friend bool operator!=(const op_cost& x, const op_cost& y) { return not(x == y); }
+
+    MIGRAPHX_EXPORT friend std::ostream& operator<<(std::ostream& os, const op_cost& x);
+};
+
+/// The cost of an operation that reads each input once and writes the output once
+MIGRAPHX_EXPORT op_cost memory_cost(const shape& output,
+                                    const std::vector<shape>& inputs,
+                                    double flops = 0);
+
+/// Estimate the cost of an instruction, which is zero when any of its shapes are dynamic
+MIGRAPHX_EXPORT op_cost estimate_cost(instruction_ref ins);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_OP_COST_HPP
@@ -41,6 +41,7 @@
 #include <migraphx/serialize.hpp>
 #include <migraphx/auto_any_cast.hpp>
 #include <migraphx/lifetime.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/config.hpp>
 
 namespace migraphx {
@@ -82,6 +83,12 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method to estimate the arithmetic operations and the bytes moved to compute
+    /// the output from the inputs. By default, the inputs are read once and the output is
+    /// written once, and views that alias their input move nothing.
+    op_cost estimate_cost(const shape& output,
+                          const std::vector<shape>& input,
+                          const std::vector<module_ref>& mod_args) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -499,6 +506,63 @@ lifetime get_lifetime_op(const T&)
     return lifetime::local;
 }
 
+template <class T>
+auto estimate_cost_op(rank<3>,
+                      const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>& mod_args)
+    -> decltype(x.estimate_cost(output, inputs, mod_args))
+{
+    return x.estimate_cost(output, inputs, mod_args);
+}
+
+template <class T>
+auto estimate_cost_op(rank<2>,
+                      const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>&) -> decltype(x.estimate_cost(output, inputs))
+{
+    return x.estimate_cost(output, inputs);
+}
+
+template <class T>
+auto estimate_cost_op(rank<1>,
+                      const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>&) -> decltype(x.output_alias(inputs), op_cost{})
+{
+    auto alias = x.output_alias(inputs);
+    if(alias < 0)
+        return memory_cost(output, inputs);
+    // Writes the output into the allocation passed as the last input
+    if(inputs.size() > 1 and static_cast<std::size_t>(alias) == inputs.size() - 1)
+        return memory_cost(output, {inputs.begin(), inputs.end() - 1});
+    // A view of its input
+    return {};
+}
+
+template <class T>
+op_cost estimate_cost_op(rank<0>,
+                         const T&,
+                         const shape& output,
+                         const std::vector<shape>& inputs,
+                         const std::vector<module_ref>&)
+{
+    return memory_cost(output, inputs);
+}
+
+template <class T>
+op_cost estimate_cost_op(const T& x,
+                         const shape& output,
+                         const std::vector<shape>& inputs,
+                         const std::vector<module_ref>& mod_args)
+{
+    return estimate_cost_op(rank<3>{}, x, output, inputs, mod_args);
+}
+
 } // namespace detail
 
 #ifdef TYPE_ERASED_DECLARATION
@@ -519,6 +583,10 @@ struct MIGRAPHX_EXPORT operation
     // (optional)
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
     // (optional)
+    op_cost estimate_cost(const shape& output,
+                          const std::vector<shape>& input,
+                          const std::vector<module_ref>& mod_args) const;
+    // (optional)
     value compile(context& ctx, const shape& output, const std::vector<shape>& input);
     // (optional)
     void finalize(context& ctx, const shape& output, const std::vector<shape>& input);
@@ -630,6 +698,27 @@ struct operation
         return detail::output_alias_op(private_detail_te_self, input);
     }
 
+    template <class T>
+    static auto private_detail_te_default_estimate_cost(char,
+                                                        T&& private_detail_te_self,
+                                                        const shape& output,
+                                                        const std::vector<shape>& input,
+                                                        const std::vector<module_ref>& mod_args)
+        -> decltype(private_detail_te_self.estimate_cost(output, input, mod_args))
+    {
+        return private_detail_te_self.estimate_cost(output, input, mod_args);
+    }
+
+    template <class T>
+    static op_cost private_detail_te_default_estimate_cost(float,
+                                                           T&& private_detail_te_self,
+                                                           const shape& output,
+                                                           const std::vector<shape>& input,
+                                                           const std::vector<module_ref>& mod_args)
+    {
+        return detail::estimate_cost_op(private_detail_te_self, output, input, mod_args);
+    }
+
     template <class T>
     static auto private_detail_te_default_compile(char,
                                                   T&& private_detail_te_self,
@@ -875,6 +964,12 @@ struct operation
                  private_detail_te_default_output_alias(char(0),
                                                         std::declval<PrivateDetailTypeErasedT>(),
                                                         std::declval<const std::vector<shape>&>()),
+                 private_detail_te_default_estimate_cost(
+                     char(0),
+                     std::declval<PrivateDetailTypeErasedT>(),
+                     std::declval<const shape&>(),
+                     std::declval<const std::vector<shape>&>(),
+                     std::declval<const std::vector<module_ref>&>()),
                  private_detail_te_default_compile(char(0),
                                                    std::declval<PrivateDetailTypeErasedT>(),
                                                    std::declval<context&>(),
@@ -1038,6 +1133,14 @@ struct operation
         return (*this).private_detail_te_get_handle().output_alias(input);
     }
 
+    op_cost estimate_cost(const shape& output,
+                          const std::vector<shape>& input,
+                          const std::vector<module_ref>& mod_args) const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().estimate_cost(output, input, mod_args);
+    }
+
     value compile(context& ctx, const shape& output, const std::vector<shape>& input)
     {
         assert((*this).private_detail_te_handle_mem_var);
@@ -1141,12 +1244,15 @@ struct operation
         virtual std::shared_ptr<private_detail_te_handle_base_type> clone() const = 0;
         virtual const std::type_info& type() const                                = 0;
 
-        virtual std::string name() const                                           = 0;
-        virtual bool is_context_free() const                                       = 0;
-        virtual bool need_normalization() const                                    = 0;
-        virtual bool has_finalize() const                                          = 0;
-        virtual lifetime get_lifetime() const                                      = 0;
-        virtual std::ptrdiff_t output_alias(const std::vector<shape>& input) const = 0;
+        virtual std::string name() const                                             = 0;
+        virtual bool is_context_free() const                                         = 0;
+        virtual bool need_normalization() const                                      = 0;
+        virtual bool has_finalize() const                                            = 0;
+        virtual lifetime get_lifetime() const                                        = 0;
+        virtual std::ptrdiff_t output_alias(const std::vector<shape>& input) const   = 0;
+        virtual op_cost estimate_cost(const shape& output,
+                                      const std::vector<shape>& input,
+                                      const std::vector<module_ref>& mod_args) const = 0;
         virtual value
         compile(context& ctx, const shape& output, const std::vector<shape>& input) = 0;
         virtual void
@@ -1237,6 +1343,15 @@ struct operation
             return private_detail_te_default_output_alias(char(0), private_detail_te_value, input);
         }
 
+        op_cost estimate_cost(const shape& output,
+                              const std::vector<shape>& input,
+                              const std::vector<module_ref>& mod_args) const override
+        {
+
+            return private_detail_te_default_estimate_cost(
+                char(0), private_detail_te_value, output, input, mod_args);
+        }
+
         value compile(context& ctx, const shape& output, const std::vector<shape>& input) override
         {
 
@@ -1490,6 +1605,23 @@ bool has_finalize(const T& x)
     return detail::has_finalize_op(x);
 }
 
+inline op_cost estimate_cost(const operation& op,
+                             const shape& output,
+                             const std::vector<shape>& inputs,
+                             const std::vector<module_ref>& mod_args = {})
+{
+    return op.estimate_cost(output, inputs, mod_args);
+}
+
+template <class T>
+op_cost estimate_cost(const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>& mod_args = {})
+{
+    return detail::estimate_cost_op(x, output, inputs, mod_args);
+}
+
 MIGRAPHX_EXPORT void migraphx_to_value(value& v, const operation& op);
 MIGRAPHX_EXPORT void migraphx_from_value(const value& v, operation& op);
 
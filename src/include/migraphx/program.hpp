@@ -92,6 +92,11 @@ struct MIGRAPHX_EXPORT program
 
     context& get_context() const;
 
+    /// Create a new set of contexts for the targets the program was compiled for. The contexts
+    /// don't share any state with the program's own contexts, so they can be used to evaluate
+    /// the program concurrently with eval_with_context.
+    std::vector<context> create_contexts() const;
+
     instruction_ref validate() const;
 
     target_assignments get_target_assignments(const std::vector<target>& targets,
@@ -116,6 +121,9 @@ struct MIGRAPHX_EXPORT program
 
     value to_value() const;
     void from_value(const value& v);
+    /// Same as from_value, but the literals are created by calling load_literal with the
+    /// serialized literal, which allows the literals to share an external buffer
+    void from_value(const value& v, const std::function<literal(const value&)>& load_literal);
 
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <migraphx/instruction_ref.hpp>
+#include <migraphx/calibration.hpp>
 #include <migraphx/operation.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/target.hpp>
@@ -46,8 +47,18 @@ MIGRAPHX_EXPORT void quantize_int8(program& prog,
                                    const std::vector<parameter_map>& calibration,
                                    const std::unordered_set<std::string>& ins_names = {
                                        "dot", "convolution"});
+MIGRAPHX_EXPORT void quantize_int8(program& prog,
+                                   const target& t,
+                                   const std::vector<parameter_map>& calibration,
+                                   const calibration_options& options,
+                                   const std::unordered_set<std::string>& ins_names = {
+                                       "dot", "convolution"});
 MIGRAPHX_EXPORT void
 quantize_fp8(program& prog, const target& t, const std::vector<parameter_map>& calibration);
+MIGRAPHX_EXPORT void quantize_fp8(program& prog,
+                                  const target& t,
+                                  const std::vector<parameter_map>& calibration,
+                                  const calibration_options& options);
 
 MIGRAPHX_EXPORT void quantize_int4_weights(program& prog);
 
@@ -78,6 +78,9 @@ argument run_loop(const LoopModel& model,
     int64_t iter = 0;
     for(iter = 0; iter < iter_num and cond; ++iter)
     {
+        // cond is written in place, so it must not alias a literal returned by the body
+        in_args.at(1) = in_args.at(1).writable();
+
         // copy iter num and cond to device memory
         model.copy(ctx, iter, in_args.at(0));
         model.copy(ctx, cond, in_args.at(1));
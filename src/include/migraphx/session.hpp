@@ -0,0 +1,69 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_SESSION_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_SESSION_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/program.hpp>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * @brief An independent execution state for a compiled program
+ *
+ * A session has its own contexts, and so its own streams and preallocated scratch buffers,
+ * while the instructions and literals are shared with the program. Sessions of the same
+ * program can be evaluated concurrently from different threads, but a single session must
+ * only be used by one thread at a time. The program must outlive its sessions and must not be
+ * modified while they are in use. A copy of a session gets new contexts of its own.
+ */
+struct MIGRAPHX_EXPORT session
+{
+    explicit session(const program& p);
+    session(const session& s);
+    session& operator=(const session& s);
+    session(session&&) noexcept            = default;
+    session& operator=(session&&) noexcept = default;
+
+    std::vector<argument> eval(parameter_map params);
+
+    void finish() const;
+
+    const program& get_program() const;
+
+    std::vector<context>& get_contexts();
+
+    private:
+    const program* prog = nullptr;
+    std::vector<context> contexts;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHLIB_SESSION_HPP
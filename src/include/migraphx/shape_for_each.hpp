@@ -26,7 +26,13 @@
 
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/thread_pool.hpp>
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -37,27 +43,160 @@ inline namespace MIGRAPHX_INLINE_NS {
 template <class F>
 void shape_for_each(const migraphx::shape& s, F f)
 {
-    std::vector<std::size_t> indices(s.lens().size());
+    const auto& lens = s.lens();
+    std::vector<std::size_t> indices(lens.size());
     const auto& index_const_ref = indices;
-    shape ss{s.type(), s.lens()};
-    size_t max = ss.elements();
+    size_t max                  = s.elements();
     for(std::size_t i = 0; i < max; i++)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
         if constexpr(std::is_invocable<F, decltype(index_const_ref), decltype(i)>{})
             f(index_const_ref, i);
         else
             f(index_const_ref);
+        // Advance the indices like an odometer instead of recomputing them from i
+        for(std::size_t j = indices.size(); j > 0; j--)
+        {
+            if(++indices[j - 1] < lens[j - 1])
+                break;
+            indices[j - 1] = 0;
+        }
     }
 }
 
+namespace detail {
+
+/**
+ * The offsets of the elements of shapes that have the same lens. Dimensions are collapsed with
+ * reduce_dims first, the outer dimensions are advanced like an odometer, and the innermost
+ * dimension is walked by adding the strides, with a specialization for when all of the inner
+ * strides are one.
+ */
+template <std::size_t N>
+struct shape_offsets
+{
+    static_assert(N > 0, "shape_offsets needs at least one shape");
+
+    explicit shape_offsets(const shape (&shapes)[N])
+    {
+        assert(std::all_of(shapes, shapes + N, [&](const shape& s) {
+            return s.lens() == shapes[0].lens();
+        }));
+        if(shapes[0].lens().empty() or shapes[0].elements() == 0)
+            return;
+        reduced = reduce_dims(std::vector<shape>(shapes, shapes + N));
+        n       = reduced.front().elements();
+    }
+
+    std::size_t elements() const { return n; }
+
+    // Calls f with the offsets of the elements from first to last in the order of the indices.
+    // The offsets of the first element are computed from its index, so any range can be started
+    // on its own.
+    template <class F>
+    void for_each(std::size_t first, std::size_t last, F f) const
+    {
+        if(first >= last)
+            return;
+        assert(last <= n);
+        const auto& lens = reduced.front().lens();
+        const auto ndim  = lens.size();
+
+        std::array<const std::size_t*, N> strides;
+        std::array<std::size_t, N> inner;
+        std::transform(reduced.begin(), reduced.end(), strides.begin(), [](const shape& s) {
+            return s.strides().data();
+        });
+        std::transform(strides.begin(), strides.end(), inner.begin(), [&](const std::size_t* st) {
+            return st[ndim - 1];
+        });
+        const bool unit_stride =
+            std::all_of(inner.begin(), inner.end(), [](auto x) { return x == 1; });
+        const auto inner_len = lens.back();
+
+        std::array<std::size_t, N> offsets{};
+        std::vector<std::size_t> indices(ndim - 1);
+        auto j   = first % inner_len;
+        auto row = first / inner_len;
+        for(std::size_t d = indices.size(); d > 0; d--)
+        {
+            indices[d - 1] = row % lens[d - 1];
+            row /= lens[d - 1];
+            for(std::size_t k = 0; k < N; k++)
+                offsets[k] += indices[d - 1] * strides[k][d - 1];
+        }
+        auto remaining = last - first;
+        for(;;)
+        {
+            auto row_end = std::min(inner_len, j + remaining);
+            remaining -= row_end - j;
+            if(unit_stride)
+            {
+                for(; j < row_end; j++)
+                    sequence_c<N>([&](auto... is) { f((offsets[is] + j)...); });
+            }
+            else
+            {
+                for(; j < row_end; j++)
+                    sequence_c<N>([&](auto... is) { f((offsets[is] + j * inner[is])...); });
+            }
+            if(remaining == 0)
+                return;
+            j = 0;
+            for(std::size_t d = indices.size(); d > 0; d--)
+            {
+                auto& k = indices[d - 1];
+                k++;
+                for(std::size_t m = 0; m < N; m++)
+                    offsets[m] += strides[m][d - 1];
+                if(k < lens[d - 1])
+                    break;
+                for(std::size_t m = 0; m < N; m++)
+                    offsets[m] -= k * strides[m][d - 1];
+                k = 0;
+            }
+        }
+    }
+
+    private:
+    std::vector<shape> reduced;
+    std::size_t n = 0;
+};
+
+} // namespace detail
+
+/**
+ * Iterates over the elements of shapes that have the same lens, calling the function with the
+ * offset of the element in each shape.
+ */
+template <std::size_t N, class F>
+void shape_for_each_offset(const shape (&shapes)[N], F f)
+{
+    detail::shape_offsets<N> offsets{shapes};
+    offsets.for_each(0, offsets.elements(), f);
+}
+
+/**
+ * Same as shape_for_each_offset, but the elements are split into ranges that are run on the
+ * thread pool, so the function must be safe to call concurrently for different elements.
+ */
+template <std::size_t N, class F>
+void par_shape_for_each_offset(const shape (&shapes)[N], F f)
+{
+    // Enough elements for each thread to outweigh the cost of starting the range
+    const std::size_t min_grain = 4096;
+    detail::shape_offsets<N> offsets{shapes};
+    const auto n          = offsets.elements();
+    const auto threadsize = std::min<std::size_t>(get_num_threads(), n / min_grain);
+    if(threadsize <= 1)
+    {
+        offsets.for_each(0, n, f);
+        return;
+    }
+    parallel_range_for(n, threadsize, [&](std::size_t start, std::size_t last, std::size_t) {
+        offsets.for_each(start, last, f);
+    });
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_SLAB_ALLOCATOR_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_SLAB_ALLOCATOR_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct slab_arena_impl;
+
+/**
+ * Allocates fixed size blocks from large chunks of memory. Each block size has its own pool,
+ * freed blocks are reused and the chunks are only released when the arena is destroyed. This
+ * keeps objects that are allocated together close in memory, and avoids a call to the global
+ * allocator for every object.
+ */
+struct MIGRAPHX_EXPORT slab_arena
+{
+    slab_arena();
+    slab_arena(const slab_arena&)            = delete;
+    slab_arena& operator=(const slab_arena&) = delete;
+    ~slab_arena();
+
+    void* allocate(std::size_t size);
+    void deallocate(void* p, std::size_t size);
+
+    /// Bytes reserved for all the chunks
+    std::size_t reserved() const;
+
+    private:
+    std::unique_ptr<slab_arena_impl> impl;
+};
+
+/// Allocator that allocates single objects from a shared slab_arena. Copies of the allocator use
+/// the same arena, and it falls back to the global allocator for arrays.
+template <class T>
+struct slab_allocator
+{
+    using value_type = T;
+    // A container keeps its own arena when it is copy assigned to, and takes the other arena
+    // when it is move assigned to
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    slab_allocator() : arena(std::make_shared<slab_arena>()) {}
+
+    // Moving is a copy so a moved from container still has a usable arena
+    slab_allocator(const slab_allocator&)            = default;
+    slab_allocator& operator=(const slab_allocator&) = default;
+
+    template <class U>
+    slab_allocator(const slab_allocator<U>& other) : arena(other.get_arena())
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned type");
+        if(n != 1)
+            return std::allocator<T>{}.allocate(n);
+        return static_cast<T*>(arena->allocate(sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if(n != 1)
+            return std::allocator<T>{}.deallocate(p, n);
+        arena->deallocate(p, sizeof(T));
+    }
+
+    const std::shared_ptr<slab_arena>& get_arena() const { return arena; }
+
+    template <class U>
+    friend bool operator==(const slab_allocator& x, const slab_allocator<U>& y)
+    {
+        return x.arena == y.get_arena();
+    }
+
+    template <class U>
+    friend bool operator!=(const slab_allocator& x, const slab_allocator<U>& y)
+    {
+        return not(x == y);
+    }
+
+    private:
+    std::shared_ptr<slab_arena> arena;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_SLAB_ALLOCATOR_HPP
@@ -0,0 +1,96 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_SPECIALIZATION_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_SPECIALIZATION_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <memory>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct specialization_options
+{
+    /// Boundaries that a dynamic dimension is rounded up to, so that one compiled program serves
+    /// a range of sizes. Inputs are zero padded up to the boundary and the outputs are returned at
+    /// the padded size. Sizes above the last boundary, or all sizes when empty, are compiled
+    /// exactly.
+    std::vector<std::size_t> buckets = {};
+    /// Maximum number of compiled programs kept, 0 for no limit
+    std::size_t max_entries = 0;
+    /// Maximum estimated memory of the compiled programs kept, 0 for no limit
+    std::size_t max_bytes = 0;
+};
+
+struct specialization_stats
+{
+    std::size_t hits      = 0;
+    std::size_t misses    = 0;
+    std::size_t evictions = 0;
+    /// Total time spent compiling specializations in milliseconds
+    double compile_time = 0;
+};
+
+struct specialization_cache_impl;
+
+/**
+ * @brief Lazily compiles a program with dynamic input shapes for the concrete shapes it is run
+ * with
+ *
+ * The first evaluation with a new set of input shapes compiles a copy of the program with its
+ * dynamic parameters replaced by those static shapes. Later evaluations with the same shapes
+ * are dispatched to it by a hash lookup. The least recently used programs are evicted once the
+ * limits in the options are exceeded. Like a program, a cache must only be used by one thread at
+ * a time.
+ */
+struct MIGRAPHX_EXPORT specialization_cache
+{
+    specialization_cache(program p,
+                         target t,
+                         compile_options options           = compile_options{},
+                         specialization_options sp_options = specialization_options{});
+
+    std::vector<argument> eval(parameter_map params);
+
+    /// Returns the compiled program for the shapes of params, compiling it if needed
+    const program& get_program(const parameter_map& params);
+
+    specialization_stats get_stats() const;
+
+    /// Number of compiled programs currently kept
+    std::size_t size() const;
+
+    private:
+    std::shared_ptr<specialization_cache_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHLIB_SPECIALIZATION_CACHE_HPP
@@ -55,7 +55,9 @@ struct tensor_view
     using const_iterator =
         basic_iota_iterator<tensor_view_iterator_read<const tensor_view<T>>, std::size_t>;
     tensor_view() : m_data(nullptr) {}
-    tensor_view(shape s, T* d) : m_data(d), m_shape(std::move(s)) {}
+    tensor_view(shape s, T* d) : m_data(d), m_shape(std::move(s)), m_standard(m_shape.standard())
+    {
+    }
 
     const shape& get_shape() const { return this->m_shape; }
 
@@ -102,13 +104,13 @@ struct tensor_view
     T& operator[](std::size_t i)
     {
         assert(not this->empty() && i < this->size());
-        return m_data[m_shape.index(i)];
+        return m_data[this->index(i)];
     }
 
     const T& operator[](std::size_t i) const
     {
         assert(not this->empty() && i < this->size());
-        return m_data[m_shape.index(i)];
+        return m_data[this->index(i)];
     }
 
     template <class Range>
@@ -138,13 +140,13 @@ struct tensor_view
     T& back()
     {
         assert(not this->empty());
-        return m_data[m_shape.index(this->size() - 1)];
+        return m_data[this->index(this->size() - 1)];
     }
 
     const T& back() const
     {
         assert(not this->empty());
-        return m_data[m_shape.index(this->size() - 1)];
+        return m_data[this->index(this->size() - 1)];
     }
 
     iterator begin() { return {0, {this}}; }
@@ -168,15 +170,19 @@ struct tensor_view
             os << as_number(x.front());
             for(std::size_t i = 1; i < x.m_shape.elements(); i++)
             {
-                os << ", " << as_number(x.m_data[x.m_shape.index(i)]);
+                os << ", " << as_number(x.m_data[x.index(i)]);
             }
         }
         return os;
     }
 
     private:
+    // Standard shapes map element i to offset i, so skip the call into shape::index
+    std::size_t index(std::size_t i) const { return m_standard ? i : m_shape.index(i); }
+
     T* m_data;
     shape m_shape;
+    bool m_standard = false;
 };
 
 template <class T, class U>
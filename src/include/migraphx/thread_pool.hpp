@@ -0,0 +1,59 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <functional>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Number of threads used for host parallelism, including the calling thread. This defaults to
+/// the hardware concurrency and can be overridden with the MIGRAPHX_NUM_THREADS env variable.
+MIGRAPHX_EXPORT std::size_t get_num_threads();
+
+/// Set the number of threads used for host parallelism. Passing 0 restores the default. This
+/// should not be called while parallel work is running on another thread.
+MIGRAPHX_EXPORT void set_num_threads(std::size_t n);
+
+/// Returns true when called from inside a parallel_range_for region
+MIGRAPHX_EXPORT bool in_parallel_region();
+
+/// Split the range [0, n) between threadsize participants on the process-wide thread pool.
+/// The calling thread takes part in the work, and idle participants steal half of the
+/// remaining work from busy ones. The function is called with a subrange [start, last) and
+/// the participant id which is always less than threadsize. Nested calls from inside a
+/// parallel region run serially on the calling thread. The first exception thrown is
+/// rethrown on the calling thread.
+MIGRAPHX_EXPORT void
+parallel_range_for(std::size_t n,
+                   std::size_t threadsize,
+                   const std::function<void(std::size_t, std::size_t, std::size_t)>& f);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
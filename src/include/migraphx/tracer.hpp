@@ -24,7 +24,10 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_TRACER_HPP
 #define MIGRAPHX_GUARD_RTGLIB_TRACER_HPP
 
+#include <chrono>
+#include <functional>
 #include <ostream>
+#include <string>
 #include <migraphx/functional.hpp>
 #include <migraphx/config.hpp>
 
@@ -33,12 +36,41 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 struct tracer
 {
+    using clock = std::chrono::steady_clock;
+    // Called with the pass name, the module it ran on (empty for program passes) and the time
+    // the pass started and stopped
+    using pass_timer = std::function<void(
+        const std::string&, const std::string&, clock::time_point, clock::time_point)>;
+
     tracer() {}
 
     tracer(std::ostream& s) : os(&s) {}
 
+    tracer(std::ostream& s, pass_timer t) : os(&s), timer(std::move(t)) {}
+
+    tracer(pass_timer t) : timer(std::move(t)) {}
+
     bool enabled() const { return os != nullptr; }
 
+    bool timed() const { return timer != nullptr; }
+
+    // Returns a copy that prints to s and keeps the pass timer
+    tracer with_stream(std::ostream& s) const
+    {
+        tracer result = *this;
+        result.os     = &s;
+        return result;
+    }
+
+    void time_pass(const std::string& pass,
+                   const std::string& mod,
+                   clock::time_point start,
+                   clock::time_point stop) const
+    {
+        if(timer)
+            timer(pass, mod, start, stop);
+    }
+
     template <class... Ts>
     void operator()(const Ts&... xs) const
     {
@@ -51,6 +83,7 @@ struct tracer
 
     private:
     std::ostream* os = nullptr;
+    pass_timer timer = nullptr;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
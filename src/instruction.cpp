@@ -27,7 +27,9 @@
 #include <migraphx/module.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/output_iterator.hpp>
+#include <migraphx/functional.hpp>
 #include <queue>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -76,6 +78,7 @@ void instruction::replace(const shape& r)
     if(r != result)
     {
         result = r;
+        update_version();
         if(output.empty())
         {
             return;
@@ -95,6 +98,7 @@ void instruction::replace(const shape& r)
             if(new_r != ins->result)
             {
                 ins->result = new_r;
+                ins->update_version();
                 std::copy(ins->output.begin(), ins->output.end(), migraphx::push_inserter(q));
             }
         }
@@ -105,6 +109,7 @@ void instruction::replace(operation o)
 {
     normalized = false;
     op         = std::move(o);
+    update_version();
     recompute_shape();
 }
 
@@ -118,6 +123,7 @@ void instruction::clear_arguments()
     }
     arguments.clear();
     module_args.clear();
+    update_version();
 }
 
 bool operator==(const instruction& i, instruction_ref ref)
@@ -260,6 +266,7 @@ void instruction::replace(operation o, const shape& r, std::vector<instruction_r
 {
     normalized = false;
     op         = std::move(o);
+    update_version();
     replace(r);
     replace(std::move(args));
 }
@@ -270,6 +277,7 @@ void instruction::replace(operation o,
                           std::vector<module_ref> mdl_args)
 {
     op = std::move(o);
+    update_version();
     replace(r);
     replace(std::move(args), std::move(mdl_args));
 }
@@ -319,12 +327,14 @@ void instruction::replace_argument(instruction_ref old, instruction_ref new_ins)
     assert(std::any_of(arguments.begin(), arguments.end(), equal_to(old)));
     std::replace_if(arguments.begin(), arguments.end(), equal_to(old), new_ins);
     old->remove_output(*this);
+    update_version();
 }
 
 void instruction::replace_mod_argument(module_ref old, module_ref new_mod)
 {
     assert(std::any_of(module_args.begin(), module_args.end(), [&](auto i) { return i == old; }));
     std::replace(module_args.begin(), module_args.end(), old, new_mod);
+    update_version();
 }
 
 bool instruction::is_undefined() const
@@ -347,19 +357,22 @@ bool instruction::is_undefined() const
 
 bool instruction::can_eval() const
 {
-    if(op.name() == "@literal")
-    {
-        return true;
-    }
-    else if(is_context_free(op))
-    {
-        return std::all_of(
-            this->inputs().begin(), this->inputs().end(), [](auto arg) { return arg->can_eval(); });
-    }
-    else
-    {
-        return false;
-    }
+    // Memoize the result for shared inputs so that DAGs are not visited once per path
+    std::unordered_map<const instruction*, bool> visited;
+    return fix<bool>([&](auto self, const instruction* ins) -> bool {
+        if(ins->op.name() == "@literal")
+            return true;
+        if(not is_context_free(ins->op))
+            return false;
+        auto it = visited.find(ins);
+        if(it != visited.end())
+            return it->second;
+        bool result = std::all_of(ins->inputs().begin(), ins->inputs().end(), [&](auto arg) {
+            return self(as_address(arg));
+        });
+        visited.emplace(ins, result);
+        return result;
+    })(this);
 }
 
 argument instruction::eval(bool check_eval) const
@@ -372,12 +385,44 @@ argument instruction::eval(bool check_eval) const
     {
         if(check_eval and not this->can_eval())
             return {};
-        std::vector<argument> args;
-        std::transform(this->inputs().begin(),
-                       this->inputs().end(),
-                       std::back_inserter(args),
-                       [](auto arg) { return arg->eval(false); });
-        return normalized_operator().compute(result, args);
+        // Count the uses of every input, so that only the results of inputs that are used more
+        // than once are kept, and only until their last use
+        std::unordered_map<const instruction*, std::size_t> uses;
+        fix([&](auto self, const instruction* ins) {
+            if(not is_context_free(ins->op))
+                return;
+            for(auto arg : ins->inputs())
+            {
+                if(uses[as_address(arg)]++ == 0)
+                    self(as_address(arg));
+            }
+        })(this);
+        std::unordered_map<const instruction*, argument> results;
+        return fix<argument>([&](auto self, const instruction* ins) -> argument {
+            if(ins->op.name() == "@literal")
+                return ins->get_literal().get_argument();
+            if(not is_context_free(ins->op))
+                return {};
+            std::size_t remaining = ins == this ? 0 : --uses.at(ins);
+            auto it               = results.find(ins);
+            if(it != results.end())
+            {
+                if(remaining > 0)
+                    return it->second;
+                argument result = it->second;
+                results.erase(it);
+                return result;
+            }
+            std::vector<argument> args;
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(args),
+                           [&](auto arg) { return self(as_address(arg)); });
+            auto result = ins->normalized_operator().compute(ins->result, args);
+            if(remaining > 0)
+                results.emplace(ins, result);
+            return result;
+        })(this);
     }
     return {};
 }
@@ -478,7 +523,11 @@ instruction_ref instruction::get_output_alias(instruction_ref ins, bool shallow)
     return get_output_alias(ins->inputs().at(i));
 }
 
-void instruction::set_normalized(bool value) { normalized = value; }
+void instruction::set_normalized(bool value)
+{
+    normalized = value;
+    update_version();
+}
 
 bool instruction::is_normalized() const { return normalized; }
 
@@ -500,7 +549,11 @@ operation instruction::normalized_operator() const
 }
 std::size_t instruction::get_target_id() const { return target_id; }
 
-void instruction::set_target_id(std::size_t tid) { this->target_id = tid; }
+void instruction::set_target_id(std::size_t tid)
+{
+    this->target_id = tid;
+    update_version();
+}
 
 std::vector<shape> to_shapes(const std::vector<instruction_ref>& args)
 {
@@ -26,13 +26,156 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/msgpack.hpp>
+#include <migraphx/serialize.hpp>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// The "mmap" format is a header, the msgpack of the program with the literal data replaced by
+// offsets, and then the literal data starting at a page-aligned offset. This allows the literals
+// to be used directly from a mapping of the file.
+struct mmap_header
+{
+    char magic[8]               = {'M', 'I', 'G', 'X', 'M', 'M', 'A', 'P'};
+    std::uint64_t version       = 1;
+    std::uint64_t metadata_size = 0;
+    std::uint64_t data_offset   = 0;
+    std::uint64_t data_size     = 0;
+};
+
+constexpr std::size_t mmap_page_alignment    = 4096;
+constexpr std::size_t mmap_literal_alignment = 64;
+
+static std::size_t align_to(std::size_t n, std::size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+// The pieces of a program saved in the mmap format. The literal data is taken out of the value of
+// the program, so the file can be written piece by piece without first assembling a copy of all
+// the literals in one buffer.
+struct mmap_parts
+{
+    mmap_header header;
+    std::vector<char> metadata;
+    // The data of each literal with its offset from the start of the literal data
+    std::vector<std::pair<std::size_t, value::binary>> literals;
+
+    std::size_t size() const { return header.data_offset + header.data_size; }
+
+    // Calls f with consecutive chunks of the file
+    template <class F>
+    void write(F f) const
+    {
+        std::size_t pos     = 0;
+        const auto write_at = [&](std::size_t offset, const char* data, std::size_t n) {
+            assert(offset >= pos);
+            if(offset > pos)
+            {
+                std::vector<char> padding(offset - pos);
+                f(padding.data(), padding.size());
+            }
+            f(data, n);
+            pos = offset + n;
+        };
+        write_at(0, reinterpret_cast<const char*>(&header), sizeof(header));
+        write_at(sizeof(header), metadata.data(), metadata.size());
+        for(const auto& [offset, bytes] : literals)
+        {
+            write_at(header.data_offset + offset,
+                     reinterpret_cast<const char*>(bytes.data()),
+                     bytes.size());
+        }
+        write_at(size(), nullptr, 0);
+    }
+};
+
+static mmap_parts make_mmap_parts(value& v)
+{
+    mmap_parts result;
+    std::size_t data_size = 0;
+    for(auto& mod : v.at("modules"))
+    {
+        for(auto& node : mod.at("nodes"))
+        {
+            if(not node.contains("literal"))
+                continue;
+            auto& l = node.at("literal");
+            if(not l.contains("data"))
+                continue;
+            auto offset = align_to(data_size, mmap_literal_alignment);
+            result.literals.emplace_back(offset, l.at("data").get_binary());
+            data_size   = offset + result.literals.back().second.size();
+            l["data"]   = value::binary{};
+            l["offset"] = offset;
+        }
+    }
+    result.metadata = to_msgpack(v);
+
+    auto& header         = result.header;
+    header.metadata_size = result.metadata.size();
+    header.data_offset   = align_to(sizeof(header) + header.metadata_size, mmap_page_alignment);
+    header.data_size     = data_size;
+    return result;
+}
+
+static std::vector<char> save_mmap_buffer(value& v)
+{
+    auto parts = make_mmap_parts(v);
+    std::vector<char> buffer;
+    buffer.reserve(parts.size());
+    parts.write(
+        [&](const char* data, std::size_t n) { buffer.insert(buffer.end(), data, data + n); });
+    return buffer;
+}
+
+// When owner is null the literals are copied out of the buffer, otherwise they alias the buffer
+// and keep the owner alive
+static program
+load_mmap_buffer(const char* buffer, std::size_t size, const std::shared_ptr<const char>& owner)
+{
+    mmap_header header;
+    const mmap_header expected;
+    if(size < sizeof(header))
+        MIGRAPHX_THROW("Buffer is too small for the mmap format");
+    std::memcpy(&header, buffer, sizeof(header));
+    if(not std::equal(std::begin(header.magic), std::end(header.magic), expected.magic))
+        MIGRAPHX_THROW("Invalid header for the mmap format");
+    if(header.version != expected.version)
+        MIGRAPHX_THROW("Unsupported mmap format version: " + std::to_string(header.version));
+    if(header.metadata_size > size - sizeof(header) or header.data_offset > size or
+       header.data_size > size - header.data_offset)
+        MIGRAPHX_THROW("Truncated buffer for the mmap format");
+
+    const char* data = buffer + header.data_offset;
+    program p;
+    p.from_value(from_msgpack(buffer + sizeof(header), header.metadata_size),
+                 [&](const value& lv) {
+                     if(not lv.contains("offset"))
+                         return migraphx::from_value<literal>(lv);
+                     auto s      = migraphx::from_value<shape>(lv.at("shape"));
+                     auto offset = lv.at("offset").to<std::size_t>();
+                     if(offset > header.data_size or s.bytes() > header.data_size - offset)
+                         MIGRAPHX_THROW("Literal is out of bounds of the mmap data");
+                     if(owner == nullptr)
+                         return literal{s, data + offset};
+                     return literal{s, std::shared_ptr<const char>{owner, data + offset}};
+                 });
+    return p;
+}
+
 program load(const std::string& filename, const file_options& options)
 {
+    if(options.format == "mmap")
+    {
+        auto mb = map_buffer(filename);
+        return load_mmap_buffer(mb.data.get(), mb.size, mb.data);
+    }
     return load_buffer(read_buffer(filename), options);
 }
 program load_buffer(const std::vector<char>& buffer, const file_options& options)
@@ -50,6 +193,10 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     {
         p.from_value(from_json_string(buffer, size));
     }
+    else if(options.format == "mmap")
+    {
+        p = load_mmap_buffer(buffer, size, nullptr);
+    }
     else
     {
         MIGRAPHX_THROW("Unknown format: " + options.format);
@@ -57,11 +204,6 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     return p;
 }
 
-void save(const program& p, const std::string& filename, const file_options& options)
-{
-    write_buffer(filename, save_buffer(p, options));
-}
-
 // MIOpen doesn't support serializing fusion plans with Find-2.0 APIs
 void print_miopen_warning(const program& p)
 {
@@ -80,6 +222,20 @@ void print_miopen_warning(const program& p)
     }
 }
 
+void save(const program& p, const std::string& filename, const file_options& options)
+{
+    if(options.format == "mmap")
+    {
+        value v = p.to_value();
+        print_miopen_warning(p);
+        auto parts = make_mmap_parts(v);
+        std::ofstream os(filename, std::ios::out | std::ios::binary);
+        parts.write([&](const char* data, std::size_t n) { os.write(data, n); });
+        return;
+    }
+    write_buffer(filename, save_buffer(p, options));
+}
+
 std::vector<char> save_buffer(const program& p, const file_options& options)
 {
     value v = p.to_value();
@@ -94,6 +250,10 @@ std::vector<char> save_buffer(const program& p, const file_options& options)
         std::string s = to_json_string(v);
         buffer        = std::vector<char>(s.begin(), s.end());
     }
+    else if(options.format == "mmap")
+    {
+        buffer = save_mmap_buffer(v);
+    }
     else
     {
         MIGRAPHX_THROW("Unknown format: " + options.format);
@@ -0,0 +1,71 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/matcher.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace match {
+
+matcher_dispatch::matcher_dispatch(const std::vector<std::vector<std::string>>& root_names)
+{
+    for(std::size_t i = 0; i < root_names.size(); i++)
+    {
+        if(root_names[i].empty())
+        {
+            unrestricted.push_back(i);
+            continue;
+        }
+        for(const auto& name : root_names[i])
+        {
+            auto& indices = table[name];
+            if(indices.empty() or indices.back() != i)
+                indices.push_back(i);
+        }
+    }
+    // Unrestricted matchers apply to every name, so merge them in keeping the original order
+    for(auto& p : table)
+    {
+        std::vector<std::size_t> indices;
+        std::merge(p.second.begin(),
+                   p.second.end(),
+                   unrestricted.begin(),
+                   unrestricted.end(),
+                   std::back_inserter(indices));
+        p.second = std::move(indices);
+    }
+}
+
+const std::vector<std::size_t>& matcher_dispatch::get(const std::string& name) const
+{
+    auto it = table.find(name);
+    if(it == table.end())
+        return unrestricted;
+    return it->second;
+}
+
+} // namespace match
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -25,338 +25,284 @@
 #include <migraphx/module.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
-#include <migraphx/liveness.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/functional.hpp>
 #include <migraphx/algorithm.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/stringutils.hpp>
-#include <unordered_set>
 #include <unordered_map>
+#include <iostream>
+#include <limits>
 #include <map>
-#include <set>
+#include <numeric>
+#include <tuple>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DEBUG_MEMORY_COLORING);
 
-using instruction_set     = std::unordered_set<instruction_ref>;
-using instruction_set_map = std::unordered_map<instruction_ref, instruction_set>;
-
-// This will build the conflict table or interference graph. This is
-// essentially a map from one instruction to a set of instruction that are
-// used together. Each instruction will be the allocation instruction.
-instruction_set_map build_conflict_table(const module& m, std::string allocation_op)
+// The interval of instructions where an allocation is live, and the segment of memory assigned to
+// it. The segment is measured in units of the alignment.
+struct allocation_interval
 {
-    instruction_set_map conflict_table;
-    liveness(m, [&](auto ins, auto live_set) {
-        // Skip variables that aren't allocations
-        if(ins->name() != allocation_op)
-            return;
-        // Skip zero allocations
-        if(ins->get_shape().bytes() == 0)
-            return;
-        conflict_table[ins];
-        for(auto i : live_set)
-        {
-            if(i == ins)
-                continue;
-            // Skip variables that aren't allocations
-            if(i->name() != allocation_op)
-                continue;
-            // Skip zero allocations
-            if(i->get_shape().bytes() == 0)
-                continue;
-            conflict_table[i].insert(ins);
-            conflict_table[ins].insert(i);
-        }
-    });
-    assert(std::all_of(conflict_table.begin(), conflict_table.end(), [](auto&& pp) {
-        return pp.second.count(pp.first) == 0;
-    }));
-    return conflict_table;
-}
+    instruction_ref ins;
+    // Position of the allocation
+    std::size_t first = 0;
+    // Position of the last instruction using the allocation, directly or through an alias
+    std::size_t last   = 0;
+    std::size_t size   = 0;
+    std::size_t offset = 0;
+
+    bool is_overlap(const allocation_interval& x) const
+    {
+        return std::max(offset, x.offset) < std::min(offset + size, x.offset + x.size);
+    }
+};
 
-// Check if intervals overlap
-bool is_overlap(std::pair<std::size_t, std::size_t> x, std::pair<std::size_t, std::size_t> y)
+static std::size_t max_type_size(const shape& s)
 {
-    return std::max(x.first, y.first) < std::min(x.second, y.second);
+    return std::accumulate(
+        s.sub_shapes().begin(),
+        s.sub_shapes().end(),
+        s.type_size(),
+        [](auto size, const auto& sub) { return std::max(size, max_type_size(sub)); });
 }
 
-struct allocation_segment
+static std::size_t compute_alignment(instruction_ref ins)
 {
-    using segment = std::pair<std::size_t, std::size_t>;
-    std::unordered_map<instruction_ref, segment> ins2segment;
-
-    const segment* add_segment(instruction_ref ins, segment s) { return &(ins2segment[ins] = s); }
-
-    const segment* get_segment(instruction_ref ins) const
+    auto alignment = max_type_size(ins->get_shape());
+    // A rough estimate for the total number of elements
+    auto n = ins->get_shape().bytes() / alignment;
+    // Check for vectorized alignment
+    if(n > 4)
     {
-        auto it = ins2segment.find(ins);
-        if(it == ins2segment.end())
-            return nullptr;
-        return &it->second;
+        auto d = n % 4;
+        if(d == 0)
+            alignment *= 4;
+        if(d == 2)
+            alignment *= 2;
     }
+    return alignment;
+}
 
-    // Remove segment for an instruction
-    void remove(instruction_ref ins)
+static std::size_t find_max_alignment(const module& m, const std::string& allocation_op)
+{
+    std::size_t alignment = 1;
+    for(auto ins : iterator_for(m))
     {
-        auto it = ins2segment.find(ins);
-        if(it != ins2segment.end())
-        {
-            ins2segment.erase(it);
-        }
+        if(ins->name() != allocation_op)
+            continue;
+        alignment = std::max(compute_alignment(ins), alignment);
     }
+    return alignment;
+}
 
-    std::size_t max()
+// Compute the live intervals of the allocations, this follows the same rules as `liveness`.
+// Allocations of zero bytes or that are never used are skipped.
+static std::vector<allocation_interval>
+build_intervals(const module& m, const std::string& allocation_op, std::size_t alignment)
+{
+    auto implicit_deps = m.calc_implicit_deps();
+    std::unordered_map<instruction_ref, std::size_t> index;
+    std::vector<allocation_interval> result;
+    std::size_t pos = 0;
+    for(auto ins : iterator_for(m))
     {
-        std::size_t n = 0;
-        for(auto&& pp : ins2segment)
+        auto update_last = [&](const auto& inputs) {
+            for(auto input : inputs)
+            {
+                auto it = index.find(instruction::get_output_alias(input));
+                if(it == index.end())
+                    continue;
+                result[it->second].last = pos;
+            }
+        };
+        update_last(ins->inputs());
+        update_last(implicit_deps[ins]);
+        auto bytes = ins->get_shape().bytes();
+        if(ins->name() == allocation_op and bytes > 0)
         {
-            auto seg = pp.second;
-            n        = std::max(n, seg.second);
+            index[ins] = result.size();
+            allocation_interval a;
+            a.ins   = ins;
+            a.first = pos;
+            a.last  = pos;
+            a.size  = 1 + (bytes - 1) / alignment;
+            result.push_back(a);
         }
-        return n;
-    }
-
-    template <class Iterator>
-    static bool overlaps(Iterator first, Iterator last, const segment& s)
-    {
-        return std::any_of(first, last, [&](auto&& t) { return is_overlap(s, t); });
+        pos++;
     }
+    result.erase(std::remove_if(result.begin(),
+                                result.end(),
+                                [](const auto& a) { return a.last == a.first; }),
+                 result.end());
+    return result;
+}
 
-    static bool overlaps(const std::set<segment>& segments, const segment& s)
-    {
-        return overlaps(segments.begin(), segments.end(), s);
-    }
+// Finds the allocations that are already placed and are live at the same time as another
+// allocation. A segment tree over the positions answers which placed intervals contain the first
+// position, and the remaining ones are the placed intervals that start inside the interval.
+struct placed_intervals
+{
+    std::size_t npositions = 0;
+    std::vector<std::vector<std::size_t>> tree;
+    std::map<std::size_t, std::size_t> starts;
 
-    static auto find_gap(const std::set<segment>& segments, std::size_t n)
-    {
-        std::size_t max_end = 0;
-        return std::adjacent_find(segments.begin(), segments.end(), [&](segment x, segment y) {
-            if(x.second < max_end)
-                return false;
-            max_end = x.second;
-            if(is_overlap(x, y))
-                return false;
-            assert(y.first >= x.second);
-            auto k = y.first - x.second;
-            return (k >= n);
-        });
-    }
+    explicit placed_intervals(std::size_t n) : npositions(n), tree(2 * n) {}
 
-    static std::size_t max_type_size(const shape& s)
+    void insert(const allocation_interval& a, std::size_t i)
     {
-        return std::accumulate(
-            s.sub_shapes().begin(),
-            s.sub_shapes().end(),
-            s.type_size(),
-            [](auto size, const auto& sub) { return std::max(size, max_type_size(sub)); });
-    }
-
-    static std::size_t compute_alignment(instruction_ref ins)
-    {
-        auto alignment = max_type_size(ins->get_shape());
-        // A rough estimate for the total number of elements
-        auto n = ins->get_shape().bytes() / alignment;
-        // Check for vectorized alignment
-        if(n > 4)
+        starts.emplace(a.first, i);
+        for(auto l = a.first + npositions, r = a.last + npositions + 1; l < r; l /= 2, r /= 2)
         {
-            auto d = n % 4;
-            if(d == 0)
-                alignment *= 4;
-            if(d == 2)
-                alignment *= 2;
+            if(l % 2 == 1)
+                tree[l++].push_back(i);
+            if(r % 2 == 1)
+                tree[--r].push_back(i);
         }
-        return alignment;
     }
 
-    static segment
-    next_segment(std::set<segment>& segments, instruction_ref ins, std::size_t alignment)
+    template <class F>
+    void for_each_live_with(const allocation_interval& a, F f) const
     {
-        assert(ins->get_shape().bytes() > 0);
-        // Compute alignment
-        auto n = 1 + (ins->get_shape().bytes() - 1) / alignment;
-        assert(n > 0);
-        auto start = 0;
-        // Insert at end if it cant fit at the begining
-        if(segments.empty() or segments.begin()->first <= n)
-        {
-            auto it = find_gap(segments, n);
-            if(it == segments.end())
-                it = std::max_element(segments.begin(), segments.end(), [&](segment x, segment y) {
-                    return x.second < y.second;
-                });
-            if(it != segments.end())
-                start = it->second;
-        }
-        auto s = segment{start, start + n};
-        assert(not overlaps(segments, s));
-        segments.insert(s);
-        return s;
+        for(auto p = a.first + npositions; p > 0; p /= 2)
+            std::for_each(tree[p].begin(), tree[p].end(), f);
+        auto first = starts.upper_bound(a.first);
+        auto last  = starts.upper_bound(a.last);
+        std::for_each(first, last, [&](const auto& pp) { f(pp.second); });
     }
+};
 
-    static std::unordered_map<instruction_ref, int>
-    create_allocation_index(const module& m, const instruction_set_map& conflict_table)
-    {
-        std::unordered_map<instruction_ref, int> result;
-        int i = 0;
-        for(auto ins : iterator_for(m))
-        {
-            if(not contains(conflict_table, ins))
-                continue;
-            result[ins] = i++;
-        }
-        return result;
-    }
+// Place the largest allocations first. Each allocation goes into the smallest gap between the
+// placed allocations that are live at the same time, or above all of them if no gap fits.
+static std::size_t plan_offsets(std::vector<allocation_interval>& intervals,
+                                std::size_t npositions)
+{
+    std::vector<std::size_t> order(intervals.size());
+    std::iota(order.begin(), order.end(), 0);
+    // Larger allocations first, then the ones that are live longer, then the earlier ones
+    std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+        const auto& a = intervals[i];
+        const auto& b = intervals[j];
+        return std::make_tuple(b.size, b.last - b.first, a.first) <
+               std::make_tuple(a.size, a.last - a.first, b.first);
+    });
 
-    // Build the allocation_color class from the conflict_table
-    static allocation_segment
-    build(const module& m, const instruction_set_map& conflict_table, std::size_t alignment)
+    placed_intervals placed{npositions};
+    std::vector<std::pair<std::size_t, std::size_t>> segments;
+    std::size_t total = 0;
+    for(auto i : order)
     {
-        allocation_segment as{};
-        std::vector<instruction_ref> conflict_queue;
-        // Add all allocations to the conflict_queue
-        std::transform(conflict_table.begin(),
-                       conflict_table.end(),
-                       std::back_inserter(conflict_queue),
-                       [](auto&& pp) { return pp.first; });
-
-        auto alloc_index = create_allocation_index(m, conflict_table);
-
-        // Sort the conflict queue so we process the allocation with the most
-        // number of adjacent allocations first
-        std::sort(conflict_queue.begin(), conflict_queue.end(), by(std::greater<>{}, [&](auto x) {
-                      return std::make_tuple(
-                          conflict_table.at(x).size(), x->get_shape().bytes(), alloc_index.at(x));
-                  }));
-        // Process the conflict_queue, we refer to the current allocation as
-        // the parent and the adjacent allocations as children
-        for(auto parent : conflict_queue)
-        {
-            // Sort children by size
-            std::vector<instruction_ref> children(conflict_table.at(parent).begin(),
-                                                  conflict_table.at(parent).end());
-            std::sort(children.begin(), children.end(), by(std::less<>{}, [&](auto x) {
-                          return std::make_tuple(x->get_shape().bytes(), alloc_index.at(x));
-                      }));
-            assert(not contains(children, parent));
-            // This set is to track the segments already processed
-            std::set<segment> segments;
-            // Add all segments for the children to the segments already processed
-            transform_if(
-                children.begin(),
-                children.end(),
-                std::inserter(segments, segments.begin()),
-                [&](auto child) { return as.get_segment(child); },
-                [&](auto child) { return *as.get_segment(child); });
-
-            assert(as.get_segment(parent) == nullptr);
-            as.add_segment(parent, next_segment(segments, parent, alignment));
-        }
-        // Reduce the number of segments
-        for(std::size_t n = 0; n < 3; n++)
+        auto& a = intervals[i];
+        segments.clear();
+        placed.for_each_live_with(a, [&](std::size_t j) {
+            const auto& b = intervals[j];
+            segments.emplace_back(b.offset, b.offset + b.size);
+        });
+        std::sort(segments.begin(), segments.end());
+        std::size_t top      = 0;
+        std::size_t best     = 0;
+        std::size_t best_gap = std::numeric_limits<std::size_t>::max();
+        for(const auto& [start, end] : segments)
         {
-            for(auto parent : conflict_queue)
+            if(start > top)
             {
-                auto children = conflict_table.at(parent);
-                // This set is to track the segments already processed
-                std::set<segment> segments;
-                // Add all segments for the children to the segments already processed
-                transform_if(
-                    children.begin(),
-                    children.end(),
-                    std::inserter(segments, segments.begin()),
-                    [&](auto child) { return as.get_segment(child); },
-                    [&](auto child) { return *as.get_segment(child); });
-                // Get the segment for the parent
-                const auto* parent_segment = as.get_segment(parent);
-                assert(parent_segment != nullptr);
-
-                auto s = next_segment(segments, parent, alignment);
-                if(s != *parent_segment and s.second <= as.max())
+                auto gap = start - top;
+                if(gap >= a.size and gap < best_gap)
                 {
-                    as.add_segment(parent, s);
+                    best     = top;
+                    best_gap = gap;
                 }
             }
+            top = std::max(top, end);
         }
-        return as;
+        a.offset = best_gap == std::numeric_limits<std::size_t>::max() ? top : best;
+        placed.insert(a, i);
+        total = std::max(total, a.offset + a.size);
     }
-};
+    return total;
+}
 
-static std::size_t find_max_alignment(const module& m, const std::string& allocation_op)
+// The most memory that is live at the same time, no plan can use less
+static std::size_t max_live_size(const std::vector<allocation_interval>& intervals,
+                                 std::size_t npositions)
 {
-    std::size_t alignment = 1;
-    for(auto ins : iterator_for(m))
+    std::vector<std::ptrdiff_t> diff(npositions + 1);
+    for(const auto& a : intervals)
     {
-        if(ins->name() != allocation_op)
-            continue;
-        alignment = std::max(allocation_segment::compute_alignment(ins), alignment);
+        diff[a.first] += a.size;
+        diff[a.last + 1] -= a.size;
     }
-    return alignment;
+    std::partial_sum(diff.begin(), diff.end(), diff.begin());
+    auto it = std::max_element(diff.begin(), diff.end());
+    return it == diff.end() ? 0 : *it;
 }
 
-void memory_coloring::apply(module& m) const
+// Check that no allocations that are live at the same time overlap in memory
+static void verify_plan(std::vector<allocation_interval> intervals)
 {
-    const std::size_t alignment = find_max_alignment(m, allocation_op);
-    auto conflict_table         = build_conflict_table(m, allocation_op);
-    auto as                     = allocation_segment::build(m, conflict_table, alignment);
+    std::sort(intervals.begin(), intervals.end(), by(std::less<>{}, [](const auto& a) {
+                  return a.first;
+              }));
+    std::multimap<std::size_t, const allocation_interval*> live;
+    for(const auto& a : intervals)
+    {
+        live.erase(live.begin(), live.lower_bound(a.first));
+        for(const auto& pp : live)
+        {
+            if(pp.second->is_overlap(a))
+                MIGRAPHX_THROW("Memory coloring assigned overlapping memory to live allocations");
+        }
+        live.emplace(a.last, &a);
+    }
+}
 
-    // All allocations should have a segment
-    assert(std::all_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
-        return as.get_segment(pp.first);
-    }));
+void memory_coloring::apply(module& m) const
+{
+    const std::size_t alignment  = find_max_alignment(m, allocation_op);
+    const std::size_t npositions = m.size();
+    auto intervals               = build_intervals(m, allocation_op, alignment);
+    auto total                   = plan_offsets(intervals, npositions);
 
-    // Adjacent allocations should not have overlapping segments
-    assert(std::none_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
-        auto* x = as.get_segment(pp.first);
-        return std::any_of(pp.second.begin(), pp.second.end(), [&](auto ins) {
-            auto* y = as.get_segment(ins);
-            assert(x and y);
-            return is_overlap(*x, *y);
-        });
-    }));
+    if(verify)
+        verify_plan(intervals);
 
     // Print out segments
     if(enabled(MIGRAPHX_DEBUG_MEMORY_COLORING{}))
     {
-        for(auto&& pp : conflict_table)
+        for(const auto& a : intervals)
         {
-            std::cout << "------- conflict -------" << std::endl;
-            auto s1 = as.ins2segment.at(pp.first);
-            std::cout << s1.first << ", " << s1.second << ": ";
-            m.debug_print(pp.first);
-            for(auto ins : pp.second)
-            {
-                auto s2 = as.ins2segment.at(ins);
-                std::cout << s2.first << ", " << s2.second << ": ";
-                m.debug_print(ins);
-            }
+            std::cout << "[" << a.first << ", " << a.last << "] " << a.offset * alignment << ", "
+                      << (a.offset + a.size) * alignment << ": ";
+            m.debug_print(a.ins);
         }
+        std::cout << "Memory coloring: " << intervals.size() << " allocations, "
+                  << total * alignment << " bytes planned, "
+                  << max_live_size(intervals, npositions) * alignment << " bytes lower bound"
+                  << std::endl;
     }
 
     // Total memory
-    std::size_t n = as.max() * alignment;
+    std::size_t n = total * alignment;
 
     // Replace allocations
     auto mem = m.add_parameter("scratch", shape{shape::int8_type, {n}});
-    for(auto&& [ins, seg] : as.ins2segment)
+    for(const auto& a : intervals)
     {
-        assert(ins->name() == allocation_op);
-        auto s             = ins->get_shape();
-        std::size_t offset = seg.first * alignment;
+        assert(a.ins->name() == allocation_op);
+        auto s             = a.ins->get_shape();
+        std::size_t offset = a.offset * alignment;
         assert(offset < n);
         m.replace_instruction(
-            ins, make_op("load", {{"shape", to_value(s)}, {"offset", offset}}), mem);
+            a.ins, make_op("load", {{"shape", to_value(s)}, {"offset", offset}}), mem);
     }
 
-    // Replace zero allocation
+    // Replace zero allocations and allocations that are never used
     for(auto ins : iterator_for(m))
     {
         if(ins->name() != allocation_op)
             continue;
-        assert(ins->get_shape().bytes() == 0);
         m.replace_instruction(
             ins, make_op("load", {{"shape", to_value(ins->get_shape())}, {"offset", 0}}), mem);
     }
@@ -54,41 +54,48 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_FINALIZE)
 
 struct module_impl
 {
-    // A list is used to keep references to an instruction stable
-    std::list<instruction> instructions;
-    std::unordered_set<instruction*> instruction_set;
+    // A list is used to keep references to an instruction stable. The instructions are allocated
+    // from the module's arena, and each one records the module it is in.
+    instruction_list instructions;
     std::string name;
     uint32_t nparams = 0;
     bool bypass      = false;
     bit_signal<64> changed{};
+    // Incremented whenever the module or one of its instructions is modified
+    std::size_t version = 0;
+
+    void notify()
+    {
+        changed.notify();
+        version++;
+    }
 
     bool contains(instruction_ref ins) const
     {
         if(is_end(ins, instructions.end()))
             return false;
-        return instruction_set.count(std::addressof(*ins)) > 0;
+        return ins->owner == this;
     }
 
     template <class... Ts>
     instruction_ref emplace(instruction_ref pos, Ts&&... xs)
     {
-        changed.notify();
+        notify();
         // cppcheck-suppress redundantInitialization
-        auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
-        instruction_set.insert(std::addressof(*r));
-        return r;
+        auto result   = instructions.emplace(pos, std::forward<Ts>(xs)...);
+        result->owner = this;
+        return result;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
     {
-        changed.notify();
+        notify();
         return emplace(pos, ins);
     }
 
     void clear()
     {
-        changed.notify();
+        notify();
         instructions.clear();
-        instruction_set.clear();
         nparams = 0;
     }
 
@@ -110,19 +117,32 @@ struct module_impl
 
     instruction_ref erase(instruction_ref pos)
     {
-        changed.notify();
-        instruction_set.erase(std::addressof(*pos));
+        notify();
+        pos->owner = nullptr;
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
-        changed.notify();
-        std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        notify();
+        std::for_each(start, last, [](instruction& ins) { ins.owner = nullptr; });
         return instructions.erase(start, last);
     }
+
+    void assign(instruction_ref pos, instruction ins)
+    {
+        notify();
+        *pos       = std::move(ins);
+        pos->owner = this;
+    }
 };
 
+void instruction::update_version()
+{
+    if(owner != nullptr)
+        owner->version++;
+}
+
 const operation& get_operation(instruction_ref ins) { return ins->get_operator(); }
 
 module::module(const std::string& name) : impl(std::make_unique<module_impl>())
@@ -140,6 +160,9 @@ module::module(const module& m) { assign(m); }
 module& module::operator=(module m)
 {
     std::swap(m.impl, this->impl);
+    // The version keeps increasing, so that the module is not mistaken for the one it replaced
+    if(m.impl != nullptr and impl != nullptr)
+        impl->version = std::max(impl->version, m.impl->version) + 1;
     return *this;
 }
 
@@ -155,7 +178,9 @@ void module::assign(const module& m)
     // copy the impl
     if(not impl)
         impl = std::make_unique<module_impl>();
-    *impl = *m.impl;
+    auto version  = impl->version;
+    *impl         = *m.impl;
+    impl->version = std::max(version, m.impl->version) + 1;
 
     // clear instructions
     if(not impl->instructions.empty())
@@ -327,7 +352,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
                                             const operation& op,
                                             std::vector<instruction_ref> args) MIGRAPHX_TIDY_CONST
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(ins));
     assert(not starts_with(op.name(), "@"));
 
@@ -342,7 +367,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
                                             std::vector<instruction_ref> args,
                                             std::vector<module_ref> module_args) MIGRAPHX_TIDY_CONST
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(ins));
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
@@ -353,7 +378,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
 instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref rep)
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(ins));
     assert(ins != rep);
 
@@ -412,7 +437,7 @@ instruction_ref module::remove_instructions(instruction_ref first, instruction_r
 
 instruction_ref module::move_instruction(instruction_ref src, instruction_ref dst)
 {
-    impl->changed.notify();
+    impl->notify();
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
@@ -539,7 +564,7 @@ instruction_ref module::insert_parameter(instruction_ref ins, std::string name,
 
 instruction_ref module::replace_return(std::vector<instruction_ref> args)
 {
-    impl->changed.notify();
+    impl->notify();
     auto last = std::prev(this->end());
     // If there is no return then add a return
     if(last->name() != "@return")
@@ -622,12 +647,11 @@ std::vector<instruction_ref> module::get_parameters() const
 
 void module::rename_parameter(instruction_ref ins, const std::string& name)
 {
-    impl->changed.notify();
     assert(ins->name() == "@param");
     auto op      = any_cast<builtin::param>(ins->get_operator());
     op.parameter = name;
     auto outputs = ins->outputs();
-    *ins         = instruction{op, ins->get_shape(), {}};
+    impl->assign(ins, {op, ins->get_shape(), {}});
     for(auto output : outputs)
         ins->add_output(output);
 }
@@ -649,6 +673,7 @@ std::unordered_map<std::string, shape> module::get_parameter_shapes() const
 bool module::has_instruction(instruction_ref ins) const { return impl->contains(ins); }
 
 std::size_t module::size() const { return impl->instructions.size(); }
+std::size_t module::get_version() const { return impl->version; }
 instruction_ref module::begin() const { return impl->instructions.begin(); }
 instruction_ref module::end() const { return impl->instructions.end(); }
 
@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
+#include <migraphx/file_buffer.hpp>
 #include <migraphx/program.hpp>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
@@ -107,6 +108,8 @@ struct onnx_parser
     int64_t opset_version        = 13;
 
     std::unordered_map<std::string, op_func> ops;
+    // External data files are mapped once per parse and shared by the literals aliasing them
+    mutable std::unordered_map<std::string, mapped_buffer> external_files;
 
     onnx_parser();
     operation load(const std::string& name, const node_info& info) const;
@@ -121,6 +124,7 @@ struct onnx_parser
     parse_graph(module* mod, const onnx::GraphProto& graph, bool inlining = false);
     literal parse_value(const onnx::AttributeProto& attr) const;
     literal parse_tensor(const onnx::TensorProto& t) const;
+    const mapped_buffer& map_external_data(const std::string& data_file) const;
     shape parse_type(const onnx::TypeProto& t) const;
     shape parse_type(const onnx::TypeProto& t, const std::vector<std::size_t>& input_dims) const;
 };
@@ -36,6 +36,8 @@
 #include <migraphx/op/unknown.hpp>
 #include <migraphx/float8.hpp>
 #include <migraphx/env.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/time.hpp>
 #include <onnx.pb.h>
 
 namespace migraphx {
@@ -43,6 +45,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 namespace onnx {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_ONNX_PARSER)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIME_ONNX_PARSER)
 
 static shape shape_from_dyn_dims(shape::type_t shape_type,
                                  const std::vector<shape::dynamic_dimension>& dyn_dims)
@@ -85,6 +88,22 @@ create_literal(shape::type_t shape_type, const std::vector<size_t>& dims, const
     return literal{{shape_type, dims}, data};
 }
 
+// Creates a literal that aliases the memory of an external data file instead of copying it.
+// The mapping is kept alive by the literal. Falls back to a copy when the data is not aligned
+// for the element type.
+static literal create_literal(shape::type_t shape_type,
+                              const std::vector<size_t>& dims,
+                              const std::shared_ptr<const char>& owner,
+                              const char* data)
+{
+    auto elem_num =
+        std::accumulate(dims.begin(), dims.end(), std::size_t(1), std::multiplies<std::size_t>());
+    shape s = dims.empty() ? shape{shape_type} : shape{shape_type, dims};
+    if(elem_num == 0 or reinterpret_cast<std::uintptr_t>(data) % s.type_size() != 0)
+        return create_literal(shape_type, dims, data);
+    return literal{s, std::shared_ptr<const char>{owner, data}};
+}
+
 template <class T, MIGRAPHX_REQUIRES(not std::is_pointer<T>{})>
 static literal create_literal(shape::type_t shape_type, const std::vector<size_t>& dims, T data)
 {
@@ -240,6 +259,21 @@ void onnx_parser::parse_undefined(module* mod, const std::string& name)
     }
 }
 
+template <class F>
+static void time_stage(const std::string& name, F f)
+{
+    if(enabled(MIGRAPHX_TIME_ONNX_PARSER{}))
+    {
+        using milliseconds = std::chrono::duration<double, std::milli>;
+        auto ms            = time<milliseconds>(f);
+        std::cout << name << ": " << ms << "ms\n";
+    }
+    else
+    {
+        f();
+    }
+}
+
 void onnx_parser::parse_from(std::istream& is, std::string name)
 {
     auto* mm         = prog.get_main_module();
@@ -249,7 +283,9 @@ void onnx_parser::parse_from(std::istream& is, std::string name)
         this->path = parent_path.string();
 
     onnx::ModelProto model;
-    if(model.ParseFromIstream(&is))
+    bool parsed = false;
+    time_stage("protobuf", [&] { parsed = model.ParseFromIstream(&is); });
+    if(parsed)
     {
         auto version  = get_opset_version(model);
         opset_version = (version == -1) ? opset_version : version;
@@ -269,7 +305,9 @@ void onnx_parser::parse_from(const void* data, std::size_t size)
 {
     auto* mm = prog.get_main_module();
     onnx::ModelProto model;
-    if(model.ParseFromArray(data, size))
+    bool parsed = false;
+    time_stage("protobuf", [&] { parsed = model.ParseFromArray(data, size); });
+    if(parsed)
     {
         auto version  = get_opset_version(model);
         opset_version = (version == -1) ? opset_version : version;
@@ -328,14 +366,25 @@ static bool is_type_packed_int4(const onnx::TensorProto& t)
 std::unordered_map<std::string, instruction_ref>
 parse_intializer(const onnx_parser& parser, module* mod, const onnx::GraphProto& graph)
 {
+    const auto& initializers = graph.initializer();
+    // Map the external data files up front so the tensors can be decoded in parallel
+    for(auto&& f : initializers)
+    {
+        if(not f.external_data().empty())
+            parser.map_external_data(f.external_data().at(0).value());
+    }
+    std::vector<literal> literals(initializers.size());
+    par_for(initializers.size(),
+            [&](auto i) { literals[i] = parser.parse_tensor(initializers[i]); });
+
     std::unordered_map<std::string, instruction_ref> mod_insts;
-    for(auto&& f : graph.initializer())
+    for(auto i : range(initializers.size()))
     {
+        const auto& f = initializers[i];
         if(enabled(MIGRAPHX_TRACE_ONNX_PARSER{}))
             std::cout << "initializer: " << f.name() << std::endl;
         // backup instructions in parent mod
-        auto pt  = parser.parse_tensor(f);
-        auto lit = mod->add_literal(pt);
+        auto lit = mod->add_literal(std::move(literals[i]));
 
         if(is_type_packed_int4(f))
             lit = mod->add_instruction(migraphx::make_op("unpack_int4"), lit);
@@ -393,13 +442,15 @@ parse_inputs(const onnx_parser& parser,
 std::vector<instruction_ref>
 onnx_parser::parse_graph(module* mod, const onnx::GraphProto& graph, bool inlining)
 {
-    std::unordered_map<std::string, instruction_ref> mod_insts =
-        parse_intializer(*this, mod, graph);
+    std::unordered_map<std::string, instruction_ref> mod_insts;
+    time_stage(mod->name() + " initializers",
+               [&] { mod_insts = parse_intializer(*this, mod, graph); });
 
     mod_insts = parse_inputs(*this, mod, graph, mod_insts);
 
     std::copy(mod_insts.begin(), mod_insts.end(), std::inserter(instructions, instructions.end()));
 
+    timer node_timer{};
     for(auto&& node : graph.node())
     {
         if(enabled(MIGRAPHX_TRACE_ONNX_PARSER{}))
@@ -449,6 +500,12 @@ onnx_parser::parse_graph(module* mod, const onnx::GraphProto& graph, bool inlini
         }
     }
 
+    if(enabled(MIGRAPHX_TIME_ONNX_PARSER{}))
+    {
+        using milliseconds = std::chrono::duration<double, std::milli>;
+        std::cout << mod->name() << " nodes: " << node_timer.record<milliseconds>() << "ms\n";
+    }
+
     // Find instructions corresponding to the output
     auto prog_output = graph.output();
     std::vector<std::string> all_output_names;
@@ -540,17 +597,11 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
         {
             nbytes = std::stoull(t.external_data().at(2).value());
         }
-        std::vector<char> raw_buffer;
-        if(not external_data_path.empty())
-        {
-            raw_buffer = read_buffer(fs::path{external_data_path} / data_file, offset, nbytes);
-        }
-        else
-        {
-            raw_buffer = read_buffer(path / data_file, offset, nbytes);
-        }
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        return create_literal(type, dims, s.data());
+        const auto& mb = map_external_data(data_file);
+        if(offset > mb.size or nbytes > mb.size - offset or tensor_shape.bytes() > nbytes)
+            MIGRAPHX_THROW("PARSE_TENSOR: external data for \"" + t.name() +
+                           "\" is out of range of file: " + data_file);
+        return create_literal(type, dims, mb.data, mb.data.get() + offset);
     }
 
     if(t.has_raw_data())
@@ -617,6 +668,15 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     MIGRAPHX_THROW("PARSE_TENSOR: Invalid tensor type");
 }
 
+const mapped_buffer& onnx_parser::map_external_data(const std::string& data_file) const
+{
+    auto it = external_files.find(data_file);
+    if(it != external_files.end())
+        return it->second;
+    fs::path dir = external_data_path.empty() ? path : fs::path{external_data_path};
+    return external_files.emplace(data_file, map_buffer(dir / data_file)).first->second;
+}
+
 shape onnx_parser::parse_type(const onnx::TypeProto& t) const
 {
     shape::type_t shape_type = get_type(t.tensor_type().elem_type());
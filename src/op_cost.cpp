@@ -0,0 +1,81 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/op_cost.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+double op_cost::intensity() const
+{
+    if(bytes == 0)
+        return 0;
+    return flops / bytes;
+}
+
+op_cost& op_cost::operator+=(const op_cost& x)
+{
+    flops += x.flops;
+    bytes += x.bytes;
+    return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const op_cost& x)
+{
+    os << "{flops: " << x.flops << ", bytes: " << x.bytes << "}";
+    return os;
+}
+
+static double bytes_of(const shape& s)
+{
+    if(s.dynamic())
+        return 0;
+    return s.bytes();
+}
+
+op_cost memory_cost(const shape& output, const std::vector<shape>& inputs, double flops)
+{
+    double bytes = std::accumulate(
+        inputs.begin(), inputs.end(), bytes_of(output), [](double acc, const shape& s) {
+            return acc + bytes_of(s);
+        });
+    return {flops, bytes};
+}
+
+op_cost estimate_cost(instruction_ref ins)
+{
+    if(starts_with(ins->name(), "@"))
+        return {};
+    auto inputs = to_shapes(ins->inputs());
+    if(ins->get_shape().dynamic() or
+       any_of(inputs, [](const shape& s) { return s.dynamic(); }))
+        return {};
+    return ins->get_operator().estimate_cost(ins->get_shape(), inputs, ins->module_inputs());
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
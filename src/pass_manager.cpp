@@ -61,7 +61,9 @@ void validate_pass(module& mod, const pass& p, tracer trace)
 void run_pass(program& prog, const pass& p, tracer trace)
 {
     trace("Pass: ", p.name());
+    auto start = tracer::clock::now();
     p.apply(prog);
+    trace.time_pass(p.name(), "", start, tracer::clock::now());
     trace(prog);
 }
 
@@ -129,16 +131,16 @@ struct module_pm : module_pass_manager
         trace("Pass: ", p.name());
         assert(mod);
         assert(mod->validate() == mod->end());
+        auto start = tracer::clock::now();
+        p.apply(*this);
+        auto stop = tracer::clock::now();
         if(enabled(MIGRAPHX_TIME_PASSES{}))
         {
             using milliseconds = std::chrono::duration<double, std::milli>;
-            auto ms            = time<milliseconds>([&] { p.apply(*this); });
+            auto ms            = std::chrono::duration_cast<milliseconds>(stop - start).count();
             std::cout << p.name() << ": " << ms << "ms\n";
         }
-        else
-        {
-            p.apply(*this);
-        }
+        t->time_pass(p.name(), mod->name(), start, stop);
         trace(*mod);
         validate_pass(*mod, p, *t);
     }
@@ -149,7 +151,7 @@ module& get_module(module_pass_manager& mpm) { return mpm.get_module(); }
 void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& passes, tracer trace)
 {
     if(enabled(MIGRAPHX_TRACE_PASSES{}))
-        trace = tracer{std::cout};
+        trace = trace.with_stream(std::cout);
     std::unordered_set<module_ref> visited;
     for(const auto& p : passes)
     {
@@ -184,7 +186,7 @@ void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& pas
 void run_passes(module& mod, const std::vector<pass>& passes, tracer trace)
 {
     if(enabled(MIGRAPHX_TRACE_PASSES{}))
-        trace = tracer{std::cout};
+        trace = trace.with_stream(std::cout);
     for(const auto& p : passes)
     {
         module_pm{&mod, &mod, &trace}.run_pass(p);
@@ -39,6 +39,7 @@
 #include <migraphx/output_iterator.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/supported_segments.hpp>
 
 #include <iostream>
@@ -56,6 +57,8 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_EXECUTION_PLAN)
+
 using milliseconds = std::chrono::duration<double, std::milli>;
 
 struct mark_instruction_target
@@ -69,12 +72,160 @@ struct mark_instruction_target
     }
 };
 
+// A module flattened into an array of steps. Each step writes the slot with the same index and
+// reads its inputs from slots, so evaluating the plan needs no map lookups and the operators are
+// normalized only once when the plan is built.
+struct execution_plan
+{
+    enum class step_kind
+    {
+        literal,
+        param,
+        outline,
+        compute
+    };
+
+    struct step
+    {
+        step_kind kind = step_kind::compute;
+        instruction_ref ins;
+        operation op;
+        argument value;
+        std::string parameter;
+        std::vector<std::size_t> inputs;
+        std::vector<module_ref> module_args;
+    };
+
+    std::vector<step> steps;
+    // Instructions of enclosing modules that are used by this module, and the slot they are
+    // copied into before the steps run
+    std::vector<std::pair<instruction_ref, std::size_t>> externals;
+    // Slot of every instruction, only used to resolve the externals of nested modules
+    std::unordered_map<instruction_ref, std::size_t> slot_map;
+    std::vector<std::size_t> outputs;
+    // Version of the module when the plan was built
+    std::size_t version = 0;
+    std::size_t nslots     = 0;
+    std::size_t max_inputs = 0;
+
+    execution_plan() = default;
+    explicit execution_plan(const module& m)
+    {
+        version = m.get_version();
+        // Number the instructions of the module first, so that instructions from enclosing
+        // modules can be given the slots that follow them
+        for(auto ins : iterator_for(m))
+        {
+            if(ins->name() == "@return")
+                break;
+            slot_map.emplace(ins, slot_map.size());
+        }
+        nslots = slot_map.size();
+        steps.reserve(nslots);
+        for(auto ins : iterator_for(m))
+        {
+            if(ins->name() == "@return")
+            {
+                outputs = get_slots(ins->inputs());
+                break;
+            }
+            step s;
+            s.ins = ins;
+            if(ins->name() == "@literal")
+            {
+                s.kind  = step_kind::literal;
+                s.value = ins->get_literal().get_argument();
+            }
+            else if(ins->name() == "@param")
+            {
+                s.kind      = step_kind::param;
+                s.parameter = any_cast<builtin::param>(ins->get_operator()).parameter;
+            }
+            else if(ins->name() == "@outline")
+            {
+                s.kind = step_kind::outline;
+            }
+            else
+            {
+                s.op          = ins->normalized_operator();
+                s.inputs      = get_slots(ins->inputs());
+                s.module_args = ins->module_inputs();
+                max_inputs    = std::max(max_inputs, s.inputs.size());
+            }
+            steps.push_back(std::move(s));
+        }
+        if(outputs.empty() and not steps.empty())
+            outputs = {steps.size() - 1};
+    }
+
+    // The version of a module changes whenever it or one of its instructions is modified
+    bool is_valid(const module& m) const { return m.get_version() == version; }
+
+    private:
+    std::vector<std::size_t> get_slots(const std::vector<instruction_ref>& inputs)
+    {
+        std::vector<std::size_t> result(inputs.size());
+        std::transform(inputs.begin(), inputs.end(), result.begin(), [&](instruction_ref i) {
+            auto it = slot_map.find(i);
+            if(it != slot_map.end())
+                return it->second;
+            externals.emplace_back(i, nslots);
+            slot_map.emplace(i, nslots);
+            return nslots++;
+        });
+        return result;
+    }
+};
+
+struct execution_plans
+{
+    std::unordered_map<const module*, execution_plan> plans;
+
+    const execution_plan* find(const module* m) const
+    {
+        auto it = plans.find(m);
+        if(it == plans.end())
+            return nullptr;
+        return &it->second;
+    }
+
+    const execution_plan& at(const module* m) const { return plans.at(m); }
+
+    // A compiled program that was modified afterwards falls back to the interpreter
+    bool is_valid() const
+    {
+        return std::all_of(plans.begin(), plans.end(), [](const auto& pp) {
+            return pp.second.is_valid(*pp.first);
+        });
+    }
+};
+
 struct program_impl
 {
     // A map is used to keep references to modules of the program
     std::unordered_map<std::string, module> modules;
     std::vector<context> contexts;
     std::vector<target> targets;
+    // Execution plans are built when the program is finalized
+    execution_plans plans;
+
+    void build_plans()
+    {
+        plans = execution_plans{};
+        if(enabled(MIGRAPHX_DISABLE_EXECUTION_PLAN{}))
+            return;
+        for(const auto& pp : modules)
+            plans.plans.emplace(&pp.second, execution_plan{pp.second});
+    }
+
+    // Checked once for each evaluation, the plans of submodules are then used without checking
+    const execution_plan* get_plan(const module* m) const
+    {
+        const auto* plan = plans.find(m);
+        if(plan == nullptr or not plans.is_valid())
+            return nullptr;
+        return plan;
+    }
 };
 
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
@@ -132,6 +283,10 @@ void program::assign(const program& p)
         for(auto ins : iterator_for(mp.second))
             instruction::replace_refs(ins, ins_map, mod_map);
     }
+
+    // The copied plans still refer to the instructions of the other program
+    if(not impl->plans.plans.empty())
+        impl->build_plans();
 }
 
 shape program::get_parameter_shape(std::string name) const
@@ -172,6 +327,20 @@ context& program::get_context() const
     return impl->contexts.front();
 }
 
+std::vector<context> program::create_contexts() const
+{
+    if(impl->targets.size() != impl->contexts.size())
+        MIGRAPHX_THROW("Contexts can only be created for a program compiled for a single target");
+    std::vector<context> result;
+    result.reserve(impl->targets.size());
+    for(auto i : range(impl->targets.size()))
+    {
+        result.push_back(impl->targets[i].get_context());
+        result.back().from_value(impl->contexts[i].to_value());
+    }
+    return result;
+}
+
 instruction_ref program::validate() const
 {
     const auto* mm = this->get_main_module();
@@ -316,7 +485,7 @@ void program::compile(const target& t, compile_options options)
     this->impl->contexts = {t.get_context()};
 
     if(enabled(MIGRAPHX_TRACE_COMPILE{}))
-        options.trace = tracer{std::cout};
+        options.trace = options.trace.with_stream(std::cout);
 
     options.trace(*this);
     options.trace();
@@ -341,12 +510,14 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->contexts);
     }
+    this->impl->build_plans();
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->contexts);
+    this->impl->build_plans();
 }
 
 template <class T>
@@ -544,21 +715,125 @@ std::vector<argument> generic_eval(const module* mod,
     return {results.at(std::prev(mod->end()))};
 }
 
+struct plan_frame
+{
+    const execution_plan* plan         = nullptr;
+    const std::vector<argument>* slots = nullptr;
+    const plan_frame* parent           = nullptr;
+};
+
+static const argument& find_external(const plan_frame* frame, instruction_ref ins)
+{
+    for(; frame != nullptr; frame = frame->parent)
+    {
+        auto it = frame->plan->slot_map.find(ins);
+        if(it != frame->plan->slot_map.end())
+            return (*frame->slots)[it->second];
+    }
+    MIGRAPHX_THROW("Instruction from an enclosing module has not been evaluated: " + ins->name());
+}
+
+template <class F>
+std::vector<argument> plan_eval(const execution_plans& plans,
+                                const execution_plan& plan,
+                                std::vector<context>& ctx,
+                                const std::unordered_map<std::string, argument>& params,
+                                const plan_frame* parent,
+                                F trace)
+{
+    std::vector<argument> slots(plan.nslots);
+    plan_frame frame{&plan, &slots, parent};
+    for(const auto& [ins, slot] : plan.externals)
+        slots[slot] = find_external(parent, ins);
+
+    auto module_eval = [&](module_ref smod,
+                           const std::unordered_map<std::string, argument>& inputs) {
+        return plan_eval(plans, plans.at(smod), ctx, inputs, &frame, trace);
+    };
+
+    std::vector<argument> values;
+    values.reserve(plan.max_inputs);
+    for(std::size_t i = 0; i < plan.steps.size(); i++)
+    {
+        const auto& step = plan.steps[i];
+        auto ins         = step.ins;
+        switch(step.kind)
+        {
+        case execution_plan::step_kind::literal:
+            slots[i] = trace(ins, [&] { return step.value; });
+            break;
+        case execution_plan::step_kind::param:
+            slots[i] = trace(ins, [&] {
+                auto it = params.find(step.parameter);
+                if(it == params.end())
+                    MIGRAPHX_THROW("Parameter not found: " + step.parameter);
+                const auto& param = it->second;
+                if(not ins->get_shape().any_of_dynamic() and
+                   param.get_shape() != ins->get_shape())
+                {
+                    MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
+                                   "} for parameter: " + step.parameter +
+                                   " should be: " + to_string(ins->get_shape()));
+                }
+                return param;
+            });
+            break;
+        case execution_plan::step_kind::outline:
+            slots[i] = trace(ins, [&] { return argument{ins->get_shape(), nullptr}; });
+            break;
+        case execution_plan::step_kind::compute:
+            values.resize(step.inputs.size());
+            std::transform(step.inputs.begin(),
+                           step.inputs.end(),
+                           values.begin(),
+                           [&](std::size_t slot) { return slots[slot]; });
+            slots[i] = trace(ins, [&] {
+                if(step.op.is_context_free())
+                    return step.op.compute(ins->get_shape(), values, step.module_args, module_eval);
+                if(ins->get_target_id() >= ctx.size())
+                    MIGRAPHX_THROW("No context available for " + step.op.name());
+                return step.op.compute(ctx[ins->get_target_id()],
+                                       ins->get_shape(),
+                                       values,
+                                       step.module_args,
+                                       module_eval);
+            });
+            break;
+        }
+        assert(is_compatible_shape(slots[i].get_shape(), ins->get_shape()));
+    }
+    std::vector<argument> result(plan.outputs.size());
+    std::transform(plan.outputs.begin(),
+                   plan.outputs.end(),
+                   result.begin(),
+                   [&](std::size_t slot) { return slots[slot]; });
+    return result;
+}
+
 template <class F>
-std::vector<argument> generic_eval(const program& p,
+std::vector<argument> generic_eval(const program_impl& impl,
                                    std::vector<context>& ctx,
                                    std::unordered_map<std::string, argument> params,
                                    F trace)
 {
-    const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, trace);
+    const module* mm = &impl.modules.at("main");
+    std::vector<argument> results;
+    if(const auto* plan = impl.get_plan(mm))
+        results = plan_eval(impl.plans, *plan, ctx, params, nullptr, trace);
+    else
+        results = generic_eval(mm, ctx, std::move(params), {}, trace);
+    // Literals are evaluated without copying, so outputs that alias one are copied before they
+    // are handed to the caller
+    std::transform(results.begin(), results.end(), results.begin(), [](const argument& a) {
+        return a.writable();
+    });
+    return results;
 }
 
 std::vector<argument> program::eval_with_context(std::vector<context>& ctx,
                                                  parameter_map params) const
 {
-    const module* mm = this->get_main_module();
-    return generic_eval(mm, ctx, std::move(params), {}, [](auto&&, auto f) { return f(); });
+    return generic_eval(*impl, ctx, std::move(params), [](auto&&, auto f) { return f(); });
 }
 
 std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
@@ -583,7 +858,7 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
             instruction::print(ss, x, ins_names);
             ins_out[x] = ss.str();
         });
-        ret = generic_eval(*this, contexts, std::move(params), [&](instruction_ref ins, auto f) {
+        ret = generic_eval(*impl, contexts, std::move(params), [&](instruction_ref ins, auto f) {
             const auto& ctx = contexts[ins->get_target_id()];
             ctx.finish();
             std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
@@ -630,7 +905,7 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
     }
     else
     {
-        ret = generic_eval(*this, contexts, std::move(params), [&](auto&&, auto f) { return f(); });
+        ret = generic_eval(*impl, contexts, std::move(params), [&](auto&&, auto f) { return f(); });
     }
 
     if(exec_env.async)
@@ -722,7 +997,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const std::function<literal(const value&)>& load_literal)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -740,8 +1016,7 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output =
-                mod->insert_literal(mod->end(), migraphx::from_value<literal>(node.at("literal")));
+            output = mod->insert_literal(mod->end(), load_literal(node.at("literal")));
         }
         else
         {
@@ -766,7 +1041,7 @@ static void mod_from_val(module_ref mod,
 
                 for(const auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, load_literal);
                 }
             }
 
@@ -789,6 +1064,12 @@ static void mod_from_val(module_ref mod,
 }
 
 void program::from_value(const value& v)
+{
+    this->from_value(v, [](const value& lv) { return migraphx::from_value<literal>(lv); });
+}
+
+void program::from_value(const value& v,
+                         const std::function<literal(const value&)>& load_literal)
 {
     auto version = v.at("version").to<int>();
     if(version != program_file_version)
@@ -832,7 +1113,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, load_literal);
 
     // Finalize a compiled model
     if(not this->impl->contexts.empty())
@@ -871,6 +1152,16 @@ double percentile(const std::vector<double>& v, double percentile)
     return v[index];
 }
 
+// Print the achieved rates of the cost when it ran in ms milliseconds
+static void print_rates(std::ostream& os, const op_cost& cost, double ms)
+{
+    if(ms <= 0 or (cost.flops == 0 and cost.bytes == 0))
+        return;
+    os << ", " << cost.flops / ms / 1.0e6 << " GFLOP/s";
+    os << ", " << cost.bytes / ms / 1.0e6 << " GB/s";
+    os << ", " << cost.intensity() << " FLOP/B";
+}
+
 std::string perf_group(instruction_ref ins, bool detailed)
 {
     std::string result;
@@ -895,7 +1186,7 @@ void program::mark(const parameter_map& params, marker&& m)
     this->finish();
     // Start marking
     m.mark_start(*this);
-    generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+    generic_eval(*impl, ctx, params, [&](auto ins, auto f) {
         argument result;
         m.mark_start(ins);
         result = f();
@@ -925,7 +1216,7 @@ void program::perf_report(
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
     // Fill the map
-    generic_eval(*this, ctx, params, [&](auto ins, auto) {
+    generic_eval(*impl, ctx, params, [&](auto ins, auto) {
         ins_vec[ins].reserve(n);
         return argument{ins->get_shape(), nullptr};
     });
@@ -933,7 +1224,7 @@ void program::perf_report(
     // Run and time each instruction
     for(std::size_t i = 0; i < n; i++)
     {
-        generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+        generic_eval(*impl, ctx, params, [&](auto ins, auto f) {
             argument result;
             ins_vec[ins].push_back(time<milliseconds>([&] {
                 result = f();
@@ -951,6 +1242,20 @@ void program::perf_report(
     {
         overhead_vec.push_back(time<milliseconds>([&] { dry_run(params); }));
     }
+    std::sort(overhead_vec.begin(), overhead_vec.end());
+    // Run and time the overhead of evaluating without the execution plan for comparison
+    const module* mm = this->get_main_module();
+    std::vector<double> interpreter_overhead_vec;
+    interpreter_overhead_vec.reserve(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        interpreter_overhead_vec.push_back(time<milliseconds>([&] {
+            generic_eval(mm, ctx, params, {}, [](auto ins, auto&&...) {
+                return argument{ins->get_shape(), nullptr};
+            });
+        }));
+    }
+    std::sort(interpreter_overhead_vec.begin(), interpreter_overhead_vec.end());
     double total_time             = common_average(total_vec);
     double min_time               = total_vec.front();
     double max_time               = total_vec.back();
@@ -961,16 +1266,19 @@ void program::perf_report(
     double percentile_99_time     = percentile(total_vec, 0.99);
     double rate                   = 1000.0 / total_time;
     double overhead_time          = common_average(overhead_vec);
+    double interpreter_time       = common_average(interpreter_overhead_vec);
     double overhead_percent       = overhead_time * 100.0 / total_time;
     double total_instruction_time = 0.0;
     std::unordered_map<std::string, double> op_times;
     std::unordered_map<std::string, std::size_t> op_n;
+    std::unordered_map<std::string, op_cost> op_costs;
     for(auto&& p : ins_vec)
     {
         double avg = common_average(p.second);
         op_times[perf_group(p.first, detailed)] += avg;
         total_instruction_time += avg;
         op_n[perf_group(p.first, detailed)]++;
+        op_costs[perf_group(p.first, detailed)] += estimate_cost(p.first);
     }
     double calculate_overhead_time    = total_time - total_instruction_time;
     double calculate_overhead_percent = calculate_overhead_time * 100.0 / total_time;
@@ -986,6 +1294,7 @@ void program::perf_report(
         double avg     = common_average(ins_vec[ins]);
         double percent = std::ceil(100.0 * avg / total_instruction_time);
         os << ": " << avg << "ms, " << percent << "%";
+        print_rates(os, estimate_cost(ins), avg);
         os << std::endl;
     });
 
@@ -1002,8 +1311,9 @@ void program::perf_report(
     {
         double percent = std::ceil(100.0 * avg / total_instruction_time);
         double per_ins = avg / nn;
-        os << name << ": " << avg << "ms / " << nn << " = " << per_ins << "ms, " << percent << "%"
-           << std::endl;
+        os << name << ": " << avg << "ms / " << nn << " = " << per_ins << "ms, " << percent << "%";
+        print_rates(os, op_costs[name], avg);
+        os << std::endl;
     }
 
     os << std::endl;
@@ -1023,6 +1333,10 @@ void program::perf_report(
        << ", " << calculate_overhead_time << "ms" << std::endl;
     os << "Overhead: " << std::round(overhead_percent) << "%"
        << ", " << std::round(calculate_overhead_percent) << "%" << std::endl;
+    os << "Eval overhead per run: " << overhead_time * 1000.0 << "us";
+    if(this->impl->get_plan(mm) != nullptr)
+        os << " (execution plan), " << interpreter_time * 1000.0 << "us (interpreter)";
+    os << std::endl;
 }
 
 void program::debug_print() const { std::cout << *this << std::endl; }
@@ -1121,7 +1435,7 @@ void program::print_cpp(std::ostream& os) const
 void program::dry_run(std::unordered_map<std::string, argument> params) const
 {
     auto& ctx = this->impl->contexts;
-    generic_eval(*this, ctx, std::move(params), [](auto ins, auto&&...) {
+    generic_eval(*impl, ctx, std::move(params), [](auto ins, auto&&...) {
         return argument{ins->get_shape(), nullptr};
     });
 }
@@ -1266,6 +1580,7 @@ void program::remove_module(const std::string& name)
         }
     }
 
+    impl->plans.plans.erase(&mod);
     impl->modules.erase(name);
 }
 
@@ -27,8 +27,15 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/functional.hpp>
 #include <migraphx/simple_par_for.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/op_cost.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/time.hpp>
 #include <migraphx/env.hpp>
-#include <thread>
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace migraphx {
@@ -51,12 +58,6 @@ bool skip_propagate(instruction_ref ins)
     return false;
 }
 
-bool is_const_ins(instruction_ref ins, const std::unordered_set<std::string>& skip_ops)
-{
-    return ins->can_eval() and not skip_propagate(ins) and
-           skip_ops.find(ins->name()) == skip_ops.end();
-}
-
 argument as_packed(const argument& c)
 {
     if(c.get_shape().packed())
@@ -67,69 +68,249 @@ argument as_packed(const argument& c)
     return result;
 }
 
+// Estimated cost of evaluating an instruction: its arithmetic plus the bytes it reads and writes
+static std::size_t eval_cost(instruction_ref ins)
+{
+    auto cost = estimate_cost(ins);
+    return cost.flops + cost.bytes;
+}
+
+// Greedily assign work items (sorted by cost descending) to the least loaded bucket
+static std::vector<std::vector<std::size_t>>
+partition_by_cost(const std::vector<std::size_t>& costs, std::size_t nbuckets)
+{
+    std::vector<std::size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto x, auto y) {
+        return costs[x] > costs[y];
+    });
+    nbuckets = std::max<std::size_t>(1, std::min(nbuckets, costs.size()));
+    std::vector<std::vector<std::size_t>> buckets(nbuckets);
+    std::vector<std::size_t> loads(nbuckets);
+    for(auto i : order)
+    {
+        auto b = std::min_element(loads.begin(), loads.end()) - loads.begin();
+        buckets[b].push_back(i);
+        loads[b] += costs[i];
+    }
+    return buckets;
+}
+
+/**
+ * Evaluates a set of constant roots. Every instruction in the constant subgraphs is evaluated
+ * exactly once in topological order, and independent instructions are evaluated in parallel.
+ * Intermediate results are released as soon as their last folded consumer has run, so only the
+ * roots are kept around to be materialized as literals.
+ */
+struct constant_folder
+{
+    struct node
+    {
+        instruction_ref ins;
+        std::vector<std::size_t> inputs = {};
+        std::size_t level               = 0;
+        std::size_t uses                = 0;
+        bool root                       = false;
+        argument result                 = {};
+        double time                     = 0;
+    };
+    std::vector<node> nodes;
+    std::unordered_map<instruction_ref, std::size_t> index;
+
+    explicit constant_folder(const std::vector<instruction_ref>& roots)
+    {
+        // Post-order traversal gives a topological order of the constant subgraphs
+        for(auto root : roots)
+        {
+            fix([&](auto self, instruction_ref ins) {
+                if(contains(index, ins))
+                    return;
+                node n{ins};
+                if(ins->name() != "@literal")
+                {
+                    for(auto input : ins->inputs())
+                    {
+                        self(input);
+                        n.inputs.push_back(index.at(input));
+                    }
+                }
+                for(auto i : n.inputs)
+                {
+                    n.level = std::max(n.level, nodes[i].level + 1);
+                    nodes[i].uses++;
+                }
+                index.emplace(ins, nodes.size());
+                nodes.push_back(std::move(n));
+            })(root);
+            nodes[index.at(root)].root = true;
+        }
+    }
+
+    void eval_node(node& n, bool trace)
+    {
+        auto run = [&] {
+            if(n.ins->name() == "@literal")
+            {
+                n.result = n.ins->get_literal().get_argument();
+                return;
+            }
+            std::vector<argument> args;
+            std::transform(n.inputs.begin(),
+                           n.inputs.end(),
+                           std::back_inserter(args),
+                           [&](auto i) { return nodes[i].result; });
+            n.result = n.ins->normalized_operator().compute(n.ins->get_shape(), args);
+            if(n.root)
+                n.result = as_packed(n.result);
+        };
+        if(trace)
+            n.time = time<std::chrono::duration<double, std::milli>>(run);
+        else
+            run();
+    }
+
+    void run(bool trace)
+    {
+        std::size_t nlevels = 0;
+        for(const auto& n : nodes)
+            nlevels = std::max(nlevels, n.level + 1);
+        std::vector<std::vector<std::size_t>> levels(nlevels);
+        for(std::size_t i = 0; i < nodes.size(); i++)
+            levels[nodes[i].level].push_back(i);
+
+        for(const auto& level : levels)
+        {
+            std::vector<std::size_t> costs(level.size());
+            std::transform(level.begin(), level.end(), costs.begin(), [&](auto i) {
+                return eval_cost(nodes[i].ins);
+            });
+            auto buckets = partition_by_cost(costs, get_num_threads());
+            simple_par_for(buckets.size(), 1, [&](auto b) {
+                for(auto j : buckets[b])
+                    eval_node(nodes[level[j]], trace);
+            });
+            // Release intermediates that have no remaining consumers
+            for(auto i : level)
+            {
+                for(auto input : nodes[i].inputs)
+                {
+                    auto& in = nodes[input];
+                    in.uses--;
+                    if(in.uses == 0 and not in.root)
+                        in.result = {};
+                }
+            }
+        }
+    }
+
+    const argument& get(instruction_ref ins) const { return nodes[index.at(ins)].result; }
+
+    void print_times(std::ostream& os) const
+    {
+        std::map<std::string, std::pair<std::size_t, double>> op_times;
+        double total = 0;
+        for(const auto& n : nodes)
+        {
+            auto& t = op_times[n.ins->name()];
+            t.first++;
+            t.second += n.time;
+            total += n.time;
+        }
+        std::vector<std::pair<std::string, std::pair<std::size_t, double>>> sorted(
+            op_times.begin(), op_times.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& x, const auto& y) {
+            return x.second.second > y.second.second;
+        });
+        os << "Constant folding time per operator:" << std::endl;
+        for(const auto& [name, t] : sorted)
+            os << name << " (" << t.first << "): " << t.second << "ms" << std::endl;
+        os << "Total: " << total << "ms for " << nodes.size() << " instructions" << std::endl;
+    }
+};
+
 void propagate_constant::apply(module& m) const
 {
-    std::unordered_set<instruction_ref> const_instrs;
+    // Memoize can_eval over the module, since instruction::can_eval has to walk all the inputs
+    std::unordered_map<instruction_ref, bool> evaluable;
+    auto can_eval = [&](instruction_ref ins) {
+        auto it = evaluable.find(ins);
+        if(it != evaluable.end())
+            return it->second;
+        // Instructions from a parent module
+        return ins->can_eval();
+    };
+    auto is_const = [&](instruction_ref ins) {
+        return can_eval(ins) and not skip_propagate(ins) and not contains(skip_ops, ins->name());
+    };
+
+    std::vector<instruction_ref> const_instrs;
+    std::unordered_set<instruction_ref> visited;
+    auto add_const = [&](instruction_ref ins) {
+        if(visited.insert(ins).second)
+            const_instrs.push_back(ins);
+    };
     auto last = std::prev(m.end());
 
     // Find instructions that can be evaluated to a literal
     for(auto i : iterator_for(m))
     {
-        const bool is_const = is_const_ins(i, skip_ops);
-        if(is_const and i != last)
+        if(i->name() == "@literal")
+            evaluable[i] = true;
+        else if(not is_context_free(i->get_operator()))
+            evaluable[i] = false;
+        else
+            evaluable[i] = std::all_of(i->inputs().begin(), i->inputs().end(), can_eval);
+
+        const bool i_const = is_const(i);
+        if(i_const and i != last)
             continue;
 
-        if(i == last and is_const)
+        if(i == last and i_const)
         {
-            const_instrs.insert(i);
+            add_const(i);
         }
         else
         {
-            std::copy_if(i->inputs().begin(),
-                         i->inputs().end(),
-                         std::inserter(const_instrs, const_instrs.begin()),
-                         [&](const instruction_ref ins) {
-                             return is_const_ins(ins, skip_ops) and ins->name() != "@literal";
-                         });
+            for(auto input : i->inputs())
+            {
+                if(is_const(input) and input->name() != "@literal")
+                    add_const(input);
+            }
         }
     }
+    if(const_instrs.empty())
+        return;
 
-    // Compute literals in parallel
-    std::vector<instruction_ref> const_instrs_vec{const_instrs.begin(), const_instrs.end()};
-    std::vector<argument> literals(const_instrs_vec.size());
-    std::size_t grainsize = 1;
-#if !MIGRAPHX_HAS_EXECUTORS
-    std::size_t n = std::max<std::size_t>(2048 / std::thread::hardware_concurrency(), 1);
-    grainsize     = const_instrs_vec.size() / n;
-#endif
-    simple_par_for(const_instrs_vec.size(), grainsize, [&](const auto i) {
-        literals[i] = as_packed(const_instrs_vec[i]->eval());
-    });
+    const bool trace = enabled(MIGRAPHX_TRACE_PROPAGATE_CONSTANT{});
+    constant_folder folder{const_instrs};
+    folder.run(trace);
 
     // Replace instructions in m
-    for(size_t i = 0; i < const_instrs_vec.size(); i++)
+    for(auto ins : const_instrs)
     {
-        if(not literals[i].empty())
+        const auto& result = folder.get(ins);
+        if(result.empty())
+            continue;
+        if(trace)
         {
-            if(enabled(MIGRAPHX_TRACE_PROPAGATE_CONSTANT{}))
-            {
-                std::cout << "Constant replace: " << std::endl;
-                std::vector<instruction_ref> inss;
-                fix([&](auto self, auto ins) {
-                    if(contains(inss, ins))
-                        return;
-                    for(auto input : ins->inputs())
-                        self(input);
-                    inss.push_back(ins);
-                })(const_instrs_vec[i]);
-                m.debug_print(inss);
-            }
-            assert(literals[i].get_shape().lens() == const_instrs_vec[i]->get_shape().lens());
-            assert(literals[i].get_shape().bytes() <= const_instrs_vec[i]->get_shape().bytes());
-            auto l = m.add_literal(literals[i].get_shape(), literals[i].data());
-            m.replace_instruction(const_instrs_vec[i], l);
+            std::cout << "Constant replace: " << std::endl;
+            std::vector<instruction_ref> inss;
+            fix([&](auto self, auto x) {
+                if(contains(inss, x))
+                    return;
+                for(auto input : x->inputs())
+                    self(input);
+                inss.push_back(x);
+            })(ins);
+            m.debug_print(inss);
         }
+        assert(result.get_shape().lens() == ins->get_shape().lens());
+        assert(result.get_shape().bytes() <= ins->get_shape().bytes());
+        auto l = m.add_literal(result.get_shape(), result.data());
+        m.replace_instruction(ins, l);
     }
+    if(trace)
+        folder.print_times(std::cout);
 }
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -26,6 +26,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <migraphx/program.hpp>
+#include <migraphx/session.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/operation.hpp>
 #include <migraphx/quantization.hpp>
@@ -493,6 +494,24 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
         .def("__ne__", std::not_equal_to<migraphx::program>{})
         .def("__repr__", [](const migraphx::program& p) { return migraphx::to_string(p); });
 
+    py::class_<migraphx::session>(m, "session")
+        .def(py::init<const migraphx::program&>(), py::keep_alive<1, 2>(), py::arg("p"))
+        .def("run",
+             [](migraphx::session& s, py::dict params) {
+                 migraphx::parameter_map pm;
+                 for(auto x : params)
+                 {
+                     std::string key      = x.first.cast<std::string>();
+                     py::buffer b         = x.second.cast<py::buffer>();
+                     py::buffer_info info = b.request();
+                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+                 }
+                 // Let other sessions run from other python threads
+                 py::gil_scoped_release release;
+                 return s.eval(pm);
+             })
+        .def("finish", &migraphx::session::finish);
+
     py::class_<migraphx::operation> op(m, "op");
     op.def(py::init([](const std::string& name, py::kwargs kwargs) {
           migraphx::value v = migraphx::value::object{};
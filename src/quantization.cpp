@@ -22,8 +22,10 @@
  * THE SOFTWARE.
  */
 #include <migraphx/float_equal.hpp>
+#include <migraphx/hash.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/quantization.hpp>
+#include <migraphx/calibration.hpp>
 #include <migraphx/truncate_float.hpp>
 #include <migraphx/quantize_8bits.hpp>
 #include <migraphx/quantize_int4.hpp>
@@ -42,8 +44,16 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/session.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <map>
+#include <string_view>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -84,83 +94,146 @@ void quantize_bf16(program& prog, const std::vector<std::string>& ins_names)
                quant_tracer());
 }
 
+// Run every calibration batch through a compiled copy of the program. The batches are spread
+// over options.concurrency workers, each with its own session of the program.
+static void run_calibration(const program& prog,
+                            const target& t,
+                            const std::vector<parameter_map>& calibration,
+                            const calibration_options& options)
+{
+    auto capture_prog = prog;
+    capture_prog.compile(t);
+    auto param_shapes    = capture_prog.get_parameter_shapes();
+    bool host            = contains({"ref", "cpu"}, t.name());
+    std::size_t nworkers = options.concurrency;
+    if(nworkers == 0)
+        nworkers = host ? get_num_threads() : 1;
+    nworkers = std::max<std::size_t>(1, std::min(nworkers, calibration.size()));
+    par_for(nworkers, 1, [&](std::size_t w) {
+        session s{capture_prog};
+        for(std::size_t i = w; i < calibration.size(); i += nworkers)
+        {
+            const auto& arg = calibration[i];
+            parameter_map m;
+            for(auto&& x : param_shapes)
+            {
+                if(arg.count(x.first) > 0)
+                {
+                    assert(x.second == arg.at(x.first).get_shape());
+                    m[x.first] = t.copy_to(arg.at(x.first));
+                }
+                else
+                {
+                    m[x.first] = t.allocate(x.second);
+                }
+            }
+            s.eval(m);
+            s.finish();
+        }
+    });
+}
+
+// Identifies what the cached calibration ranges were computed for: the program, from its printed
+// form, which abbreviates large literals, and the data of the literals, along with the quantized
+// type and the operators that are quantized
+static std::string calibration_fingerprint(const program& prog,
+                                           shape::type_t precision,
+                                           const std::unordered_set<std::string>& ins_names)
+{
+    std::size_t seed = std::hash<std::string>{}(to_string(prog));
+    hash_combine(seed, shape::cpp_type(precision));
+    for(const auto& name : std::set<std::string>(ins_names.begin(), ins_names.end()))
+        hash_combine(seed, name);
+    for(const auto* m : prog.get_modules())
+    {
+        for(const auto& ins : *m)
+        {
+            if(ins.name() != "@literal")
+                continue;
+            const auto& lit = ins.get_literal();
+            hash_combine(seed, std::string_view{lit.data(), lit.get_shape().bytes()});
+        }
+    }
+    return std::to_string(seed);
+}
+
 void quantize_8bits(program& prog,
                     const target& t,
                     shape::type_t precision,
                     const std::vector<parameter_map>& calibration,
-                    const std::unordered_set<std::string>& ins_names)
+                    const std::unordered_set<std::string>& ins_names,
+                    const calibration_options& options)
 {
     // Run optimize_module() before converting to int8/fp8 to const eval and fold in FP32 to
     // avoid loss of precision.
     run_passes(prog, {normalize_ops{}, optimize_module{}}, quant_tracer());
 
-    std::shared_ptr<std::vector<std::pair<float, float>>> quant_8bit_params =
-        std::make_shared<std::vector<std::pair<float, float>>>();
-    std::shared_ptr<std::vector<float>> max_abs_vals = std::make_shared<std::vector<float>>();
-    std::map<shape::type_t, float> type_ranges       = {{shape::type_t::int8_type, 127.0},
-                                                        {shape::type_t::fp8e4m3fnuz_type, 240.0},
-                                                        {shape::type_t::fp8e4m3fn_type, 448.0}};
-    float quantized_range                            = type_ranges.at(precision);
-    auto calc_quant_params = [&](std::size_t ins_index, std::vector<argument> args) {
-        std::pair<float, float> param_pair{64.0f, 0.0f};
-        // scale and shift is need for only int8 type, and we do not
-        // consider shift, so set shift to 0
-        std::vector<float> vec_val;
+    std::map<shape::type_t, float> type_ranges = {{shape::type_t::int8_type, 127.0},
+                                                  {shape::type_t::fp8e4m3fnuz_type, 240.0},
+                                                  {shape::type_t::fp8e4m3fn_type, 448.0}};
+    float quantized_range                      = type_ranges.at(precision);
+
+    // Only the max method can be computed without a histogram
+    std::size_t nbins = options.method == calibration_method::max ? 0 : options.bins;
+    std::vector<calibration_histogram> histograms;
+    std::unique_ptr<std::mutex[]> locks;
+    auto capture_args = [&](std::size_t ins_index, std::vector<argument> args) {
         argument arg = t.copy_from(args.front());
-        arg.visit([&](auto output) { vec_val.assign(output.begin(), output.end()); });
-        auto max_val                = *std::max_element(vec_val.begin(), vec_val.end());
-        auto min_val                = *std::min_element(vec_val.begin(), vec_val.end());
-        auto max_abs                = std::max(std::fabs(max_val), std::fabs(min_val));
-        max_abs_vals->at(ins_index) = std::max(max_abs_vals->at(ins_index), max_abs);
-        // if all values are 0, no need to do scaling
-        if(float_equal(max_abs_vals->at(ins_index), 0.0f))
-        {
-            param_pair.first = 1.0f;
-        }
-        else
-        {
-            param_pair.first = quantized_range / max_abs_vals->at(ins_index);
-        }
-        quant_8bit_params->at(ins_index) = param_pair;
+        std::lock_guard<std::mutex> guard(locks[ins_index]);
+        histograms.at(ins_index).add(arg);
     };
 
+    std::string fingerprint;
+    if(not options.cache_file.empty())
+        fingerprint = calibration_fingerprint(prog, precision, ins_names);
+
     // pass to add capture argument op
     std::size_t param_num = 0;
-    run_passes(
-        prog, {capture_arguments_pass{ins_names, calc_quant_params, &param_num}}, quant_tracer());
-    quant_8bit_params->resize(param_num, std::pair<float, float>(64.0f, 0.0f));
-    max_abs_vals->resize(param_num, 0.0f);
-
-    // use the calibration data to compute the quantization scale
-    auto capture_prog = prog;
-    capture_prog.compile(t);
+    run_passes(prog, {capture_arguments_pass{ins_names, capture_args, &param_num}}, quant_tracer());
+    histograms.resize(param_num, calibration_histogram{nbins});
+    locks = std::make_unique<std::mutex[]>(param_num);
 
-    // use all calibration data to run the program to calculate the
-    // quantization scale and shift
-    for(auto&& arg : calibration)
+    optional<std::vector<float>> thresholds;
+    if(not options.cache_file.empty())
+        thresholds = load_calibration(options.cache_file, options, fingerprint, param_num);
+    if(not thresholds.has_value())
     {
-        parameter_map m;
-        for(auto&& x : capture_prog.get_parameter_shapes())
-        {
-            if(arg.count(x.first) > 0)
-            {
-                assert(x.second == arg.at(x.first).get_shape());
-                m[x.first] = t.copy_to(arg.at(x.first));
-            }
-            else
-            {
-                m[x.first] = t.allocate(x.second);
-            }
-        }
-        capture_prog.eval(m);
+        run_calibration(prog, t, calibration, options);
+        // A negative threshold marks a tensor that was never captured
+        thresholds = std::vector<float>(param_num);
+        std::transform(histograms.begin(),
+                       histograms.end(),
+                       thresholds->begin(),
+                       [&](const calibration_histogram& h) {
+                           if(h.empty())
+                               return -1.0f;
+                           return h.get_threshold(options, std::size_t(quantized_range) + 1);
+                       });
+        if(not options.cache_file.empty())
+            save_calibration(options.cache_file, options, fingerprint, *thresholds);
     }
 
+    // scale and shift is need for only int8 type, and we do not
+    // consider shift, so set shift to 0
+    std::vector<std::pair<float, float>> quant_8bit_params(param_num);
+    std::transform(thresholds->begin(),
+                   thresholds->end(),
+                   quant_8bit_params.begin(),
+                   [&](float threshold) -> std::pair<float, float> {
+                       if(threshold < 0)
+                           return {64.0f, 0.0f};
+                       // if all values are 0, no need to do scaling
+                       if(float_equal(threshold, 0.0f))
+                           return {1.0f, 0.0f};
+                       return {quantized_range / threshold, 0.0f};
+                   });
+
     // print the quantization parameters in only the main module
     if(enabled(MIGRAPHX_8BITS_QUANTIZATION_PARAMS{}))
     {
-        for(std::size_t i = 0; i < quant_8bit_params->size(); ++i)
+        for(std::size_t i = 0; i < quant_8bit_params.size(); ++i)
         {
-            auto param = quant_8bit_params->at(i);
+            auto param = quant_8bit_params.at(i);
             std::cout << "ins_index = " << i << ", scale = " << param.first
                       << ", shift = " << param.second << std::endl;
         }
@@ -168,7 +241,7 @@ void quantize_8bits(program& prog,
     }
 
     run_passes(prog,
-               {quantize_8bits_pass{precision, *quant_8bit_params},
+               {quantize_8bits_pass{precision, quant_8bit_params},
                 simplify_qdq{},
                 optimize_module{},
                 dead_code_elimination{}},
@@ -179,13 +252,22 @@ void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
                    const std::unordered_set<std::string>& ins_names)
+{
+    quantize_int8(prog, t, calibration, calibration_options{}, ins_names);
+}
+
+void quantize_int8(program& prog,
+                   const target& t,
+                   const std::vector<parameter_map>& calibration,
+                   const calibration_options& options,
+                   const std::unordered_set<std::string>& ins_names)
 {
     std::unordered_set<std::string> op_names = {"convolution", "dot"};
     if(op_names != ins_names)
     {
         MIGRAPHX_THROW("QUANTIZE_INT8: only support DOT and CONVOLUTION operation");
     }
-    quantize_8bits(prog, t, shape::int8_type, calibration, ins_names);
+    quantize_8bits(prog, t, shape::int8_type, calibration, ins_names, options);
 }
 
 void quantize_int4_weights(program& prog)
@@ -194,6 +276,14 @@ void quantize_int4_weights(program& prog)
 }
 
 void quantize_fp8(program& prog, const target& t, const std::vector<parameter_map>& calibration)
+{
+    quantize_fp8(prog, t, calibration, calibration_options{});
+}
+
+void quantize_fp8(program& prog,
+                  const target& t,
+                  const std::vector<parameter_map>& calibration,
+                  const calibration_options& options)
 {
     std::unordered_set<std::string> supported_ins_names;
     auto* mm = prog.get_main_module();
@@ -219,11 +309,13 @@ void quantize_fp8(program& prog, const target& t, const std::vector<parameter_ma
     };
     if(gfx_has_fp8fnuz())
     {
-        quantize_8bits(prog, t, shape::fp8e4m3fnuz_type, calibration, supported_ins_names);
+        quantize_8bits(
+            prog, t, shape::fp8e4m3fnuz_type, calibration, supported_ins_names, options);
     }
     else
     {
-        quantize_8bits(prog, t, shape::fp8e4m3fn_type, calibration, supported_ins_names);
+        quantize_8bits(
+            prog, t, shape::fp8e4m3fn_type, calibration, supported_ins_names, options);
     }
 }
 } // namespace MIGRAPHX_INLINE_NS
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/rewrite_rnn.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/add.hpp>
@@ -50,28 +51,145 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-void rewrite_rnn::apply(module& m) const
+void rewrite_rnn::apply(module_pass_manager& mpm) const
 {
+    module& m = mpm.get_module();
     for(auto ins : iterator_for(m))
     {
         if(ins->name() == "rnn")
         {
-            apply_vanilla_rnn(m, ins);
+            apply_vanilla_rnn(mpm, ins);
         }
         else if(ins->name() == "gru")
         {
-            apply_gru(m, ins);
+            apply_gru(mpm, ins);
         }
         else if(ins->name() == "lstm")
         {
-            apply_lstm(m, ins);
+            apply_lstm(mpm, ins);
         }
     }
 }
 
+static unsigned int get_loop_counter()
+{
+    static unsigned int counter = 0;
+    return counter++;
+}
+
+// Computes the input projection Xt*(W^T) + Wb of every time step with a single gemm, so that only
+// the recurrent part of the cell is left inside the loop. Returns a {seq_len, batch, n} tensor.
+static instruction_ref project_sequence(module& m,
+                                        instruction_ref ins,
+                                        instruction_ref seq,
+                                        long seq_len,
+                                        instruction_ref tw,
+                                        instruction_ref bias)
+{
+    auto seq_lens = seq->get_shape().lens();
+    if(seq_len < seq_lens[0])
+    {
+        seq = m.insert_instruction(
+            ins, make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {seq_len}}}), seq);
+    }
+    if(not seq->get_shape().standard())
+        seq = m.insert_instruction(ins, make_op("contiguous"), seq);
+    auto bs = static_cast<int64_t>(seq_lens[1]);
+    auto x  = m.insert_instruction(
+        ins,
+        make_op("reshape", {{"dims", {seq_len * bs, static_cast<int64_t>(seq_lens[2])}}}),
+        seq);
+    auto xw = m.insert_instruction(ins, make_op("dot"), x, tw);
+    if(bias != m.end())
+    {
+        auto bbias = m.insert_instruction(
+            ins, make_op("broadcast", {{"axis", 1}, {"out_lens", xw->get_shape().lens()}}), bias);
+        xw = m.insert_instruction(ins, make_op("add"), xw, bbias);
+    }
+    auto n = static_cast<int64_t>(xw->get_shape().lens()[1]);
+    return m.insert_instruction(ins, make_op("reshape", {{"dims", {seq_len, bs, n}}}), xw);
+}
+
+// Splits the stacked states of a loop into the same {hidden outputs, last output} pair the
+// unrolled cells return, where the hidden outputs exclude the last time step processed
+static std::vector<instruction_ref> split_loop_output(
+    module& m, instruction_ref ins, bool is_forward, instruction_ref last, instruction_ref stacked)
+{
+    long seq_len = stacked->get_shape().lens()[0];
+    long start   = is_forward ? 0 : 1;
+    auto hidden  = m.insert_instruction(
+        ins,
+        make_op("slice", {{"axes", {0}}, {"starts", {start}}, {"ends", {start + seq_len - 1}}}),
+        stacked);
+    auto last_out = m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0, 1}}}), last);
+    return {hidden, last_out};
+}
+
+// Emits the cell once into a submodule run by the loop operator. The xw input is the projection
+// of the whole sequence from project_sequence, and step adds the recurrent part of the cell given
+// the projection of one time step and the previous states. Returns the final states followed by
+// all the states stacked in sequence order as {seq_len, 1, batch, hidden_size}.
+std::vector<instruction_ref> rewrite_rnn::loop_cell(bool is_forward,
+                                                    module_pass_manager& mpm,
+                                                    instruction_ref ins,
+                                                    instruction_ref xw,
+                                                    std::vector<instruction_ref> states,
+                                                    const cell_step& step) const
+{
+    module& m    = mpm.get_module();
+    auto seq_len = static_cast<int64_t>(xw->get_shape().lens()[0]);
+    auto dir     = is_forward ? 0 : 1;
+
+    auto* sm  = mpm.create_module(m.name() + ":" + ins->name() + "_loop" +
+                                 std::to_string(get_loop_counter()));
+    auto iter = sm->add_parameter("iter", shape{shape::int64_type});
+    auto cond = sm->add_parameter("cond", shape{shape::bool_type});
+    std::vector<instruction_ref> params;
+    for(auto i : range(states.size()))
+    {
+        // loop carried dependencies must be standard
+        if(not states[i]->get_shape().standard())
+            states[i] = m.insert_instruction(ins, make_op("contiguous"), states[i]);
+        params.push_back(sm->add_parameter("state" + std::to_string(i), states[i]->get_shape()));
+    }
+
+    auto xt =
+        sm->add_instruction(make_op("scan_slice", {{"axis", 0}, {"direction", dir}}), xw, iter);
+    xt           = sm->add_instruction(make_op("squeeze", {{"axes", {0}}}), xt);
+    auto outputs = step(*sm, sm->end(), xt, params);
+
+    std::vector<instruction_ref> returns{cond};
+    returns.insert(returns.end(), outputs.begin(), outputs.end());
+    std::transform(outputs.begin(), outputs.end(), std::back_inserter(returns), [&](auto out) {
+        return sm->add_instruction(make_op("unsqueeze", {{"axes", {0}}}), out);
+    });
+    sm->add_return(returns);
+
+    auto iter_lit = m.add_literal(literal{shape{shape::int64_type}, {seq_len}});
+    auto cond_lit = m.add_literal(literal{shape{shape::bool_type}, {true}});
+    std::vector<instruction_ref> loop_args{iter_lit, cond_lit};
+    loop_args.insert(loop_args.end(), states.begin(), states.end());
+    auto loop = m.insert_instruction(
+        ins,
+        make_op("loop",
+                {{"max_iterations", seq_len},
+                 {"scan_output_directions", std::vector<int64_t>(states.size(), dir)}}),
+        loop_args,
+        {sm});
+
+    std::vector<instruction_ref> results;
+    for(auto i : range(2 * states.size()))
+    {
+        results.push_back(
+            m.insert_instruction(ins, make_op("get_tuple_elem", {{"index", i}}), loop));
+    }
+    return results;
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-void rewrite_rnn::apply_vanilla_rnn(module& m, instruction_ref ins) const
+void rewrite_rnn::apply_vanilla_rnn(module_pass_manager& mpm, instruction_ref ins) const
 {
+    module& m = mpm.get_module();
     assert(ins->name() == "rnn");
     // could be 3 to 6 inputs, but the parse_rnn function will
     // append undefined operators to make 6 arguments when parsing
@@ -144,7 +262,7 @@ void rewrite_rnn::apply_vanilla_rnn(module& m, instruction_ref ins) const
 
         auto ret_forward =
             vanilla_rnn_cell(true,
-                             m,
+                             mpm,
                              ins,
                              {args[0], w_forward, r_forward, bias_forward, seq_lens, ih_forward},
                              actv_funcs.at(0));
@@ -157,7 +275,7 @@ void rewrite_rnn::apply_vanilla_rnn(module& m, instruction_ref ins) const
 
         auto ret_reverse =
             vanilla_rnn_cell(false,
-                             m,
+                             mpm,
                              ins,
                              {args[0], w_reverse, r_reverse, bias_reverse, seq_lens, ih_reverse},
                              actv_funcs.at(1));
@@ -218,7 +336,7 @@ void rewrite_rnn::apply_vanilla_rnn(module& m, instruction_ref ins) const
         }
 
         auto ret = vanilla_rnn_cell(
-            is_forward, m, ins, {args[0], w, r, bias, seq_lens, ih}, actv_funcs.at(0));
+            is_forward, mpm, ins, {args[0], w, r, bias, seq_lens, ih}, actv_funcs.at(0));
         last_output = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), ret[1]);
 
         // following logic is to ensure the last instruction is a
@@ -243,11 +361,12 @@ void rewrite_rnn::apply_vanilla_rnn(module& m, instruction_ref ins) const
 }
 
 std::vector<instruction_ref> rewrite_rnn::vanilla_rnn_cell(bool is_forward,
-                                                           module& m,
+                                                           module_pass_manager& mpm,
                                                            instruction_ref ins,
                                                            std::vector<instruction_ref> inputs,
                                                            const operation& actv_func) const
 {
+    module& m = mpm.get_module();
     assert(inputs.size() == 6);
     auto seq      = inputs.at(0);
     auto w        = inputs.at(1);
@@ -270,6 +389,7 @@ std::vector<instruction_ref> rewrite_rnn::vanilla_rnn_cell(bool is_forward,
     auto sih_lens = sih->get_shape().lens();
 
     // bias
+    instruction_ref wrb = m.end();
     instruction_ref bb{};
     if(bias != m.end())
     {
@@ -279,15 +399,35 @@ std::vector<instruction_ref> rewrite_rnn::vanilla_rnn_cell(bool is_forward,
             ins, make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {hs}}}), sbias);
         auto rb = m.insert_instruction(
             ins, make_op("slice", {{"axes", {0}}, {"starts", {hs}}, {"ends", {2 * hs}}}), sbias);
-        auto wrb = m.insert_instruction(ins, make_op("add"), wb, rb);
-        bb       = m.insert_instruction(
+        wrb = m.insert_instruction(ins, make_op("add"), wb, rb);
+        bb  = m.insert_instruction(
             ins, make_op("broadcast", {{"axis", 1}, {"out_lens", sih_lens}}), wrb);
     }
 
+    // equation Ht = f(Xt*(Wi^T) + Ht-1*(Ri^T) + Wbi + Rbi), where xt_wi already holds the input
+    // part of it
+    auto step = [&](module& sm,
+                    instruction_ref pos,
+                    instruction_ref xt_wi,
+                    const std::vector<instruction_ref>& states) -> std::vector<instruction_ref> {
+        auto ht_ri = sm.insert_instruction(pos, make_op("dot"), states[0], tran_sr);
+        auto xt_ht = sm.insert_instruction(pos, make_op("add"), xt_wi, ht_ri);
+
+        // apply activation function
+        return {sm.insert_instruction(pos, actv_func, xt_ht)};
+    };
+
+    long seq_len = get_seq_len(m, seq, seq_lens);
+    if(use_loop and seq_len > 1)
+    {
+        auto xw   = project_sequence(m, ins, seq, seq_len, tran_sw, wrb);
+        auto outs = loop_cell(is_forward, mpm, ins, xw, {sih}, step);
+        return split_loop_output(m, ins, is_forward, outs[0], outs[1]);
+    }
+
     instruction_ref hidden_out = m.end();
     instruction_ref last_out{};
-    last_out     = m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0, 1}}}), sih);
-    long seq_len = get_seq_len(m, seq, seq_lens);
+    last_out = m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0, 1}}}), sih);
     for(long i = 0; i < seq_len; i++)
     {
         long seq_index = is_forward ? i : (seq_len - 1 - i);
@@ -298,15 +438,11 @@ std::vector<instruction_ref> rewrite_rnn::vanilla_rnn_cell(bool is_forward,
         auto cont_xt = m.insert_instruction(ins, make_op("contiguous"), xt);
         xt           = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), cont_xt);
         auto xt_wi   = m.insert_instruction(ins, make_op("dot"), xt, tran_sw);
-        auto ht_ri   = m.insert_instruction(ins, make_op("dot"), sih, tran_sr);
         if(bias != m.end())
         {
             xt_wi = m.insert_instruction(ins, make_op("add"), xt_wi, bb);
         }
-        auto xt_ht = m.insert_instruction(ins, make_op("add"), xt_wi, ht_ri);
-
-        // apply activation function
-        auto ht = m.insert_instruction(ins, actv_func, xt_ht);
+        auto ht = step(m, ins, xt_wi, {sih}).front();
         sih     = ht;
 
         // add the dimensions of sequence length (axis 0 for sequence length,
@@ -376,8 +512,9 @@ std::vector<operation> rewrite_rnn::vanilla_rnn_actv_funcs(instruction_ref ins)
 }
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-void rewrite_rnn::apply_gru(module& m, instruction_ref ins) const
+void rewrite_rnn::apply_gru(module_pass_manager& mpm, instruction_ref ins) const
 {
+    module& m = mpm.get_module();
     assert(ins->name() == "gru");
     const auto actv_funcs = gru_actv_funcs(ins);
     // could be 3 to 6 inputs, but the parse_gru function will
@@ -449,7 +586,7 @@ void rewrite_rnn::apply_gru(module& m, instruction_ref ins) const
 
         auto ret_forward =
             gru_cell(true,
-                     m,
+                     mpm,
                      ins,
                      {args[0], w_forward, r_forward, bias_forward, seq_lens, ih_forward},
                      gru_op.linear_before_reset,
@@ -464,7 +601,7 @@ void rewrite_rnn::apply_gru(module& m, instruction_ref ins) const
 
         auto ret_reverse =
             gru_cell(false,
-                     m,
+                     mpm,
                      ins,
                      {args[0], w_reverse, r_reverse, bias_reverse, seq_lens, ih_reverse},
                      gru_op.linear_before_reset,
@@ -524,7 +661,7 @@ void rewrite_rnn::apply_gru(module& m, instruction_ref ins) const
         }
 
         auto ret = gru_cell(is_forward,
-                            m,
+                            mpm,
                             ins,
                             {args[0], w, r, bias, seq_lens, ih},
                             gru_op.linear_before_reset,
@@ -553,13 +690,14 @@ void rewrite_rnn::apply_gru(module& m, instruction_ref ins) const
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 std::vector<instruction_ref> rewrite_rnn::gru_cell(bool is_forward,
-                                                   module& m,
+                                                   module_pass_manager& mpm,
                                                    instruction_ref ins,
                                                    std::vector<instruction_ref> inputs,
                                                    int linear_before_reset,
                                                    const operation& actv_func1,
                                                    const operation& actv_func2) const
 {
+    module& m = mpm.get_module();
     assert(inputs.size() == 6);
     auto seq      = inputs.at(0);
     auto w        = inputs.at(1);
@@ -598,13 +736,14 @@ std::vector<instruction_ref> rewrite_rnn::gru_cell(bool is_forward,
     size_t bs = ih->get_shape().lens()[1];
 
     // bias
+    instruction_ref wb = m.end();
     instruction_ref bwb{};
     instruction_ref brb_zr{};
     instruction_ref brb_h{};
     if(bias != m.end())
     {
         auto sbias = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), bias);
-        auto wb    = m.insert_instruction(
+        wb         = m.insert_instruction(
             ins, make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {3 * hs}}}), sbias);
         bwb = m.insert_instruction(
             ins,
@@ -629,73 +768,93 @@ std::vector<instruction_ref> rewrite_rnn::gru_cell(bool is_forward,
             rb_h);
     }
 
-    long seq_len = get_seq_len(m, seq, seq_lens);
-    for(long i = 0; i < seq_len; i++)
-    {
-        long seq_index = is_forward ? i : (seq_len - 1 - i);
-        auto xt        = m.insert_instruction(
-            ins,
-            make_op("slice", {{"axes", {0}}, {"starts", {seq_index}}, {"ends", {seq_index + 1}}}),
-            seq);
-        auto cont_xt = m.insert_instruction(ins, make_op("contiguous"), xt);
-        xt           = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), cont_xt);
-
-        auto xt_w    = m.insert_instruction(ins, make_op("dot"), xt, tw);
-        auto ih1_rzr = m.insert_instruction(ins, make_op("dot"), sih, trzr);
+    // xt_w holds Xt*(W^T) + Wb for the three gates
+    auto step = [&](module& sm,
+                    instruction_ref pos,
+                    instruction_ref xt_w,
+                    const std::vector<instruction_ref>& states) -> std::vector<instruction_ref> {
+        auto ht1     = states[0];
+        auto ih1_rzr = sm.insert_instruction(pos, make_op("dot"), ht1, trzr);
         if(bias != m.end())
         {
-            xt_w    = m.insert_instruction(ins, make_op("add"), xt_w, bwb);
-            ih1_rzr = m.insert_instruction(ins, make_op("add"), ih1_rzr, brb_zr);
+            ih1_rzr = sm.insert_instruction(pos, make_op("add"), ih1_rzr, brb_zr);
         }
 
-        auto xw_z = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {hs}}}), xt_w);
-        auto xw_r = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {hs}}, {"ends", {2 * hs}}}), xt_w);
-        auto xw_h = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {2 * hs}}, {"ends", {3 * hs}}}), xt_w);
+        auto xw_z = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {hs}}}), xt_w);
+        auto xw_r = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {hs}}, {"ends", {2 * hs}}}), xt_w);
+        auto xw_h = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {2 * hs}}, {"ends", {3 * hs}}}), xt_w);
 
-        auto hr_z = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {hs}}}), ih1_rzr);
-        auto hr_r = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {hs}}, {"ends", {2 * hs}}}), ih1_rzr);
+        auto hr_z = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {hs}}}), ih1_rzr);
+        auto hr_r = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {hs}}, {"ends", {2 * hs}}}), ih1_rzr);
 
-        auto xw_hr_z = m.insert_instruction(ins, make_op("add"), xw_z, hr_z);
-        auto zt      = m.insert_instruction(ins, actv_func1, xw_hr_z);
+        auto xw_hr_z = sm.insert_instruction(pos, make_op("add"), xw_z, hr_z);
+        auto zt      = sm.insert_instruction(pos, actv_func1, xw_hr_z);
 
-        auto xw_hr_r = m.insert_instruction(ins, make_op("add"), xw_r, hr_r);
-        auto rt      = m.insert_instruction(ins, actv_func1, xw_hr_r);
+        auto xw_hr_r = sm.insert_instruction(pos, make_op("add"), xw_r, hr_r);
+        auto rt      = sm.insert_instruction(pos, actv_func1, xw_hr_r);
 
         instruction_ref hr_h{};
         if(linear_before_reset == 0)
         {
             // equation g(Xt*(Wh^T) + (rt (.) Ht-1)*(Rh^T) + Rbh + Wbh)
-            auto rt_ht1 = m.insert_instruction(ins, make_op("mul"), rt, sih);
-            hr_h        = m.insert_instruction(ins, make_op("dot"), rt_ht1, trh);
+            auto rt_ht1 = sm.insert_instruction(pos, make_op("mul"), rt, ht1);
+            hr_h        = sm.insert_instruction(pos, make_op("dot"), rt_ht1, trh);
             if(bias != m.end())
             {
-                hr_h = m.insert_instruction(ins, make_op("add"), hr_h, brb_h);
+                hr_h = sm.insert_instruction(pos, make_op("add"), hr_h, brb_h);
             }
         }
         else
         {
             // equation ht = g(Xt*(Wh^T) + (rt (.) (Ht-1*(Rh^T) + Rbh)) + Wbh)
-            auto ht1_rh = m.insert_instruction(ins, make_op("dot"), sih, trh);
+            auto ht1_rh = sm.insert_instruction(pos, make_op("dot"), ht1, trh);
             if(bias != m.end())
             {
-                ht1_rh = m.insert_instruction(ins, make_op("add"), ht1_rh, brb_h);
+                ht1_rh = sm.insert_instruction(pos, make_op("add"), ht1_rh, brb_h);
             }
-            hr_h = m.insert_instruction(ins, make_op("mul"), rt, ht1_rh);
+            hr_h = sm.insert_instruction(pos, make_op("mul"), rt, ht1_rh);
         }
 
-        auto xw_hr_h = m.insert_instruction(ins, make_op("add"), xw_h, hr_h);
-        auto ht      = m.insert_instruction(ins, actv_func2, xw_hr_h);
+        auto xw_hr_h = sm.insert_instruction(pos, make_op("add"), xw_h, hr_h);
+        auto ht      = sm.insert_instruction(pos, actv_func2, xw_hr_h);
 
         // equation Ht = (1 - zt) (.) ht + zt (.) Ht-1
-        auto one_minus_zt    = m.insert_instruction(ins, make_op("sub"), l1, zt);
-        auto one_minus_zt_ht = m.insert_instruction(ins, make_op("mul"), one_minus_zt, ht);
-        auto zt_ht1          = m.insert_instruction(ins, make_op("mul"), zt, sih);
-        sih                  = m.insert_instruction(ins, make_op("add"), one_minus_zt_ht, zt_ht1);
+        auto one_minus_zt    = sm.insert_instruction(pos, make_op("sub"), l1, zt);
+        auto one_minus_zt_ht = sm.insert_instruction(pos, make_op("mul"), one_minus_zt, ht);
+        auto zt_ht1          = sm.insert_instruction(pos, make_op("mul"), zt, ht1);
+        return {sm.insert_instruction(pos, make_op("add"), one_minus_zt_ht, zt_ht1)};
+    };
+
+    long seq_len = get_seq_len(m, seq, seq_lens);
+    if(use_loop and seq_len > 1)
+    {
+        auto xw   = project_sequence(m, ins, seq, seq_len, tw, wb);
+        auto outs = loop_cell(is_forward, mpm, ins, xw, {sih}, step);
+        return split_loop_output(m, ins, is_forward, outs[0], outs[1]);
+    }
+
+    for(long i = 0; i < seq_len; i++)
+    {
+        long seq_index = is_forward ? i : (seq_len - 1 - i);
+        auto xt        = m.insert_instruction(
+            ins,
+            make_op("slice", {{"axes", {0}}, {"starts", {seq_index}}, {"ends", {seq_index + 1}}}),
+            seq);
+        auto cont_xt = m.insert_instruction(ins, make_op("contiguous"), xt);
+        xt           = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), cont_xt);
+
+        auto xt_w = m.insert_instruction(ins, make_op("dot"), xt, tw);
+        if(bias != m.end())
+        {
+            xt_w = m.insert_instruction(ins, make_op("add"), xt_w, bwb);
+        }
+
+        sih         = step(m, ins, xt_w, {sih}).front();
         last_output = m.insert_instruction(ins, make_op("unsqueeze", {{"axes", {0, 1}}}), sih);
 
         if(i < seq_len - 1)
@@ -764,8 +923,9 @@ std::vector<operation> rewrite_rnn::gru_actv_funcs(instruction_ref ins) const
 
 // for lstm operators
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-void rewrite_rnn::apply_lstm(module& m, instruction_ref ins) const
+void rewrite_rnn::apply_lstm(module_pass_manager& mpm, instruction_ref ins) const
 {
+    module& m = mpm.get_module();
     assert(ins->name() == "lstm");
     auto args = ins->inputs();
 
@@ -865,7 +1025,7 @@ void rewrite_rnn::apply_lstm(module& m, instruction_ref ins) const
         }
 
         auto ret_forward = lstm_cell(true,
-                                     m,
+                                     mpm,
                                      ins,
                                      {args[0],
                                       w_forward,
@@ -885,7 +1045,7 @@ void rewrite_rnn::apply_lstm(module& m, instruction_ref ins) const
                 m.insert_instruction(ins, make_op("rnn_var_sl_shift_sequence"), args[0], seq_lens);
         }
         auto ret_reverse = lstm_cell(false,
-                                     m,
+                                     mpm,
                                      ins,
                                      {args[0],
                                       w_reverse,
@@ -980,7 +1140,7 @@ void rewrite_rnn::apply_lstm(module& m, instruction_ref ins) const
                 m.insert_instruction(ins, make_op("rnn_var_sl_shift_sequence"), args[0], seq_lens);
         }
         auto ret = lstm_cell(is_forward,
-                             m,
+                             mpm,
                              ins,
                              {args[0], w, r, bias, seq_lens, ih, ic, pph},
                              actv_funcs.at(0),
@@ -1022,13 +1182,14 @@ void rewrite_rnn::apply_lstm(module& m, instruction_ref ins) const
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 std::vector<instruction_ref> rewrite_rnn::lstm_cell(bool is_forward,
-                                                    module& m,
+                                                    module_pass_manager& mpm,
                                                     instruction_ref ins,
                                                     std::vector<instruction_ref> inputs,
                                                     const operation& actv_func1,
                                                     const operation& actv_func2,
                                                     const operation& actv_func3) const
 {
+    module& m = mpm.get_module();
     // must have 7 args in the input vector
     assert(inputs.size() == 8);
     auto seq      = inputs.at(0);
@@ -1067,6 +1228,7 @@ std::vector<instruction_ref> rewrite_rnn::lstm_cell(bool is_forward,
     auto ic_lens = sic->get_shape().lens();
 
     // bias
+    instruction_ref ub_wrb = m.end();
     instruction_ref wrb{};
     if(bias != m.end())
     {
@@ -1078,7 +1240,7 @@ std::vector<instruction_ref> rewrite_rnn::lstm_cell(bool is_forward,
             ins,
             make_op("slice", {{"axes", {0}}, {"starts", {4 * hs}}, {"ends", {8 * hs}}}),
             sbias);
-        auto ub_wrb = m.insert_instruction(ins, make_op("add"), ub_wb, ub_rb);
+        ub_wrb = m.insert_instruction(ins, make_op("add"), ub_wb, ub_rb);
 
         wrb = m.insert_instruction(
             ins,
@@ -1110,64 +1272,88 @@ std::vector<instruction_ref> rewrite_rnn::lstm_cell(bool is_forward,
     }
 
     long seq_len = get_seq_len(m, seq, seq_lens);
-    for(long i = 0; i < seq_len; ++i)
-    {
-        long seq_index = is_forward ? i : (seq_len - 1 - i);
-        auto xt        = m.insert_instruction(
-            ins,
-            make_op("slice", {{"axes", {0}}, {"starts", {seq_index}}, {"ends", {seq_index + 1}}}),
-            seq);
-        auto cont_xt = m.insert_instruction(ins, make_op("contiguous"), xt);
-        xt           = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), cont_xt);
-
-        auto xt_tsw  = m.insert_instruction(ins, make_op("dot"), xt, tsw);
-        auto sih_tsr = m.insert_instruction(ins, make_op("dot"), sih, tsr);
-        auto xt_sih  = m.insert_instruction(ins, make_op("add"), xt_tsw, sih_tsr);
-        if(bias != m.end())
-        {
-            xt_sih = m.insert_instruction(ins, make_op("add"), xt_sih, wrb);
-        }
-
-        auto it_before_actv = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {hs}}}), xt_sih);
-        auto ot_before_actv = m.insert_instruction(
-            ins, make_op("slice", {{"axes", {1}}, {"starts", {hs}}, {"ends", {2 * hs}}}), xt_sih);
-        auto ft_before_actv = m.insert_instruction(
-            ins,
+    // the looped form folds the bias into the hoisted input projection
+    bool looped = use_loop and seq_len > 1;
+
+    auto step = [&](module& sm,
+                    instruction_ref pos,
+                    instruction_ref xt_tsw,
+                    const std::vector<instruction_ref>& states) -> std::vector<instruction_ref> {
+        auto ht1     = states[0];
+        auto ct1     = states[1];
+        auto sih_tsr = sm.insert_instruction(pos, make_op("dot"), ht1, tsr);
+        auto xt_sih  = sm.insert_instruction(pos, make_op("add"), xt_tsw, sih_tsr);
+        if(bias != m.end() and not looped)
+        {
+            xt_sih = sm.insert_instruction(pos, make_op("add"), xt_sih, wrb);
+        }
+
+        auto it_before_actv = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {0}}, {"ends", {hs}}}), xt_sih);
+        auto ot_before_actv = sm.insert_instruction(
+            pos, make_op("slice", {{"axes", {1}}, {"starts", {hs}}, {"ends", {2 * hs}}}), xt_sih);
+        auto ft_before_actv = sm.insert_instruction(
+            pos,
             make_op("slice", {{"axes", {1}}, {"starts", {2 * hs}}, {"ends", {3 * hs}}}),
             xt_sih);
-        auto ct_before_actv = m.insert_instruction(
-            ins,
+        auto ct_before_actv = sm.insert_instruction(
+            pos,
             make_op("slice", {{"axes", {1}}, {"starts", {3 * hs}}, {"ends", {4 * hs}}}),
             xt_sih);
 
         if(pph != m.end())
         {
-            auto pphi_ct   = m.insert_instruction(ins, make_op("mul"), pphi_brcst, sic);
-            it_before_actv = m.insert_instruction(ins, make_op("add"), it_before_actv, pphi_ct);
+            auto pphi_ct   = sm.insert_instruction(pos, make_op("mul"), pphi_brcst, ct1);
+            it_before_actv = sm.insert_instruction(pos, make_op("add"), it_before_actv, pphi_ct);
 
-            auto pphf_ct   = m.insert_instruction(ins, make_op("mul"), pphf_brcst, sic);
-            ft_before_actv = m.insert_instruction(ins, make_op("add"), ft_before_actv, pphf_ct);
+            auto pphf_ct   = sm.insert_instruction(pos, make_op("mul"), pphf_brcst, ct1);
+            ft_before_actv = sm.insert_instruction(pos, make_op("add"), ft_before_actv, pphf_ct);
         }
-        auto it = m.insert_instruction(ins, actv_func1, it_before_actv);
-        auto ft = m.insert_instruction(ins, actv_func1, ft_before_actv);
-        auto ct = m.insert_instruction(ins, actv_func2, ct_before_actv);
+        auto it = sm.insert_instruction(pos, actv_func1, it_before_actv);
+        auto ft = sm.insert_instruction(pos, actv_func1, ft_before_actv);
+        auto ct = sm.insert_instruction(pos, actv_func2, ct_before_actv);
 
         // equation Ct = ft (.) Ct-1 + it (.) ct
-        auto ft_cell = m.insert_instruction(ins, make_op("mul"), ft, sic);
-        auto it_ct   = m.insert_instruction(ins, make_op("mul"), it, ct);
-        auto cellt   = m.insert_instruction(ins, make_op("add"), ft_cell, it_ct);
+        auto ft_cell = sm.insert_instruction(pos, make_op("mul"), ft, ct1);
+        auto it_ct   = sm.insert_instruction(pos, make_op("mul"), it, ct);
+        auto cellt   = sm.insert_instruction(pos, make_op("add"), ft_cell, it_ct);
 
         if(pph != m.end())
         {
-            auto ppho_cellt = m.insert_instruction(ins, make_op("mul"), ppho_brcst, cellt);
-            ot_before_actv  = m.insert_instruction(ins, make_op("add"), ot_before_actv, ppho_cellt);
+            auto ppho_cellt = sm.insert_instruction(pos, make_op("mul"), ppho_brcst, cellt);
+            ot_before_actv = sm.insert_instruction(pos, make_op("add"), ot_before_actv, ppho_cellt);
         }
-        auto ot = m.insert_instruction(ins, actv_func1, ot_before_actv);
+        auto ot = sm.insert_instruction(pos, actv_func1, ot_before_actv);
 
         // Ht = ot (.) h(Ct)
-        auto h_cellt = m.insert_instruction(ins, actv_func3, cellt);
-        auto ht      = m.insert_instruction(ins, make_op("mul"), ot, h_cellt);
+        auto h_cellt = sm.insert_instruction(pos, actv_func3, cellt);
+        auto ht      = sm.insert_instruction(pos, make_op("mul"), ot, h_cellt);
+        return {ht, cellt};
+    };
+
+    if(looped)
+    {
+        auto xw   = project_sequence(m, ins, seq, seq_len, tsw, ub_wrb);
+        auto outs = loop_cell(is_forward, mpm, ins, xw, {sih, sic}, step);
+        auto hs_outs   = split_loop_output(m, ins, is_forward, outs[0], outs[2]);
+        auto cell_outs = split_loop_output(m, ins, is_forward, outs[1], outs[3]);
+        return {hs_outs[0], hs_outs[1], cell_outs[0], cell_outs[1]};
+    }
+
+    for(long i = 0; i < seq_len; ++i)
+    {
+        long seq_index = is_forward ? i : (seq_len - 1 - i);
+        auto xt        = m.insert_instruction(
+            ins,
+            make_op("slice", {{"axes", {0}}, {"starts", {seq_index}}, {"ends", {seq_index + 1}}}),
+            seq);
+        auto cont_xt = m.insert_instruction(ins, make_op("contiguous"), xt);
+        xt           = m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), cont_xt);
+
+        auto xt_tsw = m.insert_instruction(ins, make_op("dot"), xt, tsw);
+        auto states = step(m, ins, xt_tsw, {sih, sic});
+        auto ht     = states[0];
+        auto cellt  = states[1];
 
         sic = cellt;
         sih = ht;
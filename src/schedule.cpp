@@ -452,8 +452,7 @@ struct stream_info
         for(auto ins : iterator_for(m))
             ins2index[ins] = index_total++;
 
-        std::vector<conflict_table_type> thread_conflict_tables(
-            std::thread::hardware_concurrency());
+        std::vector<conflict_table_type> thread_conflict_tables(get_num_threads());
         std::vector<instruction_ref> index_to_ins;
         index_to_ins.reserve(concur_ins.size());
         std::transform(concur_ins.begin(),
@@ -54,7 +54,7 @@ void migraphx_from_value(const value& v, argument& a)
     if(v.contains("data"))
     {
         literal l = migraphx::from_value<literal>(v);
-        a         = l.get_argument();
+        a         = l.get_argument().writable();
     }
     else if(v.contains("sub"))
     {
@@ -0,0 +1,59 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/session.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+session::session(const program& p) : prog(&p), contexts(p.create_contexts()) {}
+
+session::session(const session& s) : session(s.get_program()) {}
+
+session& session::operator=(const session& s)
+{
+    if(this == &s)
+        return *this;
+    this->finish();
+    prog     = &s.get_program();
+    contexts = prog->create_contexts();
+    return *this;
+}
+
+std::vector<argument> session::eval(parameter_map params)
+{
+    return prog->eval_with_context(contexts, std::move(params));
+}
+
+void session::finish() const
+{
+    for(const auto& ctx : contexts)
+        ctx.finish();
+}
+
+const program& session::get_program() const { return *prog; }
+
+std::vector<context>& session::get_contexts() { return contexts; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,106 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/slab_allocator.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct slab_pool
+{
+    std::size_t block_size = 0;
+    // Blocks that have been freed, which are reused before carving new ones from a chunk
+    std::vector<void*> free_blocks = {};
+    char* current                  = nullptr;
+    std::size_t nblocks            = 0;
+    std::size_t used               = 0;
+    std::size_t next_nblocks       = 64;
+};
+
+struct slab_arena_impl
+{
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::vector<slab_pool> pools;
+    std::size_t reserved = 0;
+
+    static std::size_t round_size(std::size_t size)
+    {
+        const std::size_t align = alignof(std::max_align_t);
+        return (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    }
+
+    slab_pool& get_pool(std::size_t size)
+    {
+        auto block_size = round_size(size);
+        auto it = std::find_if(pools.begin(), pools.end(), [&](const slab_pool& pool) {
+            return pool.block_size == block_size;
+        });
+        if(it != pools.end())
+            return *it;
+        pools.push_back({block_size});
+        return pools.back();
+    }
+
+    void* allocate(std::size_t size)
+    {
+        auto& pool = get_pool(size);
+        if(not pool.free_blocks.empty())
+        {
+            void* result = pool.free_blocks.back();
+            pool.free_blocks.pop_back();
+            return result;
+        }
+        if(pool.current == nullptr or pool.used == pool.nblocks)
+        {
+            auto bytes = pool.block_size * pool.next_nblocks;
+            chunks.emplace_back(new char[bytes]); // NOLINT
+            reserved += bytes;
+            pool.current = chunks.back().get();
+            pool.nblocks = pool.next_nblocks;
+            pool.used    = 0;
+            // Grow the chunks so large modules only need a few of them
+            pool.next_nblocks = std::min<std::size_t>(pool.next_nblocks * 2, 16384);
+        }
+        void* result = pool.current + pool.used * pool.block_size;
+        pool.used++;
+        return result;
+    }
+
+    void deallocate(void* p, std::size_t size) { get_pool(size).free_blocks.push_back(p); }
+};
+
+slab_arena::slab_arena() : impl(std::make_unique<slab_arena_impl>()) {}
+
+slab_arena::~slab_arena() = default;
+
+void* slab_arena::allocate(std::size_t size) { return impl->allocate(size); }
+
+void slab_arena::deallocate(void* p, std::size_t size) { impl->deallocate(p, size); }
+
+std::size_t slab_arena::reserved() const { return impl->reserved; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,259 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/time.hpp>
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+namespace {
+
+struct shapes_hash
+{
+    std::size_t operator()(const std::vector<shape>& shapes) const
+    {
+        std::size_t seed = 0;
+        for(const auto& s : shapes)
+        {
+            hash_combine(seed, static_cast<int>(s.type()));
+            for(auto len : s.lens())
+                hash_combine(seed, len);
+            for(auto stride : s.strides())
+                hash_combine(seed, stride);
+        }
+        return seed;
+    }
+};
+
+struct specialization_entry
+{
+    std::vector<shape> shapes;
+    program prog;
+    std::size_t bytes = 0;
+};
+
+// Round each dimension of s that may vary up to the first bucket boundary the parameter allows
+shape bucket_shape(const std::string& name,
+                   const shape& param_shape,
+                   const shape& s,
+                   const std::vector<std::size_t>& buckets)
+{
+    if(not param_shape.dynamic())
+    {
+        if(param_shape.lens() != s.lens())
+            MIGRAPHX_THROW("SPECIALIZATION_CACHE: Shape mismatch for parameter: " + name);
+        return s;
+    }
+    const auto& dds = param_shape.dyn_dims();
+    if(dds.size() != s.ndim())
+        MIGRAPHX_THROW("SPECIALIZATION_CACHE: Rank mismatch for parameter: " + name);
+    auto lens = s.lens();
+    for(auto i : range(lens.size()))
+    {
+        const auto& dd = dds[i];
+        if(lens[i] < dd.min or lens[i] > dd.max)
+            MIGRAPHX_THROW("SPECIALIZATION_CACHE: Dimension " + std::to_string(i) +
+                           " of parameter " + name + " is out of range");
+        if(dd.is_fixed())
+            continue;
+        auto it = std::find_if(buckets.begin(), buckets.end(), [&](auto b) {
+            return b >= lens[i] and b <= dd.max;
+        });
+        if(it != buckets.end())
+            lens[i] = *it;
+    }
+    if(lens == s.lens())
+        return s;
+    return {s.type(), lens};
+}
+
+// Copy a into the top left corner of a zero filled argument of shape s
+argument pad_argument(const argument& a, const shape& s)
+{
+    auto result     = fill_argument(s, 0);
+    auto in_shape   = a.get_shape();
+    auto type_size  = s.type_size();
+    const char* src = a.data();
+    char* dst       = result.data();
+    shape_for_each(in_shape, [&](const auto& idx) {
+        std::copy_n(
+            src + in_shape.index(idx) * type_size, type_size, dst + s.index(idx) * type_size);
+    });
+    return result;
+}
+
+// Estimate of the memory needed by the instructions that allocate their output
+std::size_t estimate_bytes(const program& p)
+{
+    std::size_t bytes = 0;
+    const auto* mm    = p.get_main_module();
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name().front() == '@')
+            continue;
+        if(ins->get_operator().output_alias(to_shapes(ins->inputs())) >= 0)
+            continue;
+        bytes += ins->get_shape().bytes();
+    }
+    return bytes;
+}
+
+} // namespace
+
+struct specialization_cache_impl
+{
+    using entry_list = std::list<specialization_entry>;
+
+    program prog;
+    target t;
+    compile_options options;
+    specialization_options sp_options;
+    std::vector<std::string> param_names;
+    std::unordered_map<std::string, shape> param_shapes;
+    entry_list entries;
+    std::unordered_map<std::vector<shape>, entry_list::iterator, shapes_hash> lookup;
+    std::size_t total_bytes = 0;
+    specialization_stats stats;
+
+    std::vector<shape> get_shapes(parameter_map& params, bool pad)
+    {
+        std::vector<shape> result;
+        result.reserve(param_names.size());
+        for(const auto& name : param_names)
+        {
+            auto it = params.find(name);
+            if(it == params.end())
+                MIGRAPHX_THROW("SPECIALIZATION_CACHE: Missing parameter: " + name);
+            auto s = bucket_shape(
+                name, param_shapes.at(name), it->second.get_shape(), sp_options.buckets);
+            if(pad and s != it->second.get_shape())
+                it->second = pad_argument(it->second, s);
+            result.push_back(s);
+        }
+        return result;
+    }
+
+    program specialize(const std::vector<shape>& shapes) const
+    {
+        program p = prog;
+        auto* mm  = p.get_main_module();
+        module m{"main"};
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        for(auto i : range(param_names.size()))
+        {
+            auto param     = mm->get_parameter(param_names[i]);
+            map_ins[param] = m.add_parameter(param_names[i], shapes[i]);
+        }
+        auto outputs = m.add_instructions(mm, &map_ins);
+        m.add_return(outputs);
+        *mm = std::move(m);
+        return p;
+    }
+
+    program& get(const std::vector<shape>& shapes)
+    {
+        auto it = lookup.find(shapes);
+        if(it != lookup.end())
+        {
+            stats.hits++;
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->prog;
+        }
+        stats.misses++;
+        specialization_entry e{shapes, specialize(shapes)};
+        stats.compile_time += time<std::chrono::duration<double, std::milli>>(
+            [&] { e.prog.compile(t, options); });
+        e.bytes = estimate_bytes(e.prog);
+        total_bytes += e.bytes;
+        entries.push_front(std::move(e));
+        lookup.emplace(shapes, entries.begin());
+        evict();
+        return entries.front().prog;
+    }
+
+    bool over_limit() const
+    {
+        return (sp_options.max_entries > 0 and entries.size() > sp_options.max_entries) or
+               (sp_options.max_bytes > 0 and total_bytes > sp_options.max_bytes);
+    }
+
+    // The most recently used program is always kept even when it exceeds the limits on its own
+    void evict()
+    {
+        while(entries.size() > 1 and over_limit())
+        {
+            const auto& last = entries.back();
+            total_bytes -= last.bytes;
+            lookup.erase(last.shapes);
+            entries.pop_back();
+            stats.evictions++;
+        }
+    }
+};
+
+specialization_cache::specialization_cache(program p,
+                                           target t,
+                                           compile_options options,
+                                           specialization_options sp_options)
+    : impl(std::make_shared<specialization_cache_impl>())
+{
+    if(p.is_compiled())
+        MIGRAPHX_THROW("SPECIALIZATION_CACHE: Program is already compiled");
+    impl->param_names  = p.get_parameter_names();
+    impl->param_shapes = p.get_parameter_shapes();
+    impl->prog         = std::move(p);
+    impl->t            = std::move(t);
+    impl->options      = options;
+    impl->sp_options   = std::move(sp_options);
+    std::sort(impl->sp_options.buckets.begin(), impl->sp_options.buckets.end());
+}
+
+std::vector<argument> specialization_cache::eval(parameter_map params)
+{
+    auto shapes = impl->get_shapes(params, true);
+    return impl->get(shapes).eval(std::move(params));
+}
+
+const program& specialization_cache::get_program(const parameter_map& params)
+{
+    auto copy = params;
+    return impl->get(impl->get_shapes(copy, false));
+}
+
+specialization_stats specialization_cache::get_stats() const { return impl->stats; }
+
+std::size_t specialization_cache::size() const { return impl->entries.size(); }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -35,8 +35,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_convolution
-    : dnnl_extend_op<dnnl_convolution, dnnl::convolution_forward, op::convolution>
+template <class Derived, class Op>
+struct dnnl_convolution_base : dnnl_extend_op<Derived, dnnl::convolution_forward, Op>
 {
     std::vector<int> arg_map(int) const
     {
@@ -45,7 +45,8 @@ struct dnnl_convolution
 
     shape adjust_shape(const shape& x, int i, const shape& output) const
     {
-        auto s = base_adjust_shape(x, output);
+        const auto& op = this->op;
+        auto s         = this->base_adjust_shape(x, output);
         if(i == 1 and op.group > 1)
         {
             // TODO: Add support for transposed weights
@@ -62,6 +63,7 @@ struct dnnl_convolution
     dnnl::convolution_forward::desc
     get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
+        const auto& op = this->op;
         // In DNNL dilation is zero-based
         auto dilation = op.dilation;
         std::transform(
@@ -81,6 +83,16 @@ struct dnnl_convolution
     }
 };
 
+struct dnnl_convolution : dnnl_convolution_base<dnnl_convolution, op::convolution>
+{
+};
+
+// s8/u8 convolution accumulated in s32
+struct dnnl_quant_convolution
+    : dnnl_convolution_base<dnnl_quant_convolution, op::quant_convolution>
+{
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
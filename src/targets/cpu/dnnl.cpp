@@ -50,7 +50,10 @@ namespace cpu {
 dnnl_context& get_dnnl_context()
 {
     static dnnl_context ctx{}; // NOLINT
-    return ctx;
+    // Streams can't be shared between threads, so each thread executes the primitives on its own
+    // stream of the same engine
+    thread_local dnnl_context thread_ctx{ctx.engine}; // NOLINT
+    return thread_ctx;
 }
 
 #ifdef __clang__
@@ -64,6 +67,7 @@ dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t)
     switch(t)
     {
     case st::half_type: return dt::f16;
+    case st::bf16_type: return dt::bf16;
     case st::float_type: return dt::f32;
     case st::int32_type: return dt::s32;
     case st::int8_type: return dt::s8;
@@ -105,6 +109,65 @@ dnnl::memory to_dnnl_memory(const argument& a)
     return to_dnnl_memory(to_dnnl_memory_desc(a.get_shape()), a);
 }
 
+// The bytes of a memory desc are only meaningful to the dnnl version that wrote them, so they are
+// stored after the version, and a layout saved by another version is rejected when it is loaded
+static const std::string& dnnl_version_string()
+{
+    static const std::string result = [] {
+        const auto* v = dnnl::version();
+        return std::to_string(v->major) + "." + std::to_string(v->minor) + "." +
+               std::to_string(v->patch) + "+" + v->hash;
+    }();
+    return result;
+}
+
+std::vector<std::uint8_t> to_dnnl_layout_bytes(const dnnl::memory::desc& desc)
+{
+    const auto& version = dnnl_version_string();
+    const auto* data    = reinterpret_cast<const std::uint8_t*>(&desc.data);
+    std::vector<std::uint8_t> result(version.begin(), version.end());
+    result.push_back(0);
+    result.insert(result.end(), data, data + sizeof(desc.data));
+    return result;
+}
+
+dnnl::memory::desc from_dnnl_layout_bytes(const std::vector<std::uint8_t>& bytes)
+{
+    dnnl::memory::desc desc;
+    auto sep = std::find(bytes.begin(), bytes.end(), 0);
+    if(sep == bytes.end())
+        MIGRAPHX_THROW("Invalid dnnl layout without a dnnl version");
+    std::string version(bytes.begin(), sep);
+    if(version != dnnl_version_string())
+        MIGRAPHX_THROW("dnnl layout was saved with dnnl " + version + ", but dnnl " +
+                       dnnl_version_string() + " is loaded");
+    auto first = std::next(sep);
+    auto size  = static_cast<std::size_t>(bytes.end() - first);
+    if(size != sizeof(desc.data))
+        MIGRAPHX_THROW("Invalid dnnl layout of " + std::to_string(size) + " bytes");
+    std::copy(first, bytes.end(), reinterpret_cast<std::uint8_t*>(&desc.data));
+    return desc;
+}
+
+argument to_dnnl_layout(const argument& a, const dnnl_layout& layout)
+{
+    if(not a.get_shape().standard())
+        MIGRAPHX_THROW("Only standard arguments can be reordered to a dnnl layout");
+    argument result{layout.get_shape()};
+    auto desc = from_dnnl_layout_bytes(layout.desc);
+    // The layout may have adjusted the dimensions (ie grouped convolutions) so describe the
+    // standard source with the dimensions of the layout
+    auto dims     = desc.dims();
+    auto src_type = to_dnnl_memory_data_type(a.get_shape().type());
+    dnnl::memory::desc src_desc{dims, src_type, to_dnnl_memory_format_tag(dims.size())};
+    auto src  = to_dnnl_memory(src_desc, a);
+    auto dst  = to_dnnl_memory(desc, result);
+    auto& ctx = get_dnnl_context();
+    dnnl::reorder(src, dst).execute(ctx.stream, src, dst);
+    ctx.stream.wait();
+    return result;
+}
+
 // clang-format off
 #define MIGRAPHX_VISIT_DNNL_ALGO(m) \
         m(undef) \
@@ -34,7 +34,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>
+template <class Derived, class Op>
+struct dnnl_gemm_base : dnnl_extend_op<Derived, dnnl::matmul, Op>
 {
     std::vector<int> arg_map(int) const
     {
@@ -57,6 +58,16 @@ struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>
     }
 };
 
+// f32, bf16 and f16 matmul, where dnnl accumulates the low precision types in f32
+struct dnnl_gemm : dnnl_gemm_base<dnnl_gemm, op::dot>
+{
+};
+
+// s8/u8 matmul accumulated in s32
+struct dnnl_quant_gemm : dnnl_gemm_base<dnnl_quant_gemm, op::quant_dot>
+{
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
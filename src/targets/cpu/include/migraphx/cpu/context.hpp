@@ -27,8 +27,13 @@
 #include <migraphx/config.hpp>
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
+#include <migraphx/cpu/stream.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/cpu/export.h>
+#include <migraphx/argument.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -36,7 +41,51 @@ namespace cpu {
 
 struct context
 {
-    void finish() const {}
+    context() = default;
+    explicit context(std::size_t n) : nstreams(n) {}
+
+    // A copy gets its own streams and preallocated buffers, so that copies can be evaluated at
+    // the same time
+    context(const context& rhs) : nstreams(rhs.nstreams) {}
+    context& operator=(const context& rhs)
+    {
+        if(this == &rhs)
+            return *this;
+        this->finish();
+        preallocations.clear();
+        nstreams       = rhs.nstreams;
+        current_stream = 0;
+        streams        = nullptr;
+        return *this;
+    }
+    context(context&&)            = default;
+    context& operator=(context&&) = default;
+
+    // Buffers for the preallocated parameters, which are allocated the first time they are used
+    // so that every context gets its own
+    std::unordered_map<std::string, argument> preallocations{};
+
+    void finish() const
+    {
+        if(streams != nullptr)
+            streams->sync();
+    }
+
+    std::size_t stream_count() const { return nstreams; }
+
+    void set_stream(std::size_t n) { current_stream = n; }
+
+    stream& get_stream() { return get_streams().get_stream(current_stream); }
+
+    event& get_event(std::size_t i) { return get_streams().get_event(i); }
+
+    argument get_preallocation(const std::string& id, const shape& s)
+    {
+        auto it = preallocations.find(id);
+        if(it == preallocations.end())
+            it = preallocations.emplace(id, argument{s}).first;
+        return it->second;
+    }
 
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
@@ -49,6 +98,19 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    private:
+    // The streams are created the first time they are used, so that every context gets its own
+    stream_set& get_streams()
+    {
+        if(streams == nullptr)
+            streams = std::make_unique<stream_set>(nstreams);
+        return *streams;
+    }
+
+    std::size_t nstreams                = get_stream_count();
+    std::size_t current_stream          = 0;
+    std::unique_ptr<stream_set> streams = nullptr;
 };
 
 } // namespace cpu
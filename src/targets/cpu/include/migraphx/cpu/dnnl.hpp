@@ -29,6 +29,7 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/serialize.hpp>
 #include <unordered_map>
 #include <migraphx/errors.hpp>
 #include <migraphx/assert.hpp>
@@ -55,6 +56,7 @@ struct dnnl_context
     dnnl::engine engine;
     dnnl::stream stream;
     dnnl_context() : engine(dnnl::engine::kind::cpu, 0), stream(engine) {}
+    dnnl_context(const dnnl::engine& e) : engine(e), stream(engine) {}
 };
 
 dnnl_context& get_dnnl_context();
@@ -79,6 +81,57 @@ dnnl::algorithm to_dnnl_algo(const std::string& name);
 
 std::string to_string(const dnnl::algorithm& algo);
 
+std::vector<std::uint8_t> to_dnnl_layout_bytes(const dnnl::memory::desc& desc);
+
+dnnl::memory::desc from_dnnl_layout_bytes(const std::vector<std::uint8_t>& bytes);
+
+// A memory layout for one dnnl argument that is chosen by dnnl instead of being described by the
+// strides of the shape. An empty desc will let the primitive pick the layout (format_tag::any),
+// which is resolved by compile. Once resolved, the argument is stored as an opaque byte buffer.
+struct dnnl_layout : reflect_equality<dnnl_layout>
+{
+    int arg = 0;
+    shape logical;
+    std::vector<std::uint8_t> desc;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.arg, "arg"), f(self.logical, "logical"), f(self.desc, "desc"));
+    }
+
+    bool resolved() const { return not desc.empty(); }
+
+    dnnl::memory::desc get_desc(const shape& adjusted) const
+    {
+        if(not resolved())
+            return {to_dnnl_dims(adjusted.lens()),
+                    to_dnnl_memory_data_type(adjusted.type()),
+                    dnnl::memory::format_tag::any};
+        return from_dnnl_layout_bytes(desc);
+    }
+
+    shape get_shape() const
+    {
+        if(not resolved())
+            return logical;
+        return {shape::uint8_type, {from_dnnl_layout_bytes(desc).get_size()}};
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const dnnl_layout& x)
+    {
+        os << "{arg=" << x.arg << ",logical=" << x.logical << ",";
+        if(x.resolved())
+            os << "packed=" << x.get_shape().bytes();
+        else
+            os << "any";
+        os << "}";
+        return os;
+    }
+};
+
+argument to_dnnl_layout(const argument& a, const dnnl_layout& layout);
+
 struct post_op : reflect_equality<post_op>, reflect_stream<post_op>
 {
     std::string algo;
@@ -108,12 +161,13 @@ template <class Derived, class Primitive>
 struct dnnl_op : auto_register_op<Derived>
 {
     std::vector<post_op> post_ops;
+    std::vector<dnnl_layout> layouts;
     std::function<argument(context& ctx, const std::vector<argument>& args)> execute;
 
     template <class Self, class F>
     static auto reflect_base(Self& self, F f)
     {
-        return pack(f(self.post_ops, "post_ops"));
+        return pack(f(self.post_ops, "post_ops"), f(self.layouts, "layouts"));
     }
 
     template <class Self, class F>
@@ -236,18 +290,75 @@ struct dnnl_op : auto_register_op<Derived>
         });
         return m;
     }
+    const dnnl_layout* find_layout(int arg) const
+    {
+        auto it = std::find_if(
+            layouts.begin(), layouts.end(), [&](const auto& layout) { return layout.arg == arg; });
+        if(it == layouts.end())
+            return nullptr;
+        return &*it;
+    }
+    // Replace the shapes of arguments with a dnnl layout by the shape they represent
+    std::vector<shape> to_logical_shapes(std::vector<shape> inputs) const
+    {
+        auto m = create_arg_map(inputs.size());
+        for(int i = 0; i < inputs.size(); i++)
+        {
+            const auto* layout = find_layout(m[i]);
+            if(layout != nullptr)
+                inputs[i] = layout->logical;
+        }
+        return inputs;
+    }
+    shape to_logical_output(const shape& s) const
+    {
+        const auto* layout = find_layout(MIGRAPHX_DNNL_PREFIX(ARG_DST));
+        if(layout == nullptr)
+            return s;
+        return layout->logical;
+    }
+    shape to_layout_output(const shape& s) const
+    {
+        const auto* layout = find_layout(MIGRAPHX_DNNL_PREFIX(ARG_DST));
+        if(layout == nullptr)
+            return s;
+        return layout->get_shape();
+    }
+    dnnl::memory::desc to_arg_memory_desc(int arg, const shape& s) const
+    {
+        const auto* layout = find_layout(arg);
+        if(layout == nullptr)
+            return to_dnnl_memory_desc(s);
+        return layout->get_desc(s);
+    }
     std::unordered_map<int, dnnl::memory::desc>
     to_memory_desc(const shape& output_shape, const std::vector<shape>& inputs) const
     {
         const auto& self = static_cast<const Derived&>(*this);
+        auto output      = to_logical_output(output_shape);
+        auto linputs     = to_logical_shapes(inputs);
+        auto dst         = self.adjust_shape(output, linputs.size(), output);
         std::unordered_map<int, dnnl::memory::desc> result;
         result[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
-            to_dnnl_memory_desc(self.adjust_shape(output_shape, inputs.size(), output_shape));
-        auto m = create_arg_map(inputs.size());
-        assert(m.size() >= inputs.size());
-        for(int i = 0; i < inputs.size(); i++)
+            to_arg_memory_desc(MIGRAPHX_DNNL_PREFIX(ARG_DST), dst);
+        auto m = create_arg_map(linputs.size());
+        assert(m.size() >= linputs.size());
+        for(int i = 0; i < linputs.size(); i++)
         {
-            result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i, output_shape));
+            result[m[i]] = to_arg_memory_desc(m[i], self.adjust_shape(linputs[i], i, output));
+        }
+        return result;
+    }
+    // Fill in the layouts that were left for the primitive to choose
+    template <class PrimitiveDesc>
+    std::vector<dnnl_layout> resolve_layouts(const PrimitiveDesc& pd) const
+    {
+        auto result = layouts;
+        for(auto& layout : result)
+        {
+            if(layout.resolved())
+                continue;
+            layout.desc = to_dnnl_layout_bytes(pd.query_md(dnnl::query::exec_arg_md, layout.arg));
         }
         return result;
     }
@@ -283,13 +394,16 @@ struct dnnl_op : auto_register_op<Derived>
     {
         return typename Primitive::primitive_desc(desc, attr, get_dnnl_context().engine);
     }
-    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    auto make_primitive_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         const auto& self = static_cast<const Derived&>(*this);
         auto desc        = self.get_desc(m);
         auto attr        = MIGRAPHX_ASSERT_NO_THROW(this->get_primitive_attr(m));
-        auto pd          = self.get_primitive_desc(desc, attr);
-        return Primitive(pd);
+        return self.get_primitive_desc(desc, attr);
+    }
+    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        return Primitive(make_primitive_desc(m));
     }
     argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
     {
@@ -305,9 +419,13 @@ struct dnnl_op : auto_register_op<Derived>
         // Compensate for allocation
         inputs.pop_back();
         auto md        = to_memory_desc(output_shape, inputs);
-        auto prim      = get_primitive(md);
+        auto pd        = make_primitive_desc(md);
+        auto prim      = Primitive(pd);
         auto impl_name = impl(prim);
-        return {{"impl", impl_name}};
+        value result   = {{"impl", impl_name}};
+        if(not layouts.empty())
+            result["layouts"] = migraphx::to_value(resolve_layouts(pd));
+        return result;
     }
 
     void finalize(context&, const shape& output_shape, std::vector<shape> inputs)
@@ -316,6 +434,10 @@ struct dnnl_op : auto_register_op<Derived>
         inputs.pop_back();
         const auto& self = static_cast<const Derived&>(*this);
         auto name        = self.name();
+        if(std::any_of(layouts.begin(), layouts.end(), [](const auto& layout) {
+               return not layout.resolved();
+           }))
+            MIGRAPHX_THROW(name + ": Unresolved dnnl layout");
         auto md          = to_memory_desc(output_shape, inputs);
         auto prim        = get_primitive(md);
         auto arg_lookup  = create_arg_map(inputs.size());
@@ -427,10 +549,20 @@ struct dnnl_extend_op : dnnl_op<Derived, Primitive>
         // Compensate for allocation
         inputs.pop_back();
         self.required(check_shapes(inputs, self));
-        auto r = migraphx::compute_shape(op, this->trim_post_op_inputs(inputs));
+        auto r = migraphx::compute_shape(
+            op, this->trim_post_op_inputs(this->to_logical_shapes(inputs)));
         // Call to get_primitive to make sure an algo is available
         this->get_primitive(this->to_memory_desc(r, inputs));
-        return r;
+        return this->to_layout_output(r);
+    }
+    op_cost estimate_cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::estimate_cost(
+            op,
+            this->to_logical_output(output),
+            this->trim_post_op_inputs(this->to_logical_shapes(inputs)));
     }
 };
 
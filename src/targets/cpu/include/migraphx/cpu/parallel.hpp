@@ -25,8 +25,10 @@
 #define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_PARALLEL_HPP
 
 // #define MIGRAPHX_DISABLE_OMP
+#include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <cstddef>
 #include <migraphx/config.hpp>
 #ifdef MIGRAPHX_DISABLE_OMP
 #include <migraphx/par_for.hpp>
@@ -47,9 +49,25 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+// Upper bound on the threads that parallel_for uses from the calling thread, or 0 when there is
+// none. Concurrent streams set it so that the operators running at the same time split the cores.
+inline std::size_t& thread_budget()
+{
+    thread_local std::size_t n = 0; // NOLINT
+    return n;
+}
+
+inline std::size_t limit_threads(std::size_t n)
+{
+    auto budget = thread_budget();
+    if(budget == 0)
+        return n;
+    return std::min(n, budget);
+}
+
 #ifdef MIGRAPHX_DISABLE_OMP
 
-inline std::size_t max_threads() { return std::thread::hardware_concurrency(); }
+inline std::size_t max_threads() { return limit_threads(get_num_threads()); }
 
 template <class F>
 void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
@@ -60,29 +78,12 @@ void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
     else
     {
-        std::vector<joinable_thread> threads(threadsize);
-// Using const here causes gcc 5 to ICE
-#if(!defined(__GNUC__) || __GNUC__ != 5)
-        const
-#endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work] {
-            auto result = joinable_thread([=]() mutable {
-                assert(work < n);
-                f(work, std::min(n, work + grainsize));
-            });
-            work += grainsize;
-            return result;
-        });
-        // cppcheck-suppress unsignedLessThanZero
-        assert(work >= n);
+        parallel_range_for(n, threadsize, [&](auto start, auto last, auto) { f(start, last); });
     }
 }
 #else
 
-inline std::size_t max_threads() { return omp_get_max_threads(); }
+inline std::size_t max_threads() { return limit_threads(omp_get_max_threads()); }
 
 template <class F>
 void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
@@ -104,6 +105,40 @@ void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
 }
 #endif
+// Sets the thread budget of the calling thread for its lifetime. With openmp the number of
+// threads of the calling thread is set as well, since dnnl reads it for its own parallel regions.
+struct thread_budget_scope
+{
+    explicit thread_budget_scope(std::size_t n) : prev(thread_budget())
+    {
+        if(n == 0)
+            return;
+        thread_budget() = n;
+#ifndef MIGRAPHX_DISABLE_OMP
+        prev_omp = omp_get_max_threads();
+        omp_set_num_threads(n);
+#endif
+    }
+
+    thread_budget_scope(const thread_budget_scope&)            = delete;
+    thread_budget_scope& operator=(const thread_budget_scope&) = delete;
+
+    ~thread_budget_scope()
+    {
+        thread_budget() = prev;
+#ifndef MIGRAPHX_DISABLE_OMP
+        if(prev_omp > 0)
+            omp_set_num_threads(prev_omp);
+#endif
+    }
+
+    private:
+    std::size_t prev = 0;
+#ifndef MIGRAPHX_DISABLE_OMP
+    int prev_omp = 0;
+#endif
+};
+
 template <class F>
 void parallel_for(std::size_t n, std::size_t min_grain, F f)
 {
@@ -28,6 +28,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/context.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/reduce_dims.hpp>
 #include <migraphx/register_op.hpp>
@@ -364,6 +365,11 @@ struct cpu_unary : reduce_dims_base, auto_register_op<cpu_unary<Op>>
     {
         return shapes.size() - 1;
     }
+
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return memory_cost(output, {inputs.begin(), inputs.end() - 1}, output.elements());
+    }
 };
 
 template <class Op>
@@ -405,6 +411,11 @@ struct cpu_binary : reduce_dims_base, auto_register_op<cpu_binary<Op>>
     {
         return shapes.size() - 1;
     }
+
+    op_cost estimate_cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return memory_cost(output, {inputs.begin(), inputs.end() - 1}, output.elements());
+    }
 };
 
 } // namespace cpu
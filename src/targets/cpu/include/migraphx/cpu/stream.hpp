@@ -0,0 +1,113 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_CPU_STREAM_HPP
+#define MIGRAPHX_GUARD_CPU_STREAM_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/cpu/export.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// A latch that can be reused across evaluations. Every record takes a new ticket when it is
+/// issued and a wait blocks until the last ticket issued before it has been signaled.
+struct MIGRAPHX_CPU_EXPORT event
+{
+    std::size_t issue();
+    std::size_t last_issued() const;
+    void signal(std::size_t ticket);
+    void wait(std::size_t ticket) const;
+
+    private:
+    mutable std::mutex m;
+    mutable std::condition_variable cv;
+    std::size_t issued   = 0;
+    std::size_t signaled = 0;
+};
+
+/// Runs work in order on its own thread, with each task limited to budget threads. A stream
+/// without a thread runs the work on the calling thread as soon as it is submitted.
+struct MIGRAPHX_CPU_EXPORT stream
+{
+    stream(bool async, std::size_t budget);
+    stream(const stream&)            = delete;
+    stream& operator=(const stream&) = delete;
+    ~stream();
+
+    void submit(std::function<void()> f);
+    void record(event& e);
+    void wait(event& e);
+    /// Waits until all the submitted work has run, and rethrows the first error it threw
+    void sync();
+
+    private:
+    void work();
+
+    std::size_t budget = 0;
+    std::thread worker;
+    std::deque<std::function<void()>> tasks;
+    std::mutex m;
+    std::condition_variable cv;
+    bool busy                = false;
+    bool stop                = false;
+    std::exception_ptr error = nullptr;
+};
+
+/// The streams and events used by one context. Stream 0 runs on the thread that evaluates the
+/// program, every other stream has a thread of its own. When streams are used the threads of
+/// the process are split evenly between them.
+struct MIGRAPHX_CPU_EXPORT stream_set
+{
+    explicit stream_set(std::size_t n);
+
+    stream& get_stream(std::size_t i);
+    event& get_event(std::size_t i);
+    void sync() const;
+
+    private:
+    std::size_t nstreams = 1;
+    std::vector<std::unique_ptr<stream>> streams;
+    std::vector<std::unique_ptr<event>> events;
+};
+
+/// Number of streams the cpu target schedules instructions on. It is set with the
+/// MIGRAPHX_CPU_STREAMS env variable, and defaults to a single stream. More than one stream is
+/// experimental.
+MIGRAPHX_CPU_EXPORT std::size_t get_stream_count();
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_CPU_STREAM_HPP
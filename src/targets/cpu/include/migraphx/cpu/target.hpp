@@ -36,9 +36,12 @@ namespace cpu {
 
 struct MIGRAPHX_CPU_EXPORT target
 {
+    // Number of streams independent branches are scheduled on
+    std::size_t streams = get_stream_count();
+
     std::string name() const;
     std::vector<pass> get_passes(migraphx::context& gctx, const compile_options&) const;
-    migraphx::context get_context() const { return context{}; }
+    migraphx::context get_context() const { return context{streams}; }
     argument copy_to(const argument& arg) const { return arg; }
     argument copy_from(const argument& arg) const { return arg; }
     argument allocate(const shape& s) const;
@@ -57,6 +57,8 @@
 #include <migraphx/match/gelu_erf.hpp>
 #include <migraphx/match/gelu_tanh.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/stringutils.hpp>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -267,6 +269,9 @@ struct cpu_apply
     module* modl;
     std::unordered_map<std::string, std::function<instruction_ref(instruction_ref)>> apply_map{};
     instruction_ref last{};
+    // Whether dnnl has a kernel, for each operator and shapes that were checked
+    std::unordered_map<std::string, bool> dnnl_kernels{};
+    migraphx::context kernel_ctx = context{};
 
     void extend_op(const std::string& op_name, const std::string& cpu_name, bool allocate = true)
     {
@@ -278,6 +283,21 @@ struct cpu_apply
         });
     }
 
+    // Lower to the dnnl kernel for the low precision type when dnnl has an optimized one for this
+    // machine, otherwise compute in float with the float_name op and convert the result back
+    void extend_low_precision_op(const std::string& op_name,
+                                 const std::string& cpu_name,
+                                 const std::string& float_name)
+    {
+        apply_map.emplace(op_name, [=](instruction_ref ins) {
+            auto v  = ins->get_operator().to_value();
+            auto op = make_op(cpu_name, v);
+            if(ins->get_shape().type() == shape::float_type or has_dnnl_kernel(op, ins))
+                return replace(ins, op);
+            return replace_with_float(ins, make_op(float_name, v));
+        });
+    }
+
     void extend_dnnl_algos(const std::string& dnnl_name,
                            const std::vector<std::pair<std::string, std::string>>& algos)
     {
@@ -342,10 +362,13 @@ struct cpu_apply
                           });
         extend_op("concat", "dnnl::concat");
         extend_op("contiguous", "dnnl::reorder");
-        extend_op("convolution", "dnnl::convolution");
+        extend_low_precision_op("convolution", "dnnl::convolution", "dnnl::convolution");
+        extend_low_precision_op(
+            "quant_convolution", "dnnl::quant_convolution", "dnnl::convolution");
 #ifndef MIGRAPHX_ENABLE_ZENDNN
         extend_op("convolution_backwards", "dnnl::convolution_backwards");
-        extend_op("dot", "dnnl::dot");
+        extend_low_precision_op("dot", "dnnl::dot", "dnnl::dot");
+        extend_low_precision_op("quant_dot", "dnnl::quant_dot", "dnnl::dot");
 #endif
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
@@ -476,6 +499,50 @@ struct cpu_apply
         return {r.at<T>()};
     }
 
+    // dnnl falls back to its reference implementation for types the machine has no
+    // instructions for, which is much slower than converting to float. Models repeat the same
+    // operators, so the kernel is only compiled once for each operator and shapes.
+    bool has_dnnl_kernel(operation op, instruction_ref ins)
+    {
+        auto inputs = to_shapes(ins->inputs());
+        inputs.push_back(ins->get_shape());
+        auto key = to_string(op) + to_string_range(inputs);
+        auto it  = dnnl_kernels.find(key);
+        if(it != dnnl_kernels.end())
+            return it->second;
+        bool result = false;
+        try
+        {
+            auto info = op.compile(kernel_ctx, op.compute_shape(inputs), inputs);
+            result    = not(info.contains("impl") and
+                            starts_with(info.at("impl").to<std::string>(), "ref:"));
+        }
+        catch(const std::exception&)
+        {
+            result = false;
+        }
+        dnnl_kernels[key] = result;
+        return result;
+    }
+
+    instruction_ref replace_with_float(instruction_ref ins, const operation& op) const
+    {
+        std::vector<instruction_ref> inputs;
+        std::transform(ins->inputs().begin(),
+                       ins->inputs().end(),
+                       std::back_inserter(inputs),
+                       [&](instruction_ref input) {
+                           return modl->insert_instruction(
+                               ins,
+                               make_op("convert", {{"target_type", shape::float_type}}),
+                               input);
+                       });
+        inputs.push_back(insert_allocation(ins, ins->get_shape().with_type(shape::float_type)));
+        auto result = modl->insert_instruction(ins, op, inputs);
+        return modl->replace_instruction(
+            ins, make_op("convert", {{"target_type", ins->get_shape().type()}}), result);
+    }
+
     instruction_ref replace(instruction_ref ins, const operation& op) const
     {
         return replace(ins, op, ins->inputs());
@@ -0,0 +1,215 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/prepack.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/env.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_DNNL_PREPACK);
+
+struct prepack_plan
+{
+    instruction_ref ins;
+    std::vector<dnnl_layout> layouts;
+    // Layout of a blocked source that has to be reordered back to the standard layout first
+    optional<dnnl_layout> reorder;
+};
+
+static dnnl_layout any_layout(int arg, const shape& s)
+{
+    dnnl_layout result;
+    result.arg     = arg;
+    result.logical = s;
+    return result;
+}
+
+static bool has_binary_post_ops(instruction_ref ins)
+{
+    auto v = ins->get_operator().to_value();
+    return std::any_of(v.at("post_ops").begin(), v.at("post_ops").end(), [](const value& po) {
+        return contains(po.at("algo").to<std::string>(), "binary");
+    });
+}
+
+// The output can stay in a dnnl layout when it is only read as the source of other convolutions
+static bool can_block_output(instruction_ref ins)
+{
+    if(ins->name() != "dnnl::convolution")
+        return false;
+    if(ins->outputs().empty() or has_binary_post_ops(ins))
+        return false;
+    auto alloc = ins->inputs().back();
+    if(alloc->name() != "cpu::allocate" or alloc->outputs().size() != 1)
+        return false;
+    return std::all_of(ins->outputs().begin(), ins->outputs().end(), [&](instruction_ref output) {
+        return output->name() == "dnnl::convolution" and output->inputs().front() == ins and
+               std::count(output->inputs().begin(), output->inputs().end(), ins) == 1;
+    });
+}
+
+static optional<std::vector<dnnl_layout>>
+resolve_layouts(context& ctx, instruction_ref ins, const std::vector<dnnl_layout>& layouts)
+{
+    auto v       = ins->get_operator().to_value();
+    v["layouts"] = migraphx::to_value(layouts);
+    try
+    {
+        auto op   = make_op(ins->name(), v);
+        auto info = compile(op, ctx, ins->get_shape(), to_shapes(ins->inputs()));
+        if(info.contains("impl") and starts_with(info.at("impl").to<std::string>(), "ref:"))
+            return nullopt;
+        return from_value<std::vector<dnnl_layout>>(info.at("layouts"));
+    }
+    catch(const std::exception&)
+    {
+        return nullopt;
+    }
+}
+
+// Picks the layouts for the weights and the output, on top of the layouts that are required
+static optional<prepack_plan>
+plan_with(context& ctx, instruction_ref ins, const std::vector<dnnl_layout>& required)
+{
+    const int weights = MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS);
+    const int dst     = MIGRAPHX_DNNL_PREFIX(ARG_DST);
+    auto w            = ins->inputs().at(1);
+    std::vector<std::vector<dnnl_layout>> candidates;
+    if(w->name() == "@literal" and w->get_shape().standard())
+    {
+        auto with_weights = required;
+        with_weights.push_back(any_layout(weights, w->get_shape()));
+        if(can_block_output(ins))
+        {
+            auto with_output = with_weights;
+            with_output.push_back(any_layout(dst, ins->get_shape()));
+            candidates.push_back(with_output);
+        }
+        candidates.push_back(with_weights);
+    }
+    if(not required.empty())
+        candidates.push_back(required);
+    for(const auto& layouts : candidates)
+    {
+        auto resolved = resolve_layouts(ctx, ins, layouts);
+        if(resolved.has_value())
+            return prepack_plan{ins, *resolved, nullopt};
+    }
+    return nullopt;
+}
+
+static optional<prepack_plan>
+plan_layouts(context& ctx,
+             instruction_ref ins,
+             const std::unordered_map<instruction_ref, dnnl_layout>& blocked)
+{
+    auto x = ins->inputs().front();
+    if(not contains(blocked, x))
+        return plan_with(ctx, ins, {});
+    // The source layout is fixed by the producer and is used when there is a kernel for it
+    auto layout = blocked.at(x);
+    layout.arg  = MIGRAPHX_DNNL_PREFIX(ARG_SRC);
+    auto plan   = plan_with(ctx, ins, {layout});
+    if(plan.has_value())
+        return plan;
+    // Otherwise the source is reordered back to the standard layout
+    plan = plan_with(ctx, ins, {});
+    if(not plan.has_value())
+        plan = prepack_plan{ins, {}, nullopt};
+    plan->reorder = layout;
+    return plan;
+}
+
+static void apply_plan(module& m, const prepack_plan& plan)
+{
+    auto ins    = plan.ins;
+    auto inputs = ins->inputs();
+    if(plan.reorder.has_value())
+    {
+        auto layouts = migraphx::to_value(std::vector<dnnl_layout>{*plan.reorder});
+        auto alloc   = m.insert_instruction(
+            ins, make_op("cpu::allocate", {{"shape", to_value(plan.reorder->logical)}}));
+        inputs.front() = m.insert_instruction(
+            ins, make_op("dnnl::reorder", {{"layouts", layouts}}), inputs.front(), alloc);
+    }
+    for(const auto& layout : plan.layouts)
+    {
+        if(layout.arg == MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS))
+        {
+            auto w       = inputs.at(1);
+            auto packed  = to_dnnl_layout(w->get_literal().get_argument(), layout);
+            inputs.at(1) = m.add_literal(literal{packed.get_shape(), packed.data()});
+        }
+        else if(layout.arg == MIGRAPHX_DNNL_PREFIX(ARG_DST))
+        {
+            inputs.back() = m.insert_instruction(
+                ins, make_op("cpu::allocate", {{"shape", to_value(layout.get_shape())}}));
+        }
+    }
+    auto v       = ins->get_operator().to_value();
+    v["layouts"] = migraphx::to_value(plan.layouts);
+    m.replace_instruction(ins, make_op(ins->name(), v), inputs);
+}
+
+void prepack::apply(module& m) const
+{
+    // Opt-in until the blocked layouts are validated against a dnnl build
+    if(not enabled(MIGRAPHX_ENABLE_DNNL_PREPACK{}))
+        return;
+    std::vector<prepack_plan> plans;
+    std::unordered_map<instruction_ref, dnnl_layout> blocked;
+    for(auto ins : iterator_for(m))
+    {
+        if(not contains(
+               {"dnnl::convolution", "dnnl::dot", "dnnl::quant_convolution", "dnnl::quant_dot"},
+               ins->name()))
+            continue;
+        auto plan = plan_layouts(*ctx, ins, blocked);
+        if(not plan.has_value())
+            continue;
+        for(const auto& layout : plan->layouts)
+        {
+            if(layout.arg == MIGRAPHX_DNNL_PREFIX(ARG_DST))
+                blocked[ins] = layout;
+        }
+        plans.push_back(*plan);
+    }
+    // Rewrite in reverse so the users of a blocked output already expect the dnnl layout when
+    // the shape of the output changes
+    std::for_each(plans.rbegin(), plans.rend(), [&](const auto& plan) { apply_plan(m, plan); });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
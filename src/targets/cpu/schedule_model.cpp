@@ -0,0 +1,236 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/op/identity.hpp>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct record_event
+{
+    std::size_t event = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"));
+    }
+    std::string name() const { return "cpu::record_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.get_stream().record(ctx.get_event(event));
+        return {};
+    }
+};
+
+struct wait_event
+{
+    std::size_t event = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"));
+    }
+    std::string name() const { return "cpu::wait_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.get_stream().wait(ctx.get_event(event));
+        return {};
+    }
+};
+
+struct set_stream
+{
+    std::size_t stream = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.stream, "stream"));
+    }
+    std::string name() const { return "cpu::set_stream"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.set_stream(stream);
+        return {};
+    }
+};
+
+struct finish_streams
+{
+    std::string name() const { return "cpu::finish_streams"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.finish();
+        return {};
+    }
+};
+
+// Runs an operator on the current stream, with the threads of that stream. When async is set
+// the operator writes into the buffer it aliases, so it is queued on the stream and that buffer
+// is returned right away. Otherwise its output is only known once it has run, so the calling
+// thread waits for the stream and the next instructions are not issued until then.
+struct stream_op
+{
+    operation op = op::identity{};
+    bool async   = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.op, "op"), f(self.async, "async"));
+    }
+
+    std::string name() const { return "cpu::stream_op"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        return op.compute_shape(inputs);
+    }
+    argument compute(migraphx::context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args) const
+    {
+        auto& s = any_cast<context>(ctx).get_stream();
+        if(not async)
+        {
+            argument result;
+            s.submit([&] { result = op.compute(ctx, output_shape, args); });
+            s.sync();
+            return result;
+        }
+        s.submit([this, &ctx, output_shape, args] { op.compute(ctx, output_shape, args); });
+        auto result = args.at(op.output_alias(to_shapes(args)));
+        if(result.get_shape() != output_shape)
+            result = result.reshape(output_shape);
+        return result;
+    }
+    void finalize(migraphx::context& ctx, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        op.finalize(ctx, output_shape, inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
+};
+
+MIGRAPHX_REGISTER_OP(record_event)
+MIGRAPHX_REGISTER_OP(wait_event)
+MIGRAPHX_REGISTER_OP(set_stream)
+MIGRAPHX_REGISTER_OP(finish_streams)
+MIGRAPHX_REGISTER_OP(stream_op)
+
+// Submodules are evaluated from inside an operator of the main module, and the outputs of a
+// module without a return are not waited on, so those modules run in order on the calling thread
+static bool is_scheduled(const module& m)
+{
+    return m.name() == "main" and m.begin() != m.end() and
+           std::prev(m.end())->name() == "@return";
+}
+
+std::size_t schedule_model::concurrency() const { return streams; }
+void schedule_model::sched(module& m, instruction_ref ins, std::size_t n) const
+{
+    if(not is_scheduled(m))
+        return;
+    // The outputs are handed to the caller, so every stream has to finish first
+    if(ins->name() == "@return")
+    {
+        m.insert_instruction(ins, finish_streams{});
+        return;
+    }
+    auto last_stream = std::find_if(std::make_reverse_iterator(ins),
+                                    std::make_reverse_iterator(m.begin()),
+                                    [&](auto&& i) { return i.name() == "cpu::set_stream"; });
+    if(last_stream == std::make_reverse_iterator(m.begin()) or
+       any_cast<set_stream>(last_stream->get_operator()).stream != n)
+        m.insert_instruction(ins, set_stream{n});
+    if(not ins->module_inputs().empty())
+    {
+        m.insert_instruction(ins, finish_streams{});
+        return;
+    }
+    auto async = ins->get_operator().output_alias(to_shapes(ins->inputs())) >= 0;
+    m.replace_instruction(ins, stream_op{ins->get_operator(), async}, ins->inputs());
+}
+
+void schedule_model::wait(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    if(not is_scheduled(m))
+        return;
+    m.insert_instruction(ins, wait_event{wait_id});
+}
+void schedule_model::record(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    if(not is_scheduled(m))
+        return;
+    m.insert_instruction(std::next(ins), record_event{wait_id});
+}
+
+static std::unordered_map<std::string, std::size_t> create_weight_map()
+{
+    return {{"cpu::allocate", 0},
+            {"cpu::preallocate", 0},
+            {"dnnl::convolution", 8},
+            {"dnnl::quant_convolution", 8},
+            {"dnnl::convolution_backwards", 8},
+            {"dnnl::pooling", 4},
+            {"dnnl::dot", 4},
+            {"dnnl::quant_dot", 4}};
+}
+
+static const std::unordered_map<std::string, std::size_t>& weight_map()
+{
+    static const std::unordered_map<std::string, std::size_t> m = create_weight_map();
+    return m;
+}
+
+std::size_t schedule_model::weight(const operation& op) const
+{
+    if(weight_map().count(op.name()) == 0)
+    {
+        return 2;
+    }
+    return weight_map().at(op.name());
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,186 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/stream.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_STREAMS)
+
+std::size_t event::issue()
+{
+    std::lock_guard<std::mutex> lock(m);
+    return ++issued;
+}
+
+std::size_t event::last_issued() const
+{
+    std::lock_guard<std::mutex> lock(m);
+    return issued;
+}
+
+void event::signal(std::size_t ticket)
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        signaled = std::max(signaled, ticket);
+    }
+    cv.notify_all();
+}
+
+void event::wait(std::size_t ticket) const
+{
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return signaled >= ticket; });
+}
+
+stream::stream(bool async, std::size_t b) : budget(b)
+{
+    if(async)
+        worker = std::thread([this] { this->work(); });
+}
+
+stream::~stream()
+{
+    if(not worker.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stop = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+void stream::submit(std::function<void()> f)
+{
+    if(not worker.joinable())
+    {
+        thread_budget_scope scope{budget};
+        f();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m);
+        tasks.push_back(std::move(f));
+    }
+    cv.notify_all();
+}
+
+void stream::record(event& e)
+{
+    auto ticket = e.issue();
+    this->submit([&e, ticket] { e.signal(ticket); });
+}
+
+void stream::wait(event& e)
+{
+    auto ticket = e.last_issued();
+    this->submit([&e, ticket] { e.wait(ticket); });
+}
+
+void stream::sync()
+{
+    if(not worker.joinable())
+        return;
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return tasks.empty() and not busy; });
+    if(error != nullptr)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+void stream::work()
+{
+    thread_budget_scope scope{budget};
+    for(;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&] { return stop or not tasks.empty(); });
+            if(tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            busy = true;
+        }
+        std::exception_ptr e = nullptr;
+        try
+        {
+            task();
+        }
+        catch(...)
+        {
+            e = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m);
+            busy = false;
+            if(error == nullptr)
+                error = e;
+        }
+        cv.notify_all();
+    }
+}
+
+stream_set::stream_set(std::size_t n) : nstreams(std::max<std::size_t>(n, 1)) {}
+
+stream& stream_set::get_stream(std::size_t i)
+{
+    if(i >= streams.size())
+    {
+        nstreams    = std::max(nstreams, i + 1);
+        auto budget = std::max<std::size_t>(1, max_threads() / nstreams);
+        for(auto j = streams.size(); j <= i; j++)
+            streams.push_back(std::make_unique<stream>(j > 0, budget));
+    }
+    return *streams[i];
+}
+
+event& stream_set::get_event(std::size_t i)
+{
+    while(i >= events.size())
+        events.push_back(std::make_unique<event>());
+    return *events[i];
+}
+
+void stream_set::sync() const
+{
+    for(const auto& s : streams)
+        s->sync();
+}
+
+std::size_t get_stream_count()
+{
+    return std::max<std::size_t>(1, value_of(MIGRAPHX_CPU_STREAMS{}, 1));
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -33,8 +33,10 @@
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/eliminate_convert.hpp>
+#include <migraphx/fuse_pointwise.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
+#include <migraphx/register_op.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/replace_allocate.hpp>
 #include <migraphx/rewrite_pooling.hpp>
@@ -45,6 +47,8 @@
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/prepack.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
 #include <migraphx/cpu/target.hpp>
@@ -53,11 +57,15 @@
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_DNNL_LOW_PRECISION);
+
 std::string target::name() const { return "cpu"; }
 
 // cppcheck-suppress constParameterReference
@@ -67,11 +75,48 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
     std::set<std::string> unsupported_ops{
         "all", "scatternd_add", "scatternd_mul", "scatternd_none"};
+    // dnnl has kernels for these types, but only the ops in native_ops keep using them. The
+    // lowering still falls back to float when the machine has no fast kernel for the type. These
+    // kernels are opt-in until they are validated against a dnnl build, so by default the types
+    // are converted to float for every op.
+    std::set<shape::type_t> low_precision_types = {shape::type_t::half_type,
+                                                   shape::type_t::bf16_type,
+                                                   shape::type_t::int8_type,
+                                                   shape::type_t::uint8_type,
+                                                   shape::type_t::int32_type};
+    std::set<std::string> native_ops            = {"convolution",
+                                                   "dot",
+                                                   "quant_convolution",
+                                                   "quant_dot",
+                                                   "broadcast",
+                                                   "concat",
+                                                   "contiguous",
+                                                   "flatten",
+                                                   "multibroadcast",
+                                                   "reshape",
+                                                   "slice",
+                                                   "squeeze",
+                                                   "transpose",
+                                                   "unsqueeze"};
+    std::set<std::string> unsupported_low_precision_ops;
+    for(const auto& name : get_operators())
+    {
+        if(not contains(native_ops, name))
+            unsupported_low_precision_ops.insert(name);
+    }
     unsupported_types.erase(shape::type_t::float_type);
+    if(enabled(MIGRAPHX_ENABLE_DNNL_LOW_PRECISION{}))
+    {
+        for(auto t : low_precision_types)
+            unsupported_types.erase(t);
+    }
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
             eliminate_data_type{unsupported_types, shape::type_t::float_type, unsupported_ops},
+            eliminate_data_type{low_precision_types,
+                                shape::type_t::float_type,
+                                unsupported_low_precision_ops},
             dead_code_elimination{},
             simplify_reshapes{},
             eliminate_convert{},
@@ -95,6 +140,8 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             propagate_constant{},
             dead_code_elimination{},
+            fuse_pointwise{},
+            dead_code_elimination{},
             auto_contiguous{},
             lowering{},
             eliminate_contiguous{"dnnl::reorder"},
@@ -105,8 +152,11 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
+            prepack{&ctx},
+            dead_code_elimination{},
             write_literals{},
             dead_code_elimination{},
+            schedule{cpu::schedule_model{ctx.stream_count()}, ctx.stream_count() > 1},
             memory_coloring{"cpu::allocate"},
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
@@ -304,6 +304,11 @@ argument get_preallocation(context& ctx, const std::string& id)
     return ctx.get_current_device().preallocations.at(id);
 }
 
+bool has_preallocation(context& ctx, const std::string& id)
+{
+    return ctx.get_current_device().preallocations.count(id) > 0;
+}
+
 void gpu_fill(context& ctx, const argument& dst, int value)
 {
     if(dst.get_sub_objects().empty())
@@ -59,6 +59,8 @@ MIGRAPHX_GPU_EXPORT void copy_from_gpu(context& ctx, const argument& src, const
 
 MIGRAPHX_GPU_EXPORT argument get_preallocation(context& ctx, const std::string& id);
 
+MIGRAPHX_GPU_EXPORT bool has_preallocation(context& ctx, const std::string& id);
+
 MIGRAPHX_GPU_EXPORT void gpu_fill(context& ctx, const argument& dst, int value = 0);
 
 struct hip_allocate
@@ -236,6 +238,9 @@ struct hip_allocate_memory
 
     argument compute(context& ctx, const shape&, const std::vector<argument>&) const
     {
+        // A context created for a new session hasn't been finalized yet
+        if(not has_preallocation(ctx, id))
+            finalize(ctx, s, {});
         return get_preallocation(ctx, id);
     }
 
@@ -266,6 +271,9 @@ struct hip_copy_literal
 
     argument compute(context& ctx, const shape&, const std::vector<argument>&) const
     {
+        // A context created for a new session hasn't been finalized yet
+        if(not has_preallocation(ctx, id))
+            finalize(ctx, l.get_shape(), {});
         return get_preallocation(ctx, id);
     }
 
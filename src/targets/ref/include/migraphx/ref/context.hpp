@@ -25,7 +25,10 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
 #include <migraphx/ref/export.h>
+#include <string>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -33,7 +36,19 @@ namespace ref {
 
 struct context
 {
+    // Scratch buffers of the planned memory mode, which are allocated the first time they are used
+    // so that every context gets its own
+    std::unordered_map<std::string, argument> preallocations{};
+
     void finish() const {}
+
+    argument get_preallocation(const std::string& id, const shape& s)
+    {
+        auto it = preallocations.find(id);
+        if(it == preallocations.end())
+            it = preallocations.emplace(id, argument{s}).first;
+        return it->second;
+    }
 };
 
 } // namespace ref
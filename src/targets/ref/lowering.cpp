@@ -211,6 +211,17 @@ struct ref_op
     {
         return op.compute(output_shape, args);
     }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
+    op_cost estimate_cost(const shape& output,
+                          const std::vector<shape>& inputs,
+                          const std::vector<module_ref>& mod_args) const
+    {
+        return op.estimate_cost(output, inputs, mod_args);
+    }
+    value attributes() const { return op.attributes(); }
     value to_value() const
     {
         value v;
@@ -278,10 +289,12 @@ struct ref_gemm
     }
     std::string name() const { return "ref::dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    value attributes() const { return {{"compute_into", true}}; }
 
+    // The result is written into the argument after the inputs when one is given
     argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
     {
-        argument result{dyn_out.computed_shape};
+        argument result = args.size() > 2 ? args[2] : argument{dyn_out.computed_shape};
         visit_all(result, args[0], args[1])(
             [&](auto cmat, auto amat, auto bmat) { gemm(cmat, amat, bmat, 1.0f, 0.0f); });
         return result;
@@ -0,0 +1,165 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/ref/plan_memory.hpp>
+#include <migraphx/ref/allocation_model.hpp>
+#include <migraphx/ref/context.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/op/identity.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace ref {
+
+// Computes the operator into the buffer passed as the last argument. Operators with the
+// compute_into attribute are given the buffer after their inputs and write into it, while the
+// result of the others is copied. The buffer may be the one of an input for pointwise operators.
+struct compute_into
+{
+    operation op = op::identity{};
+    bool direct  = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "ref::compute_into"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    argument compute(migraphx::context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args) const
+    {
+        argument output = args.back();
+        std::vector<argument> inputs(args.begin(), direct ? args.end() : args.end() - 1);
+        auto result = op.is_context_free() ? op.compute(output_shape, inputs)
+                                           : op.compute(ctx, output_shape, inputs);
+        if(result.data() == output.data())
+            return output;
+        // The layouts can differ, so copy by element unless they are the same
+        if(result.get_shape() == output.get_shape())
+        {
+            std::copy(result.data(), result.data() + output.get_shape().bytes(), output.data());
+            return output;
+        }
+        visit_all(output, result)(
+            [&](auto out, auto in) { std::copy(in.begin(), in.end(), out.begin()); });
+        return output;
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    value to_value() const
+    {
+        value v;
+        v["name"]     = op.name();
+        v["operator"] = op.to_value();
+        return v;
+    }
+    void from_value(const value& v)
+    {
+        op     = make_op(v.at("name").to<std::string>(), v.at("operator"));
+        direct = op.attributes().get("compute_into", false);
+    }
+    friend std::ostream& operator<<(std::ostream& os, const compute_into& x)
+    {
+        os << "ref::compute_into[" << x.op << "]";
+        return os;
+    }
+};
+MIGRAPHX_REGISTER_OP(compute_into)
+
+static bool can_plan(instruction_ref ins)
+{
+    if(not starts_with(ins->name(), "ref::") or not ins->module_inputs().empty())
+        return false;
+    const auto& s = ins->get_shape();
+    if(s.dynamic() or s.type() == shape::tuple_type or not s.packed())
+        return false;
+    return ins->get_operator().output_alias(to_shapes(ins->inputs())) < 0;
+}
+
+void plan_memory::apply(module_pass_manager& mpm) const
+{
+    module& m = mpm.get_module();
+    // Submodules such as loop bodies can be evaluated while values from an earlier evaluation
+    // are still in use, so only the main module is planned
+    if(mpm.get_root_module() != &m)
+        return;
+    ref_allocation_model model;
+    std::unordered_set<instruction_ref> returned;
+    auto last = std::prev(m.end());
+    if(last->name() == "@return")
+    {
+        std::transform(last->inputs().begin(),
+                       last->inputs().end(),
+                       std::inserter(returned, returned.end()),
+                       [](auto ins) { return instruction::get_output_alias(ins); });
+    }
+    else
+    {
+        returned.insert(instruction::get_output_alias(last));
+    }
+    for(auto ins : iterator_for(m))
+    {
+        if(not can_plan(ins))
+            continue;
+        const auto& s = ins->get_shape();
+        instruction_ref output;
+        auto in_place = std::find_if(ins->inputs().begin(), ins->inputs().end(), [&](auto input) {
+            return input->name() == "ref::compute_into" and input->outputs().size() == 1 and
+                   input->get_shape() == s;
+        });
+        if(contains(returned, ins))
+            output = m.insert_instruction(ins, make_op("allocate", {{"shape", to_value(s)}}));
+        else if(in_place != ins->inputs().end() and
+                ins->get_operator().attributes().get("pointwise", false))
+            output = *in_place;
+        else
+            output = m.insert_instruction(ins, model.allocate(s));
+        auto op     = ins->get_operator();
+        bool direct = op.attributes().get("compute_into", false);
+        auto inputs = ins->inputs();
+        inputs.push_back(output);
+        m.replace_instruction(ins, compute_into{op, direct}, inputs);
+    }
+}
+
+} // namespace ref
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -24,6 +24,8 @@
 
 #include <migraphx/ref/target.hpp>
 #include <migraphx/ref/lowering.hpp>
+#include <migraphx/ref/allocation_model.hpp>
+#include <migraphx/ref/plan_memory.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/auto_contiguous.hpp>
@@ -35,6 +37,9 @@
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
 #include <migraphx/eliminate_data_type.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/preallocate_param.hpp>
+#include <migraphx/env.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -42,19 +47,32 @@ namespace ref {
 
 std::string target::name() const { return "ref"; }
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_REF_MEMORY_PLANNING)
+
 std::vector<pass> target::get_passes(migraphx::context&, const compile_options&) const
 {
-    return {normalize_ops{},
-            eliminate_pad{},
-            dead_code_elimination{},
-            insert_pad{},
-            dead_code_elimination{},
-            rewrite_rnn{},
-            dead_code_elimination{},
-            auto_contiguous{},
-            dead_code_elimination{},
-            lowering{},
-            dead_code_elimination{}};
+    std::vector<pass> passes = {normalize_ops{},
+                                eliminate_pad{},
+                                dead_code_elimination{},
+                                insert_pad{},
+                                dead_code_elimination{},
+                                rewrite_rnn{},
+                                dead_code_elimination{},
+                                auto_contiguous{},
+                                dead_code_elimination{},
+                                lowering{},
+                                dead_code_elimination{}};
+    if(enabled(MIGRAPHX_ENABLE_REF_MEMORY_PLANNING{}))
+    {
+        passes.insert(passes.end(),
+                      {plan_memory{},
+                       dead_code_elimination{},
+                       memory_coloring{"ref::allocate"},
+                       dead_code_elimination{},
+                       preallocate_param{"scratch", ref_allocation_model{}},
+                       dead_code_elimination{}});
+    }
+    return passes;
 }
 
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
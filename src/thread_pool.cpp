@@ -0,0 +1,327 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+
+namespace {
+
+// Depth of parallel regions the current thread is running in
+thread_local std::size_t parallel_depth = 0; // NOLINT
+
+struct parallel_scope
+{
+    parallel_scope() { parallel_depth++; }
+    parallel_scope(const parallel_scope&)            = delete;
+    parallel_scope& operator=(const parallel_scope&) = delete;
+    ~parallel_scope() { parallel_depth--; }
+};
+
+struct thread_pool
+{
+    explicit thread_pool(std::size_t n)
+    {
+        workers.reserve(n);
+        for(std::size_t i = 0; i < n; i++)
+            workers.emplace_back([this] { this->work(); });
+    }
+
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for(auto& w : workers)
+            w.join();
+    }
+
+    std::size_t size() const { return workers.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+    private:
+    void work()
+    {
+        for(;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return stop or not tasks.empty(); });
+                if(tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex m;
+    std::condition_variable cv;
+    bool stop = false;
+};
+
+struct pool_state
+{
+    std::mutex m;
+    std::atomic<std::size_t> num_threads{0};
+    std::shared_ptr<thread_pool> pool;
+};
+
+pool_state& get_pool_state()
+{
+    static pool_state ps;
+    return ps;
+}
+
+std::size_t default_num_threads()
+{
+    static const std::size_t result = [] {
+        auto n = value_of(MIGRAPHX_NUM_THREADS{});
+        if(n > 0)
+            return n;
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }();
+    return result;
+}
+
+std::shared_ptr<thread_pool> get_thread_pool()
+{
+    auto& ps = get_pool_state();
+    std::lock_guard<std::mutex> lock(ps.m);
+    if(ps.pool == nullptr)
+    {
+        ps.pool = std::make_shared<thread_pool>(get_num_threads() - 1);
+    }
+    return ps.pool;
+}
+
+struct work_range
+{
+    std::mutex m;
+    std::size_t start = 0;
+    std::size_t last  = 0;
+};
+
+struct parallel_job
+{
+    using function_type = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+    parallel_job(std::size_t n, std::size_t threadsize, const function_type& pf)
+        : f(&pf), ranges(threadsize)
+    {
+        // Use several chunks per participant so there is work left to steal
+        chunk                = std::max<std::size_t>(1, n / (threadsize * 4));
+        std::size_t partsize = (n + threadsize - 1) / threadsize;
+        for(std::size_t tid = 0; tid < threadsize; tid++)
+        {
+            ranges[tid].start = std::min(n, tid * partsize);
+            ranges[tid].last  = std::min(n, (tid + 1) * partsize);
+        }
+    }
+
+    // Take the next chunk from the participant's own range, otherwise steal from another
+    // participant
+    bool pop(std::size_t tid, std::size_t& start, std::size_t& last)
+    {
+        if(pop_own(tid, start, last))
+            return true;
+        for(std::size_t k = 1; k < ranges.size(); k++)
+        {
+            auto& r = ranges[(tid + k) % ranges.size()];
+            std::size_t stolen_start = 0;
+            std::size_t stolen_last  = 0;
+            {
+                std::lock_guard<std::mutex> lock(r.m);
+                auto remaining = r.last - r.start;
+                if(remaining == 0)
+                    continue;
+                if(remaining <= chunk)
+                {
+                    start   = r.start;
+                    last    = r.last;
+                    r.start = r.last;
+                    return true;
+                }
+                stolen_start = r.start + remaining / 2;
+                stolen_last  = r.last;
+                r.last       = stolen_start;
+            }
+            {
+                std::lock_guard<std::mutex> lock(ranges[tid].m);
+                ranges[tid].start = stolen_start;
+                ranges[tid].last  = stolen_last;
+            }
+            if(pop_own(tid, start, last))
+                return true;
+        }
+        return false;
+    }
+
+    void run(std::size_t tid)
+    {
+        parallel_scope scope;
+        std::size_t start = 0;
+        std::size_t last  = 0;
+        while(not failed and pop(tid, start, last))
+        {
+            try
+            {
+                (*f)(start, last, tid);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if(error == nullptr)
+                    error = std::current_exception();
+                failed = true;
+            }
+        }
+    }
+
+    void run_worker(std::size_t tid)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            // The caller has already finished all the work
+            if(closed)
+                return;
+            active++;
+        }
+        run(tid);
+        {
+            std::lock_guard<std::mutex> lock(m);
+            active--;
+        }
+        cv.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m);
+        closed = true;
+        cv.wait(lock, [&] { return active == 0; });
+        if(error != nullptr)
+            std::rethrow_exception(error);
+    }
+
+    private:
+    bool pop_own(std::size_t tid, std::size_t& start, std::size_t& last)
+    {
+        auto& r = ranges[tid];
+        std::lock_guard<std::mutex> lock(r.m);
+        if(r.start >= r.last)
+            return false;
+        start   = r.start;
+        last    = std::min(r.last, r.start + chunk);
+        r.start = last;
+        return true;
+    }
+
+    const function_type* f;
+    std::vector<work_range> ranges;
+    std::size_t chunk = 1;
+    std::atomic<bool> failed{false};
+    std::mutex m;
+    std::condition_variable cv;
+    std::size_t active = 0;
+    bool closed        = false;
+    std::exception_ptr error = nullptr;
+};
+
+} // namespace
+
+std::size_t get_num_threads()
+{
+    auto n = get_pool_state().num_threads.load();
+    if(n == 0)
+        return default_num_threads();
+    return n;
+}
+
+void set_num_threads(std::size_t n)
+{
+    std::shared_ptr<thread_pool> old;
+    {
+        auto& ps = get_pool_state();
+        std::lock_guard<std::mutex> lock(ps.m);
+        ps.num_threads = n;
+        old            = std::move(ps.pool);
+    }
+    // The old workers are joined here, or by the last running job that still holds the pool
+}
+
+bool in_parallel_region() { return parallel_depth > 0; }
+
+void parallel_range_for(std::size_t n,
+                        std::size_t threadsize,
+                        const std::function<void(std::size_t, std::size_t, std::size_t)>& f)
+{
+    if(n == 0)
+        return;
+    if(threadsize <= 1 or in_parallel_region())
+    {
+        parallel_scope scope;
+        f(0, n, 0);
+        return;
+    }
+    auto pool  = get_thread_pool();
+    threadsize = std::min({threadsize, n, pool->size() + 1});
+    auto job   = std::make_shared<parallel_job>(n, threadsize, f);
+    for(std::size_t tid = 1; tid < threadsize; tid++)
+        pool->submit([job, tid] { job->run_worker(tid); });
+    job->run(0);
+    job->wait();
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -231,4 +231,49 @@ TEST_CASE(argument_share)
     EXPECT(a4.data() == a3.data());
 }
 
+TEST_CASE(literal_argument_read_only)
+{
+    migraphx::shape s{migraphx::shape::int64_type, {3}};
+    migraphx::literal l{s, {1, 2, 3}};
+    auto a = l.get_argument();
+    EXPECT(a.is_read_only());
+    EXPECT(a.data() == l.data());
+    EXPECT(a == l.get_argument());
+
+    auto r = a.reshape({migraphx::shape::int64_type, {3, 1}});
+    EXPECT(r.is_read_only());
+    EXPECT(r.data() == l.data());
+
+    auto v = a.view({migraphx::shape::int64_type, {2}}, s.type_size());
+    EXPECT(v.is_read_only());
+    EXPECT(v.data() == l.data() + s.type_size());
+
+    EXPECT(a.share().is_read_only());
+}
+
+TEST_CASE(argument_writable)
+{
+    migraphx::shape s{migraphx::shape::int64_type, {3}};
+    migraphx::literal l{s, {1, 2, 3}};
+    auto a = l.get_argument().writable();
+    EXPECT(not a.is_read_only());
+    EXPECT(a.data() != l.data());
+    EXPECT(a == l.get_argument());
+    std::vector<int64_t> data = {4, 5, 6};
+    a.fill(data.begin(), data.end());
+    EXPECT(l == migraphx::literal{s, {1, 2, 3}});
+
+    migraphx::argument b{s};
+    EXPECT(b.writable().data() == b.data());
+}
+
+TEST_CASE(tuple_writable)
+{
+    auto a = make_tuple(3, 3.0);
+    EXPECT(a.is_read_only());
+    auto b = a.writable();
+    EXPECT(not b.is_read_only());
+    EXPECT(b == a);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,164 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/calibration.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <numeric>
+#include "test.hpp"
+
+static migraphx::argument make_arg(std::vector<float>& data)
+{
+    return {{migraphx::shape::float_type, {data.size()}}, data.data()};
+}
+
+TEST_CASE(histogram_max_only)
+{
+    migraphx::calibration_histogram h;
+    EXPECT(h.empty());
+    std::vector<float> a = {1, -3, 2};
+    std::vector<float> b = {0.5, 2.5};
+    h.add(make_arg(a));
+    h.add(make_arg(b));
+    EXPECT(not h.empty());
+    EXPECT(h.max_abs() == 3.0f);
+    EXPECT(h.get_bins().empty());
+    EXPECT(h.get_threshold({}, 128) == 3.0f);
+}
+
+TEST_CASE(histogram_bins)
+{
+    migraphx::calibration_histogram h{4};
+    std::vector<float> a = {0, 1, -2, 3, 4};
+    h.add(make_arg(a));
+    EXPECT(h.bin_width() == 1.0f);
+    EXPECT(h.get_bins() == std::vector<std::size_t>{1, 1, 1, 2});
+}
+
+TEST_CASE(histogram_grow)
+{
+    migraphx::calibration_histogram h{4};
+    std::vector<float> a = {0, 1, 2, 3, 4};
+    std::vector<float> b = {-7, 16};
+    h.add(make_arg(a));
+    // The range is doubled twice and the existing counts merged. The largest value is counted
+    // in the last bin, so 4 stays with the values below it.
+    h.add(make_arg(b));
+    EXPECT(h.bin_width() == 4.0f);
+    EXPECT(h.max_abs() == 16.0f);
+    EXPECT(h.get_bins() == std::vector<std::size_t>{5, 1, 0, 1});
+    auto total = std::accumulate(h.get_bins().begin(), h.get_bins().end(), std::size_t{0});
+    EXPECT(total == 7);
+}
+
+TEST_CASE(histogram_zeros_then_values)
+{
+    migraphx::calibration_histogram h{4};
+    std::vector<float> a = {0, 0};
+    std::vector<float> b = {2};
+    h.add(make_arg(a));
+    EXPECT(h.get_threshold({}, 128) == 0.0f);
+    h.add(make_arg(b));
+    EXPECT(h.bin_width() == 0.5f);
+    EXPECT(h.get_bins() == std::vector<std::size_t>{2, 0, 0, 1});
+}
+
+TEST_CASE(histogram_skips_non_finite)
+{
+    migraphx::calibration_histogram h{4};
+    std::vector<float> a = {1, std::numeric_limits<float>::infinity(), std::nanf(""), -2};
+    h.add(make_arg(a));
+    EXPECT(h.max_abs() == 2.0f);
+    auto total = std::accumulate(h.get_bins().begin(), h.get_bins().end(), std::size_t{0});
+    EXPECT(total == 2);
+}
+
+TEST_CASE(percentile_clips_outliers)
+{
+    migraphx::calibration_histogram h{100};
+    std::vector<float> data(1000);
+    std::iota(data.begin(), data.end(), 0.0f);
+    std::transform(data.begin(), data.end(), data.begin(), [](auto x) { return x / 1000.0f; });
+    data.back() = 100.0f;
+    h.add(make_arg(data));
+
+    migraphx::calibration_options options;
+    options.method     = migraphx::calibration_method::percentile;
+    options.percentile = 99.0;
+    EXPECT(h.get_threshold(options, 128) <= 1.0f);
+    options.percentile = 100.0;
+    EXPECT(h.get_threshold(options, 128) == 100.0f);
+}
+
+TEST_CASE(entropy_clips_outliers)
+{
+    migraphx::calibration_histogram h{512};
+    std::vector<float> data(10000);
+    // Most values are small with a single large outlier
+    for(std::size_t i = 0; i < data.size(); i++)
+        data[i] = float(i % 100) / 100.0f;
+    data.back() = 50.0f;
+    h.add(make_arg(data));
+
+    migraphx::calibration_options options;
+    options.method = migraphx::calibration_method::entropy;
+    auto threshold = h.get_threshold(options, 128);
+    EXPECT(threshold > 0.0f);
+    EXPECT(threshold < 50.0f);
+    // With fewer bins than levels nothing is clipped
+    migraphx::calibration_histogram small{64};
+    small.add(make_arg(data));
+    EXPECT(small.get_threshold(options, 128) == 50.0f);
+}
+
+TEST_CASE(calibration_cache_file)
+{
+    migraphx::tmp_dir td{"calibration"};
+    auto file = td.path / "calibration.json";
+    migraphx::calibration_options options;
+    options.method = migraphx::calibration_method::percentile;
+    EXPECT(not migraphx::load_calibration(file, options, "p", 2).has_value());
+
+    std::vector<float> thresholds = {0.25f, -1.0f};
+    migraphx::save_calibration(file, options, "p", thresholds);
+    auto loaded = migraphx::load_calibration(file, options, "p", 2);
+    EXPECT(loaded.has_value());
+    EXPECT(*loaded == thresholds);
+    EXPECT(not migraphx::load_calibration(file, options, "p", 3).has_value());
+    EXPECT(not migraphx::load_calibration(file, options, "q", 2).has_value());
+
+    auto other_method   = options;
+    other_method.method = migraphx::calibration_method::max;
+    EXPECT(not migraphx::load_calibration(file, other_method, "p", 2).has_value());
+    auto other_percentile       = options;
+    other_percentile.percentile = 99.9;
+    EXPECT(not migraphx::load_calibration(file, other_percentile, "p", 2).has_value());
+    auto other_bins = options;
+    other_bins.bins = 1024;
+    EXPECT(not migraphx::load_calibration(file, other_bins, "p", 2).has_value());
+    // The cache file and concurrency don't change the ranges
+    auto other_concurrency        = options;
+    other_concurrency.concurrency = 4;
+    EXPECT(migraphx::load_calibration(file, other_concurrency, "p", 2).has_value());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,138 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/chrome_trace.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/marker.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/json.hpp>
+#include "test.hpp"
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(migraphx::make_op("add"), one, two);
+    return p;
+}
+
+static std::vector<migraphx::value> events_of(const migraphx::chrome_trace& trace,
+                                               const std::string& category)
+{
+    std::vector<migraphx::value> result;
+    auto events = trace.to_value().at("traceEvents");
+    std::copy_if(events.begin(), events.end(), std::back_inserter(result), [&](const auto& e) {
+        return e.contains("cat") and e.at("cat").template to<std::string>() == category;
+    });
+    return result;
+}
+
+TEST_CASE(trace_instructions)
+{
+    auto p = create_program();
+    p.compile(migraphx::make_target("ref"));
+
+    migraphx::chrome_trace trace;
+    p.mark({}, trace);
+
+    auto instructions = events_of(trace, "instruction");
+    EXPECT(instructions.size() == 3);
+    EXPECT(std::any_of(instructions.begin(), instructions.end(), [](const auto& e) {
+        return e.at("name").template to<std::string>() == "ref::op" and
+               e.at("args").at("bytes").template to<std::size_t>() == sizeof(int32_t);
+    }));
+    EXPECT(std::all_of(instructions.begin(), instructions.end(), [](const auto& e) {
+        return e.at("ph").template to<std::string>() == "X" and
+               e.at("dur").template to<double>() >= 0;
+    }));
+    EXPECT(events_of(trace, "program").size() == 1);
+}
+
+TEST_CASE(trace_alias_bytes)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = mm->add_parameter("x", s);
+    auto tx = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+    mm->add_instruction(migraphx::make_op("neg"), tx);
+    p.compile(migraphx::make_target("ref"));
+
+    std::vector<float> data(s.elements());
+    migraphx::chrome_trace trace;
+    p.mark({{"x", migraphx::argument{s, data.data()}}}, trace);
+
+    // The transpose aliases its input, so it is the only instruction that allocates nothing
+    auto instructions = events_of(trace, "instruction");
+    EXPECT(std::count_if(instructions.begin(), instructions.end(), [](const auto& e) {
+               return e.at("args").at("bytes").template to<std::size_t>() == 0;
+           }) == 1);
+}
+
+TEST_CASE(trace_passes)
+{
+    auto p = create_program();
+    migraphx::chrome_trace trace;
+    migraphx::compile_options options;
+    options.trace = trace.get_tracer();
+    p.compile(migraphx::make_target("ref"), options);
+
+    auto passes = events_of(trace, "pass");
+    EXPECT(not passes.empty());
+    EXPECT(std::any_of(passes.begin(), passes.end(), [](const auto& e) {
+        return e.at("args").contains("module") and
+               e.at("args").at("module").template to<std::string>() == "main";
+    }));
+    EXPECT(trace.size() == passes.size());
+}
+
+TEST_CASE(trace_json)
+{
+    auto p = create_program();
+    p.compile(migraphx::make_target("ref"));
+
+    migraphx::chrome_trace trace;
+    p.mark({}, trace);
+
+    std::stringstream ss;
+    trace.write(ss);
+    auto v = migraphx::from_json_string(ss.str());
+    EXPECT(v.contains("traceEvents"));
+    // The thread name metadata comes along with the events
+    EXPECT(v.at("traceEvents").size() == trace.size() + 1);
+}
+
+TEST_CASE(trace_unmatched_stop)
+{
+    auto p = create_program();
+    migraphx::chrome_trace trace;
+    EXPECT(test::throws([&] { trace.mark_stop(p); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
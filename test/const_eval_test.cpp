@@ -56,6 +56,27 @@ struct sum_cf_op
     }
 };
 
+static std::size_t& count_cf_calls()
+{
+    static std::size_t n = 0;
+    return n;
+}
+
+struct count_cf_op
+{
+    std::string name() const { return "count_cf"; }
+    migraphx::argument compute(const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        count_cf_calls()++;
+        return args.front();
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+};
+
 struct non_computable_cf
 {
     std::string name() const { return "non_computable"; }
@@ -124,6 +145,26 @@ TEST_CASE(op_test3)
     CHECK(sum2->eval().empty());
 }
 
+TEST_CASE(op_shared_inputs)
+{
+    migraphx::program p;
+
+    auto* mm   = p.get_main_module();
+    auto one   = mm->add_literal(1);
+    auto two   = mm->add_literal(2);
+    auto count = mm->add_instruction(count_cf_op{}, one);
+    auto sum1  = mm->add_instruction(sum_cf_op{}, count, two);
+    auto sum2  = mm->add_instruction(sum_cf_op{}, count, sum1);
+    auto sum3  = mm->add_instruction(sum_cf_op{}, sum2, sum1);
+
+    count_cf_calls() = 0;
+    // The shared input is computed once for each evaluation
+    CHECK(sum3->eval() == migraphx::literal{7});
+    CHECK(count_cf_calls() == 1);
+    CHECK(sum3->eval() == migraphx::literal{7});
+    CHECK(count_cf_calls() == 2);
+}
+
 TEST_CASE(compute_op_c)
 {
     migraphx::operation op = sum_op{};
@@ -0,0 +1,196 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/convolution.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+#include "test.hpp"
+
+// The per output element loop that every algorithm is checked against
+template <class Output, class T>
+static void naive_convolution(Output output,
+                              T input,
+                              T weights,
+                              const std::vector<std::size_t>& padding,
+                              const std::vector<std::size_t>& stride,
+                              const std::vector<std::size_t>& dilation,
+                              int group)
+{
+    auto output_shape = output.get_shape();
+    auto in_lens      = input.get_shape().lens();
+    auto wei_lens     = weights.get_shape().lens();
+    std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+    migraphx::shape win_shape{output_shape.type(), win_size};
+    for(std::size_t i = 0; i < output_shape.elements(); i++)
+    {
+        auto idx_o    = output_shape.multi(i);
+        auto w        = idx_o[1];
+        auto group_id = w / (wei_lens[0] / group);
+        double acc    = 0.0;
+        migraphx::shape_for_each(win_shape, [&](const auto& idx_win) {
+            std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
+            idx[1]      = group_id * wei_lens[1] + idx_win[0];
+            bool inside = true;
+            for(std::size_t d = 2; d < idx.size(); d++)
+            {
+                auto pos = idx_o[d] * stride[d - 2] + idx_win[d - 1] * dilation[d - 2];
+                idx[d]   = std::ptrdiff_t(pos) - std::ptrdiff_t(padding[d - 2]);
+                inside = inside and idx[d] >= 0 and idx[d] < std::ptrdiff_t(in_lens[d]);
+            }
+            std::vector<std::size_t> idx_wei(idx_o.size());
+            idx_wei[0] = w;
+            std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
+            if(inside)
+                acc += input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
+        });
+        output[i] = acc;
+    }
+}
+
+struct conv_case
+{
+    migraphx::shape::type_t type;
+    std::vector<std::size_t> input;
+    std::vector<std::size_t> weights;
+    std::vector<std::size_t> padding;
+    std::vector<std::size_t> stride;
+    std::vector<std::size_t> dilation;
+    int group = 1;
+
+    migraphx::shape output_shape() const
+    {
+        std::vector<std::size_t> lens = {input[0], weights[0]};
+        for(std::size_t d = 0; d < padding.size(); d++)
+        {
+            auto extent = dilation[d] * (weights[d + 2] - 1) + 1;
+            lens.push_back((input[d + 2] + 2 * padding[d] - extent) / stride[d] + 1);
+        }
+        auto out_type = migraphx::shape::is_integral(type) ? migraphx::shape::int32_type : type;
+        return {out_type, lens};
+    }
+};
+
+template <class Out, class In>
+static migraphx::argument
+run_convolution(const conv_case& c, migraphx::convolution_algorithm algo, bool naive = false)
+{
+    auto input   = migraphx::generate_argument({c.type, c.input}, 1);
+    auto weights = migraphx::generate_argument({c.type, c.weights}, 2);
+    migraphx::argument result{c.output_shape()};
+    auto output = result.get<Out>();
+    auto in     = input.get<In>();
+    auto wei    = weights.get<In>();
+    if(naive)
+        naive_convolution(output, in, wei, c.padding, c.stride, c.dilation, c.group);
+    else
+        migraphx::convolution(algo, output, in, wei, c.padding, c.stride, c.dilation, c.group);
+    return result;
+}
+
+template <class Out = float, class In = Out>
+static bool check_exact(const conv_case& c, migraphx::convolution_algorithm algo)
+{
+    return run_convolution<Out, In>(c, algo) == run_convolution<Out, In>(c, algo, true);
+}
+
+static bool check_close(const conv_case& c, migraphx::convolution_algorithm algo)
+{
+    auto result = run_convolution<float, float>(c, algo);
+    auto gold   = run_convolution<float, float>(c, algo, true);
+    return migraphx::verify::verify_rms_range(result.get<float>(), gold.get<float>());
+}
+
+TEST_CASE(direct_matches_reference)
+{
+    using migraphx::convolution_algorithm;
+    auto ft = migraphx::shape::float_type;
+    EXPECT(check_exact({ft, {2, 3, 7, 9}, {4, 3, 3, 3}, {1, 1}, {1, 1}, {1, 1}},
+                       convolution_algorithm::direct));
+    EXPECT(check_exact({ft, {1, 4, 9, 8}, {6, 2, 3, 2}, {2, 0}, {2, 3}, {2, 1}, 2},
+                       convolution_algorithm::direct));
+    EXPECT(check_exact({ft, {2, 2, 11}, {3, 2, 4}, {3}, {2}, {3}},
+                       convolution_algorithm::direct));
+    EXPECT(check_exact({ft, {1, 2, 4, 5, 6}, {2, 2, 3, 2, 3}, {1, 0, 1}, {1, 2, 1}, {1, 1, 2}},
+                       convolution_algorithm::direct));
+    auto ht = migraphx::shape::half_type;
+    EXPECT(check_exact<migraphx::half>({ht, {1, 3, 6, 6}, {2, 3, 3, 3}, {1, 1}, {1, 1}, {1, 1}},
+                                       convolution_algorithm::direct));
+}
+
+TEST_CASE(im2col_matches_reference)
+{
+    using migraphx::convolution_algorithm;
+    auto ft = migraphx::shape::float_type;
+    EXPECT(check_close({ft, {2, 8, 12, 10}, {16, 8, 3, 3}, {1, 1}, {1, 1}, {1, 1}},
+                       convolution_algorithm::im2col));
+    EXPECT(check_close({ft, {2, 8, 13, 9}, {12, 2, 5, 3}, {2, 1}, {2, 1}, {1, 2}, 4},
+                       convolution_algorithm::im2col));
+    EXPECT(check_close({ft, {1, 4, 30}, {5, 4, 7}, {3}, {3}, {2}},
+                       convolution_algorithm::im2col));
+    EXPECT(check_close({ft, {1, 3, 5, 6, 7}, {4, 3, 3, 3, 3}, {1, 1, 1}, {1, 1, 1}, {1, 1, 1}},
+                       convolution_algorithm::im2col));
+}
+
+TEST_CASE(im2col_int8_exact)
+{
+    using migraphx::convolution_algorithm;
+    auto i8 = migraphx::shape::int8_type;
+    EXPECT(check_exact<int32_t, int8_t>(
+        {i8, {2, 8, 12, 10}, {16, 8, 3, 3}, {1, 1}, {1, 1}, {1, 1}}, convolution_algorithm::im2col));
+    EXPECT(check_exact<int32_t, int8_t>(
+        {i8, {1, 6, 9, 9}, {6, 3, 3, 3}, {0, 2}, {2, 1}, {1, 2}, 2}, convolution_algorithm::im2col));
+}
+
+TEST_CASE(winograd_matches_reference)
+{
+    using migraphx::convolution_algorithm;
+    auto ft = migraphx::shape::float_type;
+    for(auto algo : {convolution_algorithm::winograd_2x3, convolution_algorithm::winograd_4x3})
+    {
+        EXPECT(check_close({ft, {2, 8, 16, 16}, {8, 8, 3, 3}, {1, 1}, {1, 1}, {1, 1}}, algo));
+        EXPECT(check_close({ft, {1, 5, 11, 13}, {7, 5, 3, 3}, {0, 0}, {1, 1}, {1, 1}}, algo));
+        EXPECT(check_close({ft, {1, 4, 9, 6}, {4, 4, 3, 3}, {2, 1}, {1, 1}, {1, 1}}, algo));
+    }
+}
+
+TEST_CASE(select_algorithm)
+{
+    using migraphx::convolution_algorithm;
+    auto select = [](const conv_case& c) {
+        return migraphx::select_convolution_algorithm(
+            c.output_shape(), {c.type, c.weights}, c.stride, c.dilation, c.group);
+    };
+    auto ft = migraphx::shape::float_type;
+    EXPECT(select({ft, {1, 8, 32, 32}, {8, 8, 3, 3}, {1, 1}, {1, 1}, {1, 1}}) ==
+           convolution_algorithm::winograd_4x3);
+    EXPECT(select({ft, {1, 8, 4, 4}, {8, 8, 3, 3}, {1, 1}, {1, 1}, {1, 1}}) ==
+           convolution_algorithm::winograd_2x3);
+    EXPECT(select({ft, {1, 8, 32, 32}, {8, 8, 3, 3}, {1, 1}, {2, 2}, {1, 1}}) ==
+           convolution_algorithm::im2col);
+    EXPECT(select({migraphx::shape::int8_type, {1, 8, 32, 32}, {8, 8, 3, 3}, {1, 1}, {1, 1},
+                   {1, 1}}) == convolution_algorithm::im2col);
+    EXPECT(select({ft, {1, 2, 32, 32}, {8, 2, 1, 1}, {0, 0}, {1, 1}, {1, 1}}) ==
+           convolution_algorithm::direct);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <vector>
+#include <test.hpp>
+
+static migraphx::program create_quant_dot()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", migraphx::shape{migraphx::shape::int8_type, {4, 8}});
+    auto b   = mm->add_parameter("b", migraphx::shape{migraphx::shape::int8_type, {8, 6}});
+    mm->add_instruction(migraphx::make_op("quant_dot"), a, b);
+    return p;
+}
+
+static migraphx::program create_quant_conv()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", migraphx::shape{migraphx::shape::int8_type, {1, 4, 6, 6}});
+    auto w   = mm->add_parameter("w", migraphx::shape{migraphx::shape::int8_type, {4, 4, 3, 3}});
+    mm->add_instruction(
+        migraphx::make_op("quant_convolution", {{"padding", {1, 1}}, {"stride", {1, 1}}}), x, w);
+    return p;
+}
+
+static migraphx::parameter_map create_params(const migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    for(auto&& [name, s] : p.get_parameter_shapes())
+        params[name] = migraphx::generate_argument(s, name.size());
+    return params;
+}
+
+static std::vector<int32_t> run(const migraphx::program& p, const migraphx::parameter_map& params)
+{
+    auto result = p.eval(params).back();
+    std::vector<int32_t> v;
+    result.visit([&](auto output) { v.assign(output.begin(), output.end()); });
+    return v;
+}
+
+static std::vector<int32_t> run_ref(migraphx::program p, const migraphx::parameter_map& params)
+{
+    p.compile(migraphx::make_target("ref"));
+    return run(p, params);
+}
+
+static bool has_op(const migraphx::program& p, const std::string& name)
+{
+    const auto* mm = p.get_main_module();
+    return std::any_of(
+        mm->begin(), mm->end(), [&](const auto& ins) { return ins.name() == name; });
+}
+
+// Run with MIGRAPHX_ENABLE_DNNL_LOW_PRECISION set, as the test_cpu_lowering_low_precision test
+// does. The int8 op either runs in a dnnl s8 kernel, or in float between converts, depending on
+// the kernels dnnl has for this machine. Both accumulate exactly for these sizes.
+static void check_low_precision(migraphx::program p,
+                                const std::string& quant_name,
+                                const std::string& float_name)
+{
+    if(not migraphx::enabled("MIGRAPHX_ENABLE_DNNL_LOW_PRECISION"))
+        return;
+    auto params = create_params(p);
+    auto gold   = run_ref(p, params);
+    p.compile(migraphx::make_target("cpu"));
+    EXPECT(has_op(p, quant_name) or (has_op(p, float_name) and has_op(p, "convert")));
+    EXPECT(p.get_output_shapes().front().type() == migraphx::shape::int32_type);
+    EXPECT(run(p, params) == gold);
+}
+
+// The low precision kernels are opt-in, so by default the int8 op computes in float
+static void check_float_fallback(migraphx::program p,
+                                 const std::string& quant_name,
+                                 const std::string& float_name)
+{
+    if(migraphx::enabled("MIGRAPHX_ENABLE_DNNL_LOW_PRECISION"))
+        return;
+    auto params = create_params(p);
+    auto gold   = run_ref(p, params);
+    p.compile(migraphx::make_target("cpu"));
+    EXPECT(not has_op(p, quant_name));
+    EXPECT(has_op(p, float_name));
+    EXPECT(has_op(p, "convert"));
+    EXPECT(p.get_output_shapes().front().type() == migraphx::shape::int32_type);
+    EXPECT(run(p, params) == gold);
+}
+
+TEST_CASE(quant_dot_int8)
+{
+    check_low_precision(create_quant_dot(), "dnnl::quant_dot", "dnnl::dot");
+}
+
+TEST_CASE(quant_conv_int8)
+{
+    check_low_precision(create_quant_conv(), "dnnl::quant_convolution", "dnnl::convolution");
+}
+
+TEST_CASE(quant_dot_int8_float)
+{
+    check_float_fallback(create_quant_dot(), "dnnl::quant_dot", "dnnl::dot");
+}
+
+TEST_CASE(quant_conv_int8_float)
+{
+    check_float_fallback(create_quant_conv(), "dnnl::quant_convolution", "dnnl::convolution");
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,206 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <vector>
+#include <test.hpp>
+
+static migraphx::instruction_ref
+add_conv(migraphx::module& m, migraphx::instruction_ref x, migraphx::instruction_ref w)
+{
+    auto conv = m.add_instruction(
+        migraphx::make_op("convolution", {{"padding", {1, 1}}, {"stride", {1, 1}}}), x, w);
+    return m.add_instruction(migraphx::make_op("relu"), conv);
+}
+
+// A chain of convolutions with constant weights, that can stay in a blocked layout
+static migraphx::program create_conv_chain()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape xs{migraphx::shape::float_type, {1, 16, 28, 28}};
+    migraphx::shape ws{migraphx::shape::float_type, {16, 16, 3, 3}};
+    auto y = mm->add_parameter("x", xs);
+    for(unsigned long i = 0; i < 3; i++)
+        y = add_conv(*mm, y, mm->add_literal(migraphx::generate_literal(ws, i)));
+    mm->add_return({y});
+    return p;
+}
+
+// The weights of the second convolution are not constant, so it may not have a kernel for the
+// layout of the first one
+static migraphx::program create_conv_param_weights()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape xs{migraphx::shape::float_type, {1, 16, 28, 28}};
+    migraphx::shape ws{migraphx::shape::float_type, {16, 16, 3, 3}};
+    auto x = mm->add_parameter("x", xs);
+    auto y = add_conv(*mm, x, mm->add_literal(migraphx::generate_literal(ws, 0)));
+    y      = add_conv(*mm, y, mm->add_parameter("w", ws));
+    mm->add_return({y});
+    return p;
+}
+
+static migraphx::parameter_map create_params(const migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    for(auto&& [name, s] : p.get_parameter_shapes())
+        params[name] = migraphx::generate_argument(s, name.size());
+    return params;
+}
+
+static std::vector<float> run(const migraphx::program& p, const migraphx::parameter_map& params)
+{
+    auto result = p.eval(params).back();
+    std::vector<float> v;
+    result.visit([&](auto output) { v.assign(output.begin(), output.end()); });
+    return v;
+}
+
+static std::vector<float> run_ref(migraphx::program p, const migraphx::parameter_map& params)
+{
+    p.compile(migraphx::make_target("ref"));
+    return run(p, params);
+}
+
+static bool is_blocked(migraphx::instruction_ref ins)
+{
+    return ins->name() == "dnnl::convolution" and
+           ins->get_shape().type() == migraphx::shape::uint8_type;
+}
+
+// Every output in a dnnl layout is only read by convolutions that use that layout, or by a
+// reorder back to the standard layout
+static bool blocked_outputs_are_read_as_blocked(const migraphx::module& m)
+{
+    for(auto ins : migraphx::iterator_for(m))
+    {
+        if(not is_blocked(ins))
+            continue;
+        if(not std::all_of(ins->outputs().begin(), ins->outputs().end(), [](auto output) {
+               if(output->name() == "dnnl::reorder")
+                   return true;
+               return output->name() == "dnnl::convolution" and
+                      not output->get_operator().to_value().at("layouts").empty();
+           }))
+            return false;
+    }
+    return true;
+}
+
+static std::size_t count_blocked(const migraphx::module& m)
+{
+    std::size_t n = 0;
+    for(auto ins : migraphx::iterator_for(m))
+    {
+        if(is_blocked(ins))
+            n++;
+    }
+    return n;
+}
+
+TEST_CASE(conv_chain)
+{
+    auto p      = create_conv_chain();
+    auto params = create_params(p);
+    auto gold   = run_ref(p, params);
+    p.compile(migraphx::make_target("cpu"));
+    EXPECT(blocked_outputs_are_read_as_blocked(*p.get_main_module()));
+    // The outputs are always returned in the standard layout
+    EXPECT(p.get_output_shapes().front() ==
+           migraphx::shape{migraphx::shape::float_type, {1, 16, 28, 28}});
+    EXPECT(migraphx::verify::verify_rms_range(run(p, params), gold));
+}
+
+TEST_CASE(conv_param_weights)
+{
+    auto p      = create_conv_param_weights();
+    auto params = create_params(p);
+    auto gold   = run_ref(p, params);
+    p.compile(migraphx::make_target("cpu"));
+    auto* mm = p.get_main_module();
+    EXPECT(blocked_outputs_are_read_as_blocked(*mm));
+    // When the second convolution can not read the blocked layout, it is reordered back first
+    for(auto it = mm->begin(); it != mm->end(); it++)
+    {
+        if(it->name() != "dnnl::reorder" or not is_blocked(it->inputs().front()))
+            continue;
+        EXPECT(it->get_shape().standard());
+        EXPECT(it->get_shape().type() == migraphx::shape::float_type);
+    }
+    EXPECT(migraphx::verify::verify_rms_range(run(p, params), gold));
+}
+
+TEST_CASE(conv_chain_save_load)
+{
+    auto p = create_conv_chain();
+    p.compile(migraphx::make_target("cpu"));
+    auto params = create_params(p);
+    // The layouts are stored as the dnnl version and the raw dnnl descriptors, which have to load
+    // back the same
+    auto loaded = migraphx::load_buffer(migraphx::save_buffer(p));
+    EXPECT(loaded == p);
+    EXPECT(count_blocked(*loaded.get_main_module()) == count_blocked(*p.get_main_module()));
+    EXPECT(run(loaded, params) == run(p, params));
+}
+
+TEST_CASE(conv_chain_not_prepacked)
+{
+    // prepack is opt-in, and test_cpu_prepack_enabled runs the other tests with it enabled
+    if(migraphx::enabled("MIGRAPHX_ENABLE_DNNL_PREPACK"))
+        return;
+    auto p      = create_conv_chain();
+    auto params = create_params(p);
+    auto gold   = run_ref(p, params);
+    p.compile(migraphx::make_target("cpu"));
+    auto* mm = p.get_main_module();
+    EXPECT(count_blocked(*mm) == 0);
+    EXPECT(std::none_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.name() == "@literal" and ins.get_shape().type() == migraphx::shape::uint8_type;
+    }));
+    EXPECT(migraphx::verify::verify_rms_range(run(p, params), gold));
+}
+
+TEST_CASE(layout_from_other_dnnl_version)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto bytes = migraphx::cpu::to_dnnl_layout_bytes(migraphx::cpu::to_dnnl_memory_desc(s));
+    EXPECT(migraphx::cpu::from_dnnl_layout_bytes(bytes) == migraphx::cpu::to_dnnl_memory_desc(s));
+    // The layout starts with the version of dnnl that saved it
+    bytes.front() = bytes.front() == '9' ? '8' : '9';
+    EXPECT(test::throws([&] { migraphx::cpu::from_dnnl_layout_bytes(bytes); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
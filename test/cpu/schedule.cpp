@@ -0,0 +1,158 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+
+// Two independent branches that only join at the end
+static migraphx::program create_branches()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64, 64}};
+    auto x = mm->add_parameter("x", s);
+    std::vector<migraphx::instruction_ref> outputs;
+    for(unsigned long i = 0; i < 2; i++)
+    {
+        auto w = mm->add_literal(migraphx::generate_literal(s, i));
+        auto y = mm->add_instruction(migraphx::make_op("dot"), x, w);
+        y      = mm->add_instruction(migraphx::make_op("relu"), y);
+        y      = mm->add_instruction(migraphx::make_op("dot"), y, w);
+        y      = mm->add_instruction(migraphx::make_op("tanh"), y);
+        outputs.push_back(mm->add_instruction(migraphx::make_op("dot"), y, w));
+    }
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), outputs[0], outputs[1])});
+    return p;
+}
+
+static std::vector<float> run(const migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    params["x"] = migraphx::generate_argument(p.get_parameter_shape("x"));
+    auto result = p.eval(params).back();
+    std::vector<float> v;
+    result.visit([&](auto output) { v.assign(output.begin(), output.end()); });
+    return v;
+}
+
+static std::vector<float> run_ref()
+{
+    auto p = create_branches();
+    p.compile(migraphx::make_target("ref"));
+    return run(p);
+}
+
+TEST_CASE(branches_single_stream)
+{
+    auto p = create_branches();
+    p.compile(migraphx::cpu::target{1});
+    auto* mm = p.get_main_module();
+    EXPECT(std::none_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.name() == "cpu::set_stream";
+    }));
+    EXPECT(migraphx::verify::verify_rms_range(run(p), run_ref()));
+}
+
+TEST_CASE(branches_streams)
+{
+    auto p = create_branches();
+    p.compile(migraphx::cpu::target{2});
+    auto gold = run_ref();
+    // Evaluate more than once, since the events are reused
+    for(int i = 0; i < 3; i++)
+        EXPECT(migraphx::verify::verify_rms_range(run(p), gold));
+}
+
+TEST_CASE(branches_streams_memory)
+{
+    auto p = create_branches();
+    p.compile(migraphx::cpu::target{2});
+    auto* mm = p.get_main_module();
+
+    // The buffers written on each stream before the branches are waited on
+    struct buffer
+    {
+        std::size_t stream;
+        std::size_t offset;
+        std::size_t bytes;
+    };
+    std::vector<buffer> buffers;
+    std::size_t stream = 0;
+    for(auto ins : migraphx::iterator_for(*mm))
+    {
+        if(ins->name() == "cpu::wait_event")
+            break;
+        if(ins->name() == "cpu::set_stream")
+            stream = ins->get_operator().to_value()["stream"].to<std::size_t>();
+        if(ins->name() != "cpu::stream_op" or ins->inputs().empty())
+            continue;
+        auto output = ins->inputs().back();
+        if(output->name() != "load")
+            continue;
+        buffers.push_back({stream,
+                           output->get_operator().to_value()["offset"].to<std::size_t>(),
+                           output->get_shape().bytes()});
+    }
+    EXPECT(std::any_of(buffers.begin(), buffers.end(), [](auto b) { return b.stream == 0; }));
+    EXPECT(std::any_of(buffers.begin(), buffers.end(), [](auto b) { return b.stream == 1; }));
+    // Buffers used at the same time on different streams must not overlap, even when their
+    // lifetimes in program order do not
+    for(const auto& a : buffers)
+    {
+        for(const auto& b : buffers)
+        {
+            if(a.stream == b.stream)
+                continue;
+            EXPECT(a.offset + a.bytes <= b.offset or b.offset + b.bytes <= a.offset);
+        }
+    }
+}
+
+TEST_CASE(branches_streams_copies)
+{
+    auto p = create_branches();
+    p.compile(migraphx::cpu::target{2});
+    auto gold = run_ref();
+    // Each copy has its own streams, so the copies can be evaluated at the same time
+    std::vector<migraphx::program> copies(4, p);
+    std::vector<std::vector<float>> results(copies.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < copies.size(); i++)
+        threads.emplace_back([&, i] { results[i] = run(copies[i]); });
+    for(auto& t : threads)
+        t.join();
+    for(const auto& result : results)
+        EXPECT(migraphx::verify::verify_rms_range(result, gold));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/session.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+
+// The dot and the pointwise ops write into the scratch buffer of the context
+static migraphx::program create_dot_add()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64, 64}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto dot = mm->add_instruction(migraphx::make_op("dot"), x, y);
+    auto add = mm->add_instruction(migraphx::make_op("add"), dot, y);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, x);
+    mm->add_return({mul});
+    return p;
+}
+
+TEST_CASE(session_concurrent)
+{
+    auto p = create_dot_add();
+    p.compile(migraphx::cpu::target{});
+    const std::size_t n = 4;
+    std::vector<migraphx::parameter_map> params(n);
+    std::vector<migraphx::argument> expected(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        params[i]["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), i);
+        params[i]["y"] = migraphx::generate_argument(p.get_parameter_shape("y"), i + n);
+        // The output may live in the scratch buffer, which the next eval writes over
+        expected[i] = p.eval(params[i]).back().copy();
+    }
+
+    // Copies of a session get their own contexts, and so their own scratch buffers
+    migraphx::session s{p};
+    std::vector<migraphx::session> sessions(n, s);
+    std::vector<std::size_t> mismatches(n, 0);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        threads.emplace_back([&, i] {
+            for(std::size_t j = 0; j < 50; j++)
+            {
+                if(sessions[i].eval(params[i]).back() != expected[i])
+                    mismatches[i]++;
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(std::all_of(mismatches.begin(), mismatches.end(), [](auto x) { return x == 0; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
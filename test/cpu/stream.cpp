@@ -0,0 +1,179 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/stream.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(event_tickets)
+{
+    migraphx::cpu::event e;
+    EXPECT(e.last_issued() == 0);
+    // Nothing has been issued, so there is nothing to wait for
+    e.wait(e.last_issued());
+    auto t1 = e.issue();
+    auto t2 = e.issue();
+    EXPECT(t1 < t2);
+    EXPECT(e.last_issued() == t2);
+
+    std::atomic<bool> done{false};
+    std::thread waiter([&] {
+        e.wait(t2);
+        done = true;
+    });
+    e.signal(t1);
+    e.wait(t1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT(not done.load());
+    e.signal(t2);
+    waiter.join();
+    EXPECT(done.load());
+}
+
+TEST_CASE(event_signal_out_of_order)
+{
+    migraphx::cpu::event e;
+    auto t1 = e.issue();
+    auto t2 = e.issue();
+    e.signal(t2);
+    e.signal(t1);
+    // A later ticket covers the earlier ones
+    e.wait(t1);
+    e.wait(t2);
+    EXPECT(e.last_issued() == t2);
+}
+
+TEST_CASE(stream_inline)
+{
+    migraphx::cpu::stream s{false, 1};
+    std::thread::id id;
+    std::size_t threads = 0;
+    s.submit([&] {
+        id      = std::this_thread::get_id();
+        threads = migraphx::cpu::max_threads();
+    });
+    EXPECT(id == std::this_thread::get_id());
+    EXPECT(threads == 1);
+    s.sync();
+}
+
+TEST_CASE(stream_runs_in_order)
+{
+    migraphx::cpu::stream s{true, 1};
+    std::vector<std::size_t> order;
+    std::vector<std::thread::id> ids;
+    for(std::size_t i = 0; i < 100; i++)
+    {
+        s.submit([&, i] {
+            order.push_back(i);
+            ids.push_back(std::this_thread::get_id());
+        });
+    }
+    s.sync();
+    EXPECT(order.size() == 100);
+    EXPECT(std::is_sorted(order.begin(), order.end()));
+    EXPECT(std::all_of(ids.begin(), ids.end(), [&](auto id) { return id == ids.front(); }));
+    EXPECT(ids.front() != std::this_thread::get_id());
+}
+
+TEST_CASE(stream_budget)
+{
+    migraphx::cpu::stream s{true, 1};
+    std::size_t threads = 0;
+    s.submit([&] { threads = migraphx::cpu::max_threads(); });
+    s.sync();
+    EXPECT(threads == 1);
+}
+
+TEST_CASE(stream_sync_waits)
+{
+    migraphx::cpu::stream s{true, 1};
+    std::atomic<bool> done{false};
+    s.submit([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        done = true;
+    });
+    s.sync();
+    EXPECT(done.load());
+}
+
+TEST_CASE(stream_record_wait)
+{
+    migraphx::cpu::stream s1{true, 1};
+    migraphx::cpu::stream s2{true, 1};
+    migraphx::cpu::event e;
+    // The event is reused, as it is when a program is evaluated more than once
+    for(int i = 0; i < 3; i++)
+    {
+        std::atomic<int> x{0};
+        int seen = -1;
+        s1.submit([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            x = 1;
+        });
+        s1.record(e);
+        s2.wait(e);
+        s2.submit([&] { seen = x; });
+        s2.sync();
+        s1.sync();
+        EXPECT(seen == 1);
+    }
+}
+
+TEST_CASE(stream_sync_rethrows)
+{
+    migraphx::cpu::stream s{true, 1};
+    bool after = false;
+    s.submit([] { MIGRAPHX_THROW("stream error"); });
+    s.submit([&] { after = true; });
+    EXPECT(test::throws<migraphx::exception>([&] { s.sync(); }, "stream error"));
+    EXPECT(after);
+    // The error is only reported once, and the stream keeps running work
+    s.sync();
+    int x = 0;
+    s.submit([&] { x = 1; });
+    s.sync();
+    EXPECT(x == 1);
+}
+
+TEST_CASE(stream_set_streams)
+{
+    migraphx::cpu::stream_set ss{2};
+    std::thread::id id0;
+    std::thread::id id1;
+    ss.get_stream(0).submit([&] { id0 = std::this_thread::get_id(); });
+    ss.get_stream(1).submit([&] { id1 = std::this_thread::get_id(); });
+    ss.sync();
+    EXPECT(id0 == std::this_thread::get_id());
+    EXPECT(id1 != std::this_thread::get_id());
+    EXPECT(&ss.get_event(3) == &ss.get_event(3));
+    EXPECT(&ss.get_event(0) != &ss.get_event(1));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -83,13 +83,28 @@ TEST_CASE(cse_test2)
         auto one  = m2.add_literal(1);
         auto two  = m2.add_literal(2);
         auto sum1 = m2.add_instruction(migraphx::make_op("add"), one, two);
-        auto sum2 = m2.add_instruction(migraphx::make_op("add"), two, one);
-        auto sum3 = m2.add_instruction(migraphx::make_op("add"), sum1, sum2);
+        auto sum3 = m2.add_instruction(migraphx::make_op("add"), sum1, sum1);
         m2.add_instruction(pass_op{}, sum3);
     }
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_non_commutative)
+{
+    migraphx::module m1;
+    {
+        auto one  = m1.add_literal(1);
+        auto two  = m1.add_literal(2);
+        auto sub1 = m1.add_instruction(migraphx::make_op("sub"), one, two);
+        auto sub2 = m1.add_instruction(migraphx::make_op("sub"), two, one);
+        auto sum  = m1.add_instruction(migraphx::make_op("add"), sub1, sub2);
+        m1.add_instruction(pass_op{}, sum);
+    }
+    migraphx::module m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test3)
 {
     migraphx::module m1;
@@ -139,6 +154,32 @@ TEST_CASE(cse_test4)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_duplicate_chains)
+{
+    const std::size_t n = 1000;
+    auto add_chain      = [&](migraphx::module& m, migraphx::instruction_ref x) {
+        for(std::size_t i = 0; i < n; i++)
+            x = m.add_instruction(migraphx::make_op(i % 2 == 0 ? "add" : "mul"), x, x);
+        return x;
+    };
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", {migraphx::shape::float_type, {2, 3}});
+        auto c1 = add_chain(m1, x);
+        auto c2 = add_chain(m1, x);
+        m1.add_return({c1, c2});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", {migraphx::shape::float_type, {2, 3}});
+        auto c = add_chain(m2, x);
+        m2.add_return({c, c});
+    }
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test_literal)
 {
     migraphx::module m1;
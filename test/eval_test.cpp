@@ -28,6 +28,8 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/register_target.hpp>
 #include <sstream>
 #include "test.hpp"
 #include <basic_ops.hpp>
@@ -177,6 +179,20 @@ TEST_CASE(literal_test2)
     EXPECT(result != migraphx::literal{3});
 }
 
+TEST_CASE(literal_output_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    mm->add_return({one});
+    auto result = p.eval({}).back();
+    EXPECT(not result.is_read_only());
+    EXPECT(result.data() != one->get_literal().data());
+    std::vector<int> data = {2};
+    result.fill(data.begin(), data.end());
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+}
+
 TEST_CASE(print_test)
 {
     migraphx::program p;
@@ -499,6 +515,133 @@ TEST_CASE(eval_context3)
     EXPECT(not is_shared(t.ctx, p.get_context()));
 }
 
+TEST_CASE(eval_plan_copy)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, one, two);
+    p1.compile(id_target{});
+    migraphx::program p2 = p1;
+    p1                   = migraphx::program{};
+    auto result          = p2.eval({}).back();
+    EXPECT(result == migraphx::literal{3});
+}
+
+TEST_CASE(eval_plan_modified_after_compile)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    mm->add_instruction(sum_op{}, sum, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{5});
+}
+
+TEST_CASE(eval_plan_replace_instruction_after_compile)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    // The module keeps the same number of instructions
+    mm->replace_instruction(sum, minus_op{}, one, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{-1});
+}
+
+TEST_CASE(eval_plan_replace_argument_after_compile)
+{
+    migraphx::program p;
+    auto* mm   = p.get_main_module();
+    auto one   = mm->add_literal(1);
+    auto two   = mm->add_literal(2);
+    auto three = mm->add_literal(3);
+    auto sum   = mm->add_instruction(sum_op{}, one, two);
+    mm->add_instruction(sum_op{}, sum, one);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{4});
+    migraphx::instruction::replace_argument(sum, two, three);
+    EXPECT(p.eval({}).back() == migraphx::literal{5});
+}
+
+TEST_CASE(eval_plan_module_assigned_after_compile)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    migraphx::module m;
+    auto x = m.add_literal(1);
+    auto y = m.add_literal(2);
+    m.add_instruction(minus_op{}, x, y);
+    *mm = m;
+    EXPECT(p.eval({}).back() == migraphx::literal{-1});
+}
+
+TEST_CASE(eval_plan_unrelated_change_after_compile)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    // Modifying another program does not invalidate the plan
+    migraphx::program other;
+    other.get_main_module()->add_literal(1);
+    std::stringstream ss;
+    p.perf_report(ss, 1, {});
+    EXPECT(migraphx::contains(ss.str(), "(execution plan)"));
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+}
+
+TEST_CASE(eval_plan_submodule_outer_reference)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape cond_s{migraphx::shape::bool_type};
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    auto cond = mm->add_parameter("cond", cond_s);
+    auto x    = mm->add_parameter("x", s);
+    auto y    = mm->add_literal(migraphx::literal{s, {1, 2, 3}});
+
+    auto* then_mod = p.create_module("If_0_if");
+    auto add       = then_mod->add_instruction(migraphx::make_op("add"), x, y);
+    then_mod->add_return({add});
+
+    auto* else_mod = p.create_module("If_0_else");
+    auto mul       = else_mod->add_instruction(migraphx::make_op("mul"), x, y);
+    else_mod->add_return({mul});
+
+    auto ret = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    auto r   = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), ret);
+    mm->add_return({r});
+    p.compile(migraphx::make_target("ref"));
+
+    auto run = [&](bool c) {
+        std::vector<float> xdata = {2, 2, 2};
+        char cdata               = c ? 1 : 0;
+        migraphx::parameter_map params;
+        params["cond"] = migraphx::argument(cond_s, &cdata);
+        params["x"]    = migraphx::argument(s, xdata.data());
+        std::vector<float> result;
+        p.eval(params).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        return result;
+    };
+    EXPECT(run(true) == std::vector<float>{3, 4, 5});
+    EXPECT(run(false) == std::vector<float>{2, 4, 6});
+}
+
 struct cout_redirect
 {
     cout_redirect()                     = delete;
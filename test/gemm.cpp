@@ -0,0 +1,114 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/gemm.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include "test.hpp"
+
+// The unblocked dot product per element that gemm must match exactly
+template <class T, class U>
+static void naive_gemm(
+    migraphx::tensor_view<T> cmat, migraphx::tensor_view<U> amat, migraphx::tensor_view<U> bmat)
+{
+    auto cs    = cmat.get_shape();
+    auto dim_0 = cs.ndim() - 2;
+    auto dim_1 = cs.ndim() - 1;
+    auto k     = amat.get_shape().lens()[dim_1];
+    migraphx::shape_for_each(cs, [&](const auto& c_idx) {
+        auto a_idx = c_idx;
+        auto b_idx = c_idx;
+        double s   = 0.0;
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            a_idx[dim_1] = b_idx[dim_0] = kk;
+            s += static_cast<double>(amat(a_idx.begin(), a_idx.end())) *
+                 static_cast<double>(bmat(b_idx.begin(), b_idx.end()));
+        }
+        cmat(c_idx.begin(), c_idx.end()) = 1.0f * s + cmat(c_idx.begin(), c_idx.end()) * 0.0f;
+    });
+}
+
+static migraphx::shape transposed(migraphx::shape::type_t t, std::vector<std::size_t> lens)
+{
+    auto n = lens.size();
+    std::swap(lens[n - 1], lens[n - 2]);
+    migraphx::shape s{t, lens};
+    auto strides = s.strides();
+    std::swap(lens[n - 1], lens[n - 2]);
+    std::swap(strides[n - 1], strides[n - 2]);
+    return {t, lens, strides};
+}
+
+template <class T>
+static void check_gemm(migraphx::shape as, migraphx::shape bs)
+{
+    auto a      = migraphx::generate_argument(as, 1);
+    auto b      = migraphx::generate_argument(bs, 2);
+    auto lens   = as.lens();
+    lens.back() = bs.lens().back();
+    migraphx::shape cs{migraphx::shape::get_type<T>{}, lens};
+    migraphx::argument c1{cs};
+    migraphx::argument c2{cs};
+    migraphx::visit_all(a, b)([&](auto amat, auto bmat) {
+        migraphx::gemm(c1.get<T>(), amat, bmat, 1.0f, 0.0f);
+        naive_gemm(c2.get<T>(), amat, bmat);
+    });
+    EXPECT(c1 == c2);
+}
+
+TEST_CASE(gemm_small)
+{
+    check_gemm<float>({migraphx::shape::float_type, {3, 5}}, {migraphx::shape::float_type, {5, 4}});
+}
+
+TEST_CASE(gemm_multiple_tiles)
+{
+    check_gemm<float>({migraphx::shape::float_type, {70, 300}},
+                      {migraphx::shape::float_type, {300, 130}});
+}
+
+TEST_CASE(gemm_batched_transposed)
+{
+    check_gemm<float>(transposed(migraphx::shape::float_type, {2, 3, 33, 513}),
+                      transposed(migraphx::shape::float_type, {2, 3, 513, 65}));
+}
+
+TEST_CASE(gemm_half)
+{
+    check_gemm<migraphx::half>({migraphx::shape::half_type, {2, 40, 260}},
+                               {migraphx::shape::half_type, {2, 260, 70}});
+}
+
+TEST_CASE(gemm_int8)
+{
+    check_gemm<int32_t>({migraphx::shape::int8_type, {33, 64}},
+                        {migraphx::shape::int8_type, {64, 65}});
+}
+
+TEST_CASE(gemm_empty_k)
+{
+    check_gemm<float>({migraphx::shape::float_type, {4, 0}}, {migraphx::shape::float_type, {0, 3}});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
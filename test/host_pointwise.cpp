@@ -0,0 +1,160 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_pointwise.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/literal.hpp>
+#include <test.hpp>
+
+static migraphx::shape compute_output_shape(migraphx::module& m,
+                                            const std::vector<migraphx::argument>& args)
+{
+    return migraphx::make_op("pointwise").compute_shape(migraphx::to_shapes(args), {&m});
+}
+
+static void check_jit_interpreter(migraphx::module& m,
+                                  const std::vector<migraphx::argument>& args)
+{
+    auto s      = compute_output_shape(m, args);
+    auto jit    = migraphx::compute_host_pointwise(m, s, args, true);
+    auto interp = migraphx::compute_host_pointwise(m, s, args, false);
+    EXPECT(jit.get_shape() == interp.get_shape());
+    EXPECT(jit == interp);
+}
+
+TEST_CASE(add_sqrt_broadcast)
+{
+    migraphx::module m;
+    auto x   = m.add_parameter("x0", {migraphx::shape::float_type});
+    auto y   = m.add_parameter("x1", {migraphx::shape::float_type});
+    auto one = m.add_literal(1.0f);
+    auto add = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto sum = m.add_instruction(migraphx::make_op("add"), add, one);
+    m.add_return({m.add_instruction(migraphx::make_op("sqrt"), sum)});
+
+    migraphx::shape xs{migraphx::shape::float_type, {4, 3000}};
+    migraphx::shape ys{migraphx::shape::float_type, {4, 3000}, {1, 0}};
+    auto xa = migraphx::fill_argument(xs, 3.0f);
+    migraphx::argument ya{migraphx::shape{migraphx::shape::float_type, {4}}};
+    std::vector<float> ydata = {-4, -1, 0, 5};
+    ya.fill(ydata.begin(), ydata.end());
+    std::vector<migraphx::argument> args = {xa, ya.reshape(ys)};
+    auto result = migraphx::compute_host_pointwise(m, compute_output_shape(m, args), args);
+    auto v      = result.to_vector<float>();
+    EXPECT(v.size() == xs.elements());
+    EXPECT(test::within_abs(v[0], 0.0f));
+    EXPECT(test::within_abs(v[3000], std::sqrt(3.0f)));
+    EXPECT(test::within_abs(v[6000], 2.0f));
+    EXPECT(test::within_abs(v.back(), 3.0f));
+    check_jit_interpreter(m, args);
+}
+
+TEST_CASE(transposed_inputs)
+{
+    migraphx::module m;
+    auto x = m.add_parameter("x0", {migraphx::shape::float_type});
+    auto y = m.add_parameter("x1", {migraphx::shape::float_type});
+    m.add_return({m.add_instruction(migraphx::make_op("mul"), x, y)});
+
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 257}};
+    migraphx::shape ts{migraphx::shape::float_type, {2, 3, 257}, {771, 1, 3}};
+    auto xa = migraphx::generate_argument(s, 1);
+    auto ya = migraphx::generate_argument(ts, 2);
+    check_jit_interpreter(m, {xa, ya});
+    check_jit_interpreter(m, {ya, ya});
+}
+
+TEST_CASE(integer_overflow)
+{
+    migraphx::module m;
+    auto x   = m.add_parameter("x0", {migraphx::shape::int8_type});
+    auto y   = m.add_parameter("x1", {migraphx::shape::int8_type});
+    auto add = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto c   = m.add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), add);
+    m.add_return({m.add_instruction(migraphx::make_op("mul"), c, c)});
+
+    migraphx::shape s{migraphx::shape::int8_type, {100}};
+    std::vector<migraphx::argument> args = {migraphx::fill_argument(s, 100),
+                                            migraphx::fill_argument(s, 100)};
+    auto result = migraphx::compute_host_pointwise(m, compute_output_shape(m, args), args);
+    auto v      = result.to_vector<float>();
+    EXPECT(std::all_of(v.begin(), v.end(), [](auto x) { return x == 56.0f * 56.0f; }));
+    check_jit_interpreter(m, args);
+}
+
+TEST_CASE(convert_clamp)
+{
+    migraphx::module m;
+    auto x = m.add_parameter("x0", {migraphx::shape::float_type});
+    m.add_return({m.add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::int8_type}}), x)});
+
+    migraphx::shape s{migraphx::shape::float_type, {6}};
+    migraphx::argument a{s};
+    std::vector<float> data = {-1000.0f, -1.5f, 0.0f, 1.5f, 1000.0f, std::nanf("")};
+    a.fill(data.begin(), data.end());
+    auto result = migraphx::compute_host_pointwise(m, compute_output_shape(m, {a}), {a});
+    EXPECT(result.to_vector<int>() == std::vector<int>{-128, -1, 0, 1, 127, 0});
+    check_jit_interpreter(m, {a});
+}
+
+TEST_CASE(multi_output)
+{
+    migraphx::module m;
+    auto x   = m.add_parameter("x0", {migraphx::shape::float_type});
+    auto y   = m.add_parameter("x1", {migraphx::shape::float_type});
+    auto add = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto lt  = m.add_instruction(migraphx::make_op("less"), x, y);
+    auto b   = m.add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::bool_type}}), lt);
+    m.add_return({add, b});
+
+    migraphx::shape s{migraphx::shape::float_type, {3, 1025}};
+    std::vector<migraphx::argument> args = {migraphx::generate_argument(s, 1),
+                                            migraphx::generate_argument(s, 2)};
+    auto result  = migraphx::compute_host_pointwise(m, compute_output_shape(m, args), args);
+    auto outputs = result.get_sub_objects();
+    EXPECT(outputs.size() == 2);
+    EXPECT(outputs[1].get_shape().type() == migraphx::shape::bool_type);
+    check_jit_interpreter(m, args);
+}
+
+TEST_CASE(unsupported_type)
+{
+    migraphx::module m;
+    auto x = m.add_parameter("x0", {migraphx::shape::half_type});
+    auto y = m.add_parameter("x1", {migraphx::shape::half_type});
+    m.add_return({m.add_instruction(migraphx::make_op("add"), x, y)});
+
+    migraphx::shape s{migraphx::shape::half_type, {2048}};
+    std::vector<migraphx::argument> args = {migraphx::fill_argument(s, 1.0),
+                                            migraphx::fill_argument(s, 2.0)};
+    auto result = migraphx::compute_host_pointwise(m, compute_output_shape(m, args), args);
+    EXPECT(result == migraphx::fill_argument(s, 3.0));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -1191,4 +1191,68 @@ TEST_CASE(match_finder)
     match::find_matches(mm, match_find_sum{sum}, match_find_literal{sum});
 }
 
+template <class M>
+std::vector<std::string> sorted_root_names(M m)
+{
+    auto names = match::get_root_names(m);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TEST_CASE(match_root_names)
+{
+    using names = std::vector<std::string>;
+    EXPECT(sorted_root_names(match::name("sum")) == names{"sum"});
+    EXPECT(sorted_root_names(match::name("sum", "pass")) == names{"pass", "sum"});
+    EXPECT(sorted_root_names(match::name("sum").bind("x")) == names{"sum"});
+    EXPECT(sorted_root_names(match::name("sum")(match::arg(0)(match::name("@literal")))) ==
+           names{"sum"});
+    EXPECT(sorted_root_names(match::name("sum")(match::standard_shape()).bind("x")) ==
+           names{"sum"});
+    EXPECT(sorted_root_names(match::any_of(match::name("sum"), match::name("pass"))) ==
+           names{"pass", "sum"});
+    EXPECT(sorted_root_names(match::any_of(match::name("sum"), match::standard_shape())).empty());
+    EXPECT(sorted_root_names(match::all_of(match::standard_shape(),
+                                           match::name("sum", "pass"),
+                                           match::name("sum"))) == names{"sum"});
+    EXPECT(sorted_root_names(match::none_of(match::name("sum"))).empty());
+    EXPECT(sorted_root_names(match::standard_shape()).empty());
+    EXPECT(sorted_root_names(match::skip(match::name("pass"))(match::name("sum"))).empty());
+    EXPECT(sorted_root_names(match::any_matcher{match::name("sum")}) == names{"sum"});
+}
+
+struct match_find_record
+{
+    std::string id;
+    std::function<match::any_matcher()> make_matcher;
+    std::vector<std::pair<std::string, std::string>>* applied;
+    auto matcher() const { return make_matcher(); }
+
+    void apply(migraphx::module&, const match::matcher_result& r) const
+    {
+        applied->emplace_back(id, r.result->name());
+    }
+};
+
+TEST_CASE(match_finder_dispatch)
+{
+    migraphx::module mm;
+    auto one = mm.add_literal(1);
+    auto two = mm.add_literal(2);
+    auto sum = mm.add_instruction(sum_op{}, one, two);
+    mm.add_instruction(pass_op{}, sum);
+
+    std::vector<std::pair<std::string, std::string>> applied;
+    match_find_record find_pass{"pass", [] { return match::name("pass"); }, &applied};
+    match_find_record find_any{"any", [] { return match::any(); }, &applied};
+    match_find_record find_sum{"sum", [] { return match::name("sum"); }, &applied};
+    match::find_matches(mm, find_pass, find_any, find_sum);
+
+    // The first matcher that matches is applied, and restricted matchers keep their order relative
+    // to unrestricted ones
+    std::vector<std::pair<std::string, std::string>> expected = {
+        {"any", "@literal"}, {"any", "@literal"}, {"any", "sum"}, {"pass", "pass"}};
+    EXPECT(applied == expected);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -28,6 +28,7 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/make_op.hpp>
 #include <basic_ops.hpp>
+#include <random>
 #include <test.hpp>
 
 void run_pass(migraphx::module& m)
@@ -3805,4 +3806,27 @@ TEST_CASE(test_tuple)
     CHECK(is_disjoint({a1, a2}));
 }
 
+TEST_CASE(large_module)
+{
+    // Each pass reads a few of the recent results, so many allocations are live at the same time.
+    // The pass checks that none of them overlap.
+    migraphx::module m;
+    std::mt19937 gen(0);
+    std::vector<migraphx::instruction_ref> results;
+    for(std::size_t i = 0; i < 2000; i++)
+    {
+        std::size_t n = 1 + gen() % 64;
+        std::vector<migraphx::instruction_ref> inputs = {
+            add_alloc(m, {migraphx::shape::float_type, {n}})};
+        std::size_t window = std::min<std::size_t>(results.size(), 32);
+        for(std::size_t j = 0; j < std::min<std::size_t>(window, 3); j++)
+            inputs.push_back(results[results.size() - 1 - gen() % window]);
+        results.push_back(m.add_instruction(pass_op{}, inputs));
+    }
+    m.add_instruction(pass_op{}, {results.end() - 4, results.end()});
+    run_pass(m);
+    CHECK(no_allocate(m));
+    CHECK(m.get_parameter_shape("scratch").bytes() < 32 * 64 * 4 * 4);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
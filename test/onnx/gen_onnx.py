@@ -26,6 +26,7 @@
 # command: python3 -c "import gen_onnx; gen_onnx.{test_name}_test()"
 import numpy as np
 import onnx
+import onnx.external_data_helper
 from onnx import helper
 from onnx import TensorProto
 from onnx.numpy_helper import from_array
@@ -3516,6 +3517,79 @@ def external_constant_test():
     return ([node], [], [y])
 
 
+def make_external_tensors(location, tensors, size=None):
+    # Writes the tensors at the given offsets of one external data file
+    data = bytearray()
+    result = []
+    for name, x, offset, length in tensors:
+        raw = x.tobytes()
+        if len(data) < offset + len(raw):
+            data.extend(bytes(offset + len(raw) - len(data)))
+        data[offset:offset + len(raw)] = raw
+        tensor = from_array(x, name)
+        onnx.external_data_helper.set_external_data(tensor, location, offset,
+                                                    length)
+        tensor.ClearField('raw_data')
+        tensor.data_location = TensorProto.EXTERNAL
+        result.append(tensor)
+    if size is not None:
+        data = data[:size]
+    with open(location, 'wb') as f:
+        f.write(data)
+    return result
+
+
+@onnx_test()
+def external_data_alias_test():
+    a = np.array([1, 2, 3, 4]).astype(np.float32)
+    b = np.array([5, 6, 7, 8]).astype(np.float32)
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [4])
+    tensors = make_external_tensors('external_data_alias_test.weight',
+                                    [('a', a, 0, None), ('b', b, 16, None)])
+
+    node = onnx.helper.make_node('Add', inputs=['a', 'b'], outputs=['y'])
+
+    return ([node], [], [y], tensors)
+
+
+@onnx_test()
+def external_data_unaligned_test():
+    a = np.array([1, 2, 3, 4]).astype(np.float32)
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [4])
+    tensors = make_external_tensors('external_data_unaligned_test.weight',
+                                    [('a', a, 2, 16)])
+
+    node = onnx.helper.make_node('Add', inputs=['a', 'a'], outputs=['y'])
+
+    return ([node], [], [y], tensors)
+
+
+@onnx_test()
+def external_data_length_out_of_range_test():
+    a = np.array([1, 2, 3, 4]).astype(np.float32)
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [4])
+    tensors = make_external_tensors(
+        'external_data_length_out_of_range_test.weight', [('a', a, 8, 16)],
+        size=16)
+
+    node = onnx.helper.make_node('Add', inputs=['a', 'a'], outputs=['y'])
+
+    return ([node], [], [y], tensors)
+
+
+@onnx_test()
+def external_data_offset_out_of_range_test():
+    a = np.array([1, 2, 3, 4]).astype(np.float32)
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [4])
+    tensors = make_external_tensors(
+        'external_data_offset_out_of_range_test.weight', [('a', a, 64, None)],
+        size=16)
+
+    node = onnx.helper.make_node('Add', inputs=['a', 'a'], outputs=['y'])
+
+    return ([node], [], [y], tensors)
+
+
 @onnx_test()
 def eyelike_default_test():
     T1 = helper.make_tensor_value_info('T1', TensorProto.FLOAT, [3, 4])
@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/op_cost.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <pointwise.hpp>
+#include <test.hpp>
+
+TEST_CASE(dot_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", {migraphx::shape::float_type, {2, 4, 8}});
+    auto b   = mm->add_parameter("b", {migraphx::shape::float_type, {2, 8, 16}});
+    auto dot = mm->add_instruction(migraphx::make_op("dot"), a, b);
+
+    auto cost = migraphx::estimate_cost(dot);
+    EXPECT(cost.flops == 2.0 * 2 * 4 * 16 * 8);
+    EXPECT(cost.bytes == 4.0 * (2 * 4 * 8 + 2 * 8 * 16 + 2 * 4 * 16));
+    EXPECT(cost.intensity() == cost.flops / cost.bytes);
+}
+
+TEST_CASE(convolution_cost)
+{
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto x    = mm->add_parameter("x", {migraphx::shape::float_type, {1, 4, 8, 8}});
+    auto w    = mm->add_parameter("w", {migraphx::shape::float_type, {6, 2, 3, 3}});
+    auto conv = mm->add_instruction(
+        migraphx::make_op("convolution", {{"padding", {1, 1}}, {"group", 2}}), x, w);
+
+    auto cost = migraphx::estimate_cost(conv);
+    EXPECT(cost.flops == 2.0 * (1 * 6 * 8 * 8) * (2 * 3 * 3));
+    EXPECT(cost.bytes == 4.0 * (1 * 4 * 8 * 8 + 6 * 2 * 3 * 3 + 1 * 6 * 8 * 8));
+}
+
+TEST_CASE(reduce_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 16}});
+    auto r   = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), x);
+
+    auto cost = migraphx::estimate_cost(r);
+    EXPECT(cost.flops == 64);
+    EXPECT(cost.bytes == 4.0 * (64 + 4));
+}
+
+TEST_CASE(pointwise_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = mm->add_parameter("x", s);
+    auto y  = mm->add_parameter("y", s);
+    auto pw = add_pointwise(p, "main:pointwise0", {x, y}, [](auto* pm, const auto& inputs) {
+        auto add = pm->add_instruction(migraphx::make_op("add"), inputs[0], inputs[1]);
+        return pm->add_instruction(migraphx::make_op("relu"), add);
+    });
+
+    auto cost = migraphx::estimate_cost(pw);
+    EXPECT(cost.flops == 2 * 6);
+    EXPECT(cost.bytes == 3 * s.bytes());
+}
+
+TEST_CASE(gather_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto data = mm->add_parameter("data", {migraphx::shape::float_type, {1000, 16}});
+    auto indices = mm->add_parameter("indices", {migraphx::shape::int32_type, {4}});
+    auto g = mm->add_instruction(migraphx::make_op("gather", {{"axis", 0}}), data, indices);
+
+    auto cost = migraphx::estimate_cost(g);
+    EXPECT(cost.flops == 0);
+    EXPECT(cost.bytes == 4 * 4 + 2 * 4 * 4 * 16);
+}
+
+TEST_CASE(view_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2, 3}});
+    auto t = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+    auto c = mm->add_instruction(migraphx::make_op("contiguous"), t);
+
+    EXPECT(migraphx::estimate_cost(x) == migraphx::op_cost{});
+    EXPECT(migraphx::estimate_cost(t) == migraphx::op_cost{});
+    EXPECT(migraphx::estimate_cost(c) == migraphx::op_cost{0, 2 * 6 * 4});
+}
+
+TEST_CASE(dynamic_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 4}, {3, 3}}};
+    auto x = mm->add_parameter("x", s);
+    auto r = mm->add_instruction(migraphx::make_op("relu"), x);
+
+    EXPECT(migraphx::estimate_cost(r) == migraphx::op_cost{});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
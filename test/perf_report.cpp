@@ -47,6 +47,11 @@ TEST_CASE(perf_report)
     EXPECT(migraphx::contains(output, "Total instructions time:"));
     EXPECT(migraphx::contains(output, "Overhead time:"));
     EXPECT(migraphx::contains(output, "Overhead:"));
+    EXPECT(migraphx::contains(output, "Eval overhead per run:"));
+    EXPECT(migraphx::contains(output, "(execution plan)"));
+    EXPECT(migraphx::contains(output, "GFLOP/s"));
+    EXPECT(migraphx::contains(output, "GB/s"));
+    EXPECT(migraphx::contains(output, "FLOP/B"));
     EXPECT(not migraphx::contains(output, "fast"));
 }
 
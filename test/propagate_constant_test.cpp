@@ -26,7 +26,9 @@
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
 #include <basic_ops.hpp>
+#include <cmath>
 
 #include <test.hpp>
 
@@ -99,6 +101,54 @@ TEST_CASE(const_add_mul)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(const_shared_chain)
+{
+    // Each add uses the previous result twice, so evaluating every path would be exponential
+    migraphx::module m1;
+    {
+        auto x = m1.add_literal(1.0f);
+        for(int i = 0; i < 64; i++)
+            x = m1.add_instruction(migraphx::make_op("add"), x, x);
+        EXPECT(x->can_eval());
+        EXPECT(x->eval().at<float>() == std::ldexp(1.0f, 64));
+        m1.add_instruction(non_const_pass_op{}, x);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto total = m2.add_literal(std::ldexp(1.0f, 64));
+        m2.add_instruction(non_const_pass_op{}, total);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(const_shared_roots)
+{
+    migraphx::module m1;
+    {
+        auto one  = m1.add_literal(1);
+        auto two  = m1.add_literal(2);
+        auto mul  = m1.add_instruction(migraphx::make_op("mul"), two, two);
+        auto sum1 = m1.add_instruction(migraphx::make_op("add"), one, mul);
+        auto sum2 = m1.add_instruction(migraphx::make_op("add"), sum1, mul);
+        auto pass1 = m1.add_instruction(non_const_pass_op{}, sum1);
+        auto pass2 = m1.add_instruction(non_const_pass_op{}, sum2);
+        m1.add_return({pass1, pass2});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto five = m2.add_literal(5);
+        auto nine = m2.add_literal(9);
+        auto pass1 = m2.add_instruction(non_const_pass_op{}, five);
+        auto pass2 = m2.add_instruction(non_const_pass_op{}, nine);
+        m2.add_return({pass1, pass2});
+    }
+    EXPECT(m1.sort() == m2.sort());
+}
+
 TEST_CASE(const_add_scalar)
 {
     migraphx::module m1;
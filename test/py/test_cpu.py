@@ -21,7 +21,7 @@
 # OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 # THE SOFTWARE.
 #####################################################################################
-import migraphx, array, sys
+import migraphx, array, sys, threading
 
 
 def test_conv_relu():
@@ -76,6 +76,30 @@ def test_add_scalar():
     print(r)
 
 
+def test_sessions():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+    expected = p.run(params)[-1].tolist()
+
+    results = []
+
+    def run(s):
+        for i in range(4):
+            results.append(s.run(params)[-1].tolist())
+
+    sessions = [migraphx.session(p) for i in range(4)]
+    threads = [threading.Thread(target=run, args=(s, )) for s in sessions]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert len(results) == 16
+    assert all(r == expected for r in results)
+
+
 def test_module():
     p = migraphx.parse_onnx("add_scalar_test.onnx")
     mm = p.get_main_module()
@@ -84,6 +108,7 @@ def test_module():
 
 
 test_conv_relu()
+test_sessions()
 test_module()
 if sys.version_info >= (3, 0):
     test_add_scalar()
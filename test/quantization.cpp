@@ -44,6 +44,7 @@
 #include <migraphx/argument.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/shape.hpp>
+#include <migraphx/tmp_dir.hpp>
 #include "test.hpp"
 #include <migraphx/half.hpp>
 
@@ -1131,6 +1132,143 @@ TEST_CASE(int8_quantization_dot)
     }
 }
 
+static migraphx::program create_int8_dot_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape sa{migraphx::shape::float_type, {2, 16}};
+    migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+    auto pa = mm->add_parameter("a", sa);
+    auto pb = mm->add_parameter("b", sb);
+    auto r  = mm->add_instruction(migraphx::make_op("dot"), pa, pb);
+    mm->add_return({r});
+    return p;
+}
+
+static std::vector<migraphx::parameter_map> create_int8_dot_calibration(std::size_t n)
+{
+    std::vector<migraphx::parameter_map> cali_data;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        migraphx::parameter_map m;
+        m["a"] = migraphx::generate_argument({migraphx::shape::float_type, {2, 16}}, i);
+        m["b"] = migraphx::generate_argument({migraphx::shape::float_type, {16, 8}}, i + n);
+        cali_data.push_back(m);
+    }
+    return cali_data;
+}
+
+static std::vector<float> eval_int8_dot(migraphx::program p,
+                                        const migraphx::target& t,
+                                        const migraphx::parameter_map& m)
+{
+    p.compile(t);
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+    return result;
+}
+
+TEST_CASE(int8_quantization_methods)
+{
+    migraphx::target ref_t = migraphx::make_target("ref");
+    auto cali_data         = create_int8_dot_calibration(8);
+    auto expected          = eval_int8_dot(create_int8_dot_program(), ref_t, cali_data.front());
+    for(auto method : {migraphx::calibration_method::max,
+                       migraphx::calibration_method::percentile,
+                       migraphx::calibration_method::entropy})
+    {
+        migraphx::calibration_options options;
+        options.method = method;
+        auto p         = create_int8_dot_program();
+        migraphx::quantize_int8(p, ref_t, cali_data, options);
+        EXPECT(std::any_of(p.get_main_module()->begin(),
+                           p.get_main_module()->end(),
+                           [](const auto& ins) { return ins.name() == "quant_dot"; }));
+        auto result = eval_int8_dot(p, ref_t, cali_data.front());
+        EXPECT(migraphx::verify::verify_range_with_tolerance(
+            result, migraphx::verify::expected{expected}, migraphx::verify::tolerance{0.05}));
+    }
+}
+
+TEST_CASE(int8_quantization_cache_file)
+{
+    migraphx::tmp_dir td{"quantization"};
+    migraphx::target ref_t = migraphx::make_target("ref");
+    migraphx::calibration_options options;
+    options.method     = migraphx::calibration_method::percentile;
+    options.cache_file = (td.path / "calibration.json").string();
+
+    auto p1 = create_int8_dot_program();
+    migraphx::quantize_int8(p1, ref_t, create_int8_dot_calibration(4), options);
+    EXPECT(migraphx::fs::exists(options.cache_file));
+
+    // The ranges are read back from the cache, so no calibration data is needed
+    auto p2 = create_int8_dot_program();
+    migraphx::quantize_int8(p2, ref_t, {}, options);
+    EXPECT(p1 == p2);
+
+    // Without the cache the ranges come from the (empty) calibration data
+    auto p3            = create_int8_dot_program();
+    auto cache_file    = options.cache_file;
+    options.cache_file = "";
+    migraphx::quantize_int8(p3, ref_t, {}, options);
+    EXPECT(p1 != p3);
+
+    // The cache is not used with other options
+    auto p4            = create_int8_dot_program();
+    options.cache_file = cache_file;
+    options.percentile = 99.0;
+    migraphx::quantize_int8(p4, ref_t, {}, options);
+    EXPECT(p1 != p4);
+}
+
+TEST_CASE(int8_quantization_cache_file_other_program)
+{
+    migraphx::tmp_dir td{"quantization"};
+    migraphx::target ref_t = migraphx::make_target("ref");
+    migraphx::calibration_options options;
+    options.cache_file = (td.path / "calibration.json").string();
+
+    // The same number of tensors are captured in a program with other weights, which must not
+    // reuse the ranges of the first program
+    auto create_program = [](float x) {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape sa{migraphx::shape::float_type, {2, 16}};
+        migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+        auto pa = mm->add_parameter("a", sa);
+        auto lb = mm->add_literal(migraphx::literal{sb, std::vector<float>(sb.elements(), x)});
+        auto r  = mm->add_instruction(migraphx::make_op("dot"), pa, lb);
+        mm->add_return({r});
+        return p;
+    };
+    auto p1 = create_program(1.0f);
+    migraphx::quantize_int8(p1, ref_t, create_int8_dot_calibration(4), options);
+    EXPECT(migraphx::fs::exists(options.cache_file));
+
+    auto p2 = create_program(2.0f);
+    migraphx::quantize_int8(p2, ref_t, {}, options);
+    auto p3            = create_program(2.0f);
+    options.cache_file = "";
+    migraphx::quantize_int8(p3, ref_t, {}, options);
+    EXPECT(p2 == p3);
+}
+
+TEST_CASE(int8_quantization_concurrency)
+{
+    migraphx::target ref_t = migraphx::make_target("ref");
+    auto cali_data         = create_int8_dot_calibration(8);
+    migraphx::calibration_options options;
+    options.method      = migraphx::calibration_method::entropy;
+    options.concurrency = 1;
+    auto p1             = create_int8_dot_program();
+    migraphx::quantize_int8(p1, ref_t, cali_data, options);
+    options.concurrency = 3;
+    auto p2             = create_int8_dot_program();
+    migraphx::quantize_int8(p2, ref_t, cali_data, options);
+    EXPECT(p1 == p2);
+}
+
 TEST_CASE(int8_quantization_conv)
 {
     auto run_prog = [](migraphx::program p,
@@ -0,0 +1,194 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/preallocate_param.hpp>
+#include <migraphx/ref/allocation_model.hpp>
+#include <migraphx/ref/plan_memory.hpp>
+#include <limits>
+
+#include <test.hpp>
+
+// Runs the passes of the planned memory mode on a program compiled for ref
+static void plan_memory(migraphx::program& p)
+{
+    migraphx::run_passes(p,
+                         {migraphx::ref::plan_memory{},
+                          migraphx::dead_code_elimination{},
+                          migraphx::memory_coloring{"ref::allocate"},
+                          migraphx::dead_code_elimination{},
+                          migraphx::preallocate_param{"scratch",
+                                                      migraphx::ref::ref_allocation_model{}},
+                          migraphx::dead_code_elimination{}});
+}
+
+static migraphx::program create_chain()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 8}};
+    auto x    = mm->add_parameter("x", s);
+    auto y    = mm->add_parameter("y", s);
+    auto add  = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto relu = mm->add_instruction(migraphx::make_op("relu"), add);
+    auto tr =
+        mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), relu);
+    auto c   = mm->add_instruction(migraphx::make_op("contiguous"), tr);
+    auto w   = mm->add_literal(migraphx::generate_literal({migraphx::shape::float_type, {4, 3}}));
+    auto dot = mm->add_instruction(migraphx::make_op("dot"), c, w);
+    auto neg = mm->add_instruction(migraphx::make_op("neg"), dot);
+    auto exp = mm->add_instruction(migraphx::make_op("exp"), neg);
+    auto sig = mm->add_instruction(migraphx::make_op("sigmoid"), exp);
+    mm->add_return({sig, relu});
+    return p;
+}
+
+static migraphx::parameter_map create_params(const migraphx::program& p, unsigned long seed)
+{
+    migraphx::parameter_map params;
+    for(auto&& [name, s] : p.get_parameter_shapes())
+        params[name] = migraphx::generate_argument(s, seed++);
+    return params;
+}
+
+static std::vector<migraphx::argument> copy_results(const std::vector<migraphx::argument>& r)
+{
+    std::vector<migraphx::argument> result;
+    std::transform(
+        r.begin(), r.end(), std::back_inserter(result), [](const auto& a) { return a.copy(); });
+    return result;
+}
+
+TEST_CASE(plan_memory_results)
+{
+    auto p1 = create_chain();
+    p1.compile(migraphx::make_target("ref"));
+    auto p2 = create_chain();
+    p2.compile(migraphx::make_target("ref"));
+    plan_memory(p2);
+
+    const auto* mm = p2.get_main_module();
+    EXPECT(
+        std::any_of(mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "load"; }));
+    EXPECT(std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "ref::preallocate"; }));
+    EXPECT(std::none_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "ref::allocate"; }));
+
+    auto params = create_params(p1, 0);
+    EXPECT(p1.eval(params) == p2.eval(params));
+}
+
+TEST_CASE(plan_memory_in_place)
+{
+    auto p = create_chain();
+    p.compile(migraphx::make_target("ref"));
+    plan_memory(p);
+    auto* mm = p.get_main_module();
+    // neg and exp read a single use input that is not returned, so they can run in place
+    auto in_place = std::count_if(mm->begin(), mm->end(), [](const auto& ins) {
+        if(ins.name() != "ref::compute_into")
+            return false;
+        const auto& inputs = ins.inputs();
+        return std::find(inputs.begin(), inputs.end() - 1, inputs.back()) != inputs.end() - 1;
+    });
+    EXPECT(in_place == 2);
+}
+
+TEST_CASE(plan_memory_returned)
+{
+    // Returned values must not be overwritten by the next evaluation
+    auto p = create_chain();
+    p.compile(migraphx::make_target("ref"));
+    plan_memory(p);
+    auto results1 = p.eval(create_params(p, 0));
+    auto expected = copy_results(results1);
+    auto results2 = p.eval(create_params(p, 7));
+    EXPECT(results1 == expected);
+    EXPECT(results2 != expected);
+}
+
+TEST_CASE(compute_into_layout)
+{
+    // The buffer may not have the layout of the result
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape ts{migraphx::shape::float_type, {2, 3}, {1, 2}};
+    auto x = migraphx::generate_argument(s);
+    migraphx::argument buffer{ts};
+    auto neg    = migraphx::make_op("neg");
+    auto op     = migraphx::make_op("ref::compute_into",
+                                    {{"name", neg.name()}, {"operator", neg.to_value()}});
+    auto ctx    = migraphx::make_target("ref").get_context();
+    auto result = op.compute(ctx, s, {x, buffer});
+    EXPECT(result.data() == buffer.data());
+
+    std::vector<float> expected;
+    x.visit([&](auto v) {
+        std::transform(v.begin(), v.end(), std::back_inserter(expected), [](auto e) { return -e; });
+    });
+    std::vector<float> actual;
+    result.visit([&](auto v) { actual.assign(v.begin(), v.end()); });
+    EXPECT(actual == expected);
+}
+
+TEST_CASE(compute_into_buffer)
+{
+    // The buffer is written directly, and whatever it held before is not read
+    migraphx::shape as{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape bs{migraphx::shape::float_type, {3, 4}};
+    migraphx::shape cs{migraphx::shape::float_type, {2, 4}};
+    auto a = migraphx::generate_argument(as, 0);
+    auto b = migraphx::generate_argument(bs, 1);
+    migraphx::argument buffer{cs};
+    buffer.visit([](auto v) {
+        std::fill(v.begin(), v.end(), std::numeric_limits<float>::quiet_NaN());
+    });
+    auto dot = migraphx::make_op("ref::dot");
+    EXPECT(dot.attributes().get("compute_into", false));
+    auto ctx    = migraphx::make_target("ref").get_context();
+    auto result = dot.compute(ctx, cs, {a, b, buffer});
+    EXPECT(result.data() == buffer.data());
+    EXPECT(result == migraphx::make_op("dot").compute(cs, {a, b}));
+}
+
+TEST_CASE(compute_into_convolution)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {1, 2, 4, 4}};
+    migraphx::shape ws{migraphx::shape::float_type, {3, 2, 3, 3}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 3, 2, 2}};
+    auto x    = migraphx::generate_argument(xs, 0);
+    auto w    = migraphx::generate_argument(ws, 1);
+    auto conv = migraphx::make_op("convolution");
+    migraphx::argument buffer{ys};
+    auto result = conv.compute(ys, {x, w, buffer});
+    EXPECT(result.data() == buffer.data());
+    EXPECT(result == conv.compute(ys, {x, w}));
+}
@@ -21,9 +21,12 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <migraphx/generate.hpp>
+#include <migraphx/host_pointwise.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/op/pointwise.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/verify.hpp>
@@ -77,3 +80,57 @@ TEST_CASE(pointwise_multi_out_test)
     EXPECT(results[0].to_vector<float>() == gold1);
     EXPECT(results[1].to_vector<float>() == gold2);
 }
+
+TEST_CASE(pointwise_bypass_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    auto x   = mm->add_parameter("x", s);
+    auto l   = mm->add_literal(migraphx::literal{s, {1, 2, 3}});
+    auto* pm = p.create_module("pointwise");
+    pm->set_bypass();
+    {
+        auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+        auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+        auto mul = pm->add_instruction(migraphx::make_op("mul"), x1, x2);
+        pm->add_return({mul});
+    }
+    auto pw = mm->add_instruction(migraphx::make_op("pointwise"), {x, l}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    // The module is left for the host kernel, which is prepared once when the program is
+    // finalized
+    EXPECT(migraphx::host_pointwise::is_supported(*pm));
+    EXPECT(migraphx::any_cast<migraphx::op::pointwise>(pw->get_operator()).prepared != nullptr);
+    for(float v : {1.0f, 2.0f})
+    {
+        migraphx::parameter_map params;
+        params["x"]  = migraphx::fill_argument(s, v);
+        auto result  = p.eval(params).back();
+        std::vector<float> gold = {v, 2 * v, 3 * v};
+        EXPECT(result.to_vector<float>() == gold);
+    }
+}
+
+TEST_CASE(pointwise_lowered_module_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    auto l1  = mm->add_literal(migraphx::literal{s, {-1, 0, 1}});
+    auto l2  = mm->add_literal(migraphx::literal{s, {1, 2, 3}});
+    auto* pm = p.create_module("pointwise");
+    {
+        auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+        auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+        auto sub = pm->add_instruction(migraphx::make_op("sub"), x1, x2);
+        pm->add_return({sub});
+    }
+    mm->add_instruction(migraphx::make_op("pointwise"), {l1, l2}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    // The target lowered the ops of the module, so it has to run with the target's context
+    EXPECT(not migraphx::host_pointwise::is_supported(*pm));
+    auto result             = p.eval({}).back();
+    std::vector<float> gold = {-2, -2, -2};
+    EXPECT(result.to_vector<float>() == gold);
+}
@@ -0,0 +1,173 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/rewrite_rnn.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/op/common.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/verify.hpp>
+#include <test.hpp>
+
+static std::size_t gates(const std::string& name)
+{
+    if(name == "gru")
+        return 3;
+    if(name == "lstm")
+        return 4;
+    return 1;
+}
+
+static migraphx::program create_rnn_program(const std::string& name,
+                                            migraphx::op::rnn_direction dirct,
+                                            std::size_t seq_len,
+                                            std::vector<int32_t> seq_lens = {})
+{
+    std::size_t batch_size  = 2;
+    std::size_t hidden_size = 5;
+    std::size_t input_size  = 3;
+    std::size_t num_dirct   = dirct == migraphx::op::rnn_direction::bidirectional ? 2 : 1;
+    std::size_t ngates      = gates(name);
+    migraphx::shape in_shape{migraphx::shape::float_type, {seq_len, batch_size, input_size}};
+    migraphx::shape w_shape{migraphx::shape::float_type,
+                            {num_dirct, ngates * hidden_size, input_size}};
+    migraphx::shape r_shape{migraphx::shape::float_type,
+                            {num_dirct, ngates * hidden_size, hidden_size}};
+    migraphx::shape b_shape{migraphx::shape::float_type, {num_dirct, 2 * ngates * hidden_size}};
+    migraphx::shape ih_shape{migraphx::shape::float_type, {num_dirct, batch_size, hidden_size}};
+    migraphx::shape pph_shape{migraphx::shape::float_type, {num_dirct, 3 * hidden_size}};
+
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto seq  = mm->add_literal(migraphx::generate_literal(in_shape, 0));
+    auto w    = mm->add_literal(migraphx::generate_literal(w_shape, 1));
+    auto r    = mm->add_literal(migraphx::generate_literal(r_shape, 2));
+    auto bias = mm->add_literal(migraphx::generate_literal(b_shape, 3));
+    auto ih   = mm->add_literal(migraphx::generate_literal(ih_shape, 4));
+    auto sl   = mm->add_instruction(migraphx::make_op("undefined"));
+    if(not seq_lens.empty())
+        sl = mm->add_literal(
+            migraphx::literal{{migraphx::shape::int32_type, {batch_size}}, seq_lens});
+    std::vector<migraphx::instruction_ref> args{seq, w, r, bias, sl, ih};
+    if(name == "lstm")
+    {
+        args.push_back(mm->add_literal(migraphx::generate_literal(ih_shape, 5)));
+        args.push_back(mm->add_literal(migraphx::generate_literal(pph_shape, 6)));
+    }
+    auto hs = mm->add_instruction(
+        migraphx::make_op(name,
+                          {{"hidden_size", hidden_size}, {"direction", migraphx::to_value(dirct)}}),
+        args);
+    std::vector<migraphx::instruction_ref> outputs{
+        hs, mm->add_instruction(migraphx::make_op("rnn_last_hs_output"), hs)};
+    if(name == "lstm")
+        outputs.push_back(mm->add_instruction(migraphx::make_op("rnn_last_cell_output"), hs));
+    mm->add_return(outputs);
+    return p;
+}
+
+static std::vector<migraphx::argument> run(migraphx::program p, bool use_loop)
+{
+    if(use_loop)
+        migraphx::run_passes(p, {migraphx::rewrite_rnn{true}, migraphx::dead_code_elimination{}});
+    p.compile(migraphx::make_target("ref"));
+    return p.eval({});
+}
+
+static bool loop_matches_unrolled(const migraphx::program& p)
+{
+    auto gold    = run(p, false);
+    auto results = run(p, true);
+    if(gold.size() != results.size())
+        return false;
+    for(std::size_t i = 0; i < gold.size(); ++i)
+    {
+        std::vector<float> gold_vector;
+        std::vector<float> results_vector;
+        gold[i].visit([&](auto output) { gold_vector.assign(output.begin(), output.end()); });
+        results[i].visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+        if(gold[i].get_shape() != results[i].get_shape() or
+           not migraphx::verify::verify_rms_range(results_vector, gold_vector))
+            return false;
+    }
+    return true;
+}
+
+static const std::vector<migraphx::op::rnn_direction>& directions()
+{
+    static const std::vector<migraphx::op::rnn_direction> result = {
+        migraphx::op::rnn_direction::forward,
+        migraphx::op::rnn_direction::reverse,
+        migraphx::op::rnn_direction::bidirectional};
+    return result;
+}
+
+TEST_CASE(rnn_loop)
+{
+    for(auto dirct : directions())
+        EXPECT(loop_matches_unrolled(create_rnn_program("rnn", dirct, 6)));
+}
+
+TEST_CASE(gru_loop)
+{
+    for(auto dirct : directions())
+        EXPECT(loop_matches_unrolled(create_rnn_program("gru", dirct, 6)));
+}
+
+TEST_CASE(lstm_loop)
+{
+    for(auto dirct : directions())
+        EXPECT(loop_matches_unrolled(create_rnn_program("lstm", dirct, 6)));
+}
+
+TEST_CASE(lstm_loop_shorter_seq_lens)
+{
+    for(auto dirct : directions())
+        EXPECT(loop_matches_unrolled(create_rnn_program("lstm", dirct, 6, {4, 4})));
+}
+
+TEST_CASE(gru_loop_variable_seq_lens)
+{
+    for(auto dirct : directions())
+        EXPECT(loop_matches_unrolled(create_rnn_program("gru", dirct, 6, {6, 3})));
+}
+
+TEST_CASE(loop_size_independent_of_seq_len)
+{
+    auto lower = [](std::size_t seq_len) {
+        auto p = create_rnn_program("lstm", migraphx::op::rnn_direction::forward, seq_len);
+        migraphx::run_passes(p, {migraphx::rewrite_rnn{true}, migraphx::dead_code_elimination{}});
+        const auto* mm = p.get_main_module();
+        EXPECT(std::any_of(
+            mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "loop"; }));
+        return mm->size();
+    };
+    EXPECT(lower(4) == lower(256));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -24,10 +24,15 @@
 #include <migraphx/program.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/file_buffer.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
 
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 
 migraphx::program create_program()
 {
@@ -69,6 +74,84 @@ TEST_CASE(as_json)
     EXPECT(p1.sort() == p2.sort());
 }
 
+TEST_CASE(as_mmap)
+{
+    migraphx::file_options options;
+    options.format           = "mmap";
+    migraphx::program p1     = create_program();
+    std::vector<char> buffer = migraphx::save_buffer(p1, options);
+    migraphx::program p2     = migraphx::load_buffer(buffer, options);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(as_mmap_file)
+{
+    std::string filename = "migraphx_program_mmap.mxr";
+    migraphx::file_options options;
+    options.format       = "mmap";
+    migraphx::program p1 = create_program();
+    p1.compile(migraphx::make_target("ref"));
+    migraphx::save(p1, filename, options);
+    {
+        migraphx::program p2 = migraphx::load(filename, options);
+        EXPECT(p1.sort() == p2.sort());
+        // The first literal is at the start of the page-aligned data, so it is only aligned
+        // to a page when it refers to the mapped file
+        auto* mm = p2.get_main_module();
+        auto lit = std::find_if(mm->begin(), mm->end(), [](const auto& ins) {
+            return ins.name() == "@literal";
+        });
+        EXPECT(bool{lit != mm->end()});
+        EXPECT(reinterpret_cast<std::uintptr_t>(lit->get_literal().data()) % 4096 == 0);
+
+        migraphx::parameter_map params;
+        int x       = 3;
+        params["x"] = migraphx::argument{migraphx::shape{migraphx::shape::int32_type}, &x};
+        auto result = p2.eval(params).back();
+        EXPECT(result == migraphx::literal{5});
+    }
+    std::remove(filename.c_str());
+}
+
+TEST_CASE(invalid_mmap)
+{
+    migraphx::file_options options;
+    options.format           = "mmap";
+    std::vector<char> buffer = migraphx::save_buffer(create_program(), options);
+    buffer[0]                = 'X';
+    EXPECT(test::throws([&] { migraphx::load_buffer(buffer, options); }));
+    buffer.resize(16);
+    EXPECT(test::throws([&] { migraphx::load_buffer(buffer, options); }));
+}
+
+TEST_CASE(overflowing_mmap_sizes)
+{
+    migraphx::file_options options;
+    options.format           = "mmap";
+    std::vector<char> buffer = migraphx::save_buffer(create_program(), options);
+    // The sizes in the header wrap around when they are added to the offsets
+    auto set_field = [&](std::size_t offset, std::uint64_t x) {
+        std::vector<char> b = buffer;
+        std::memcpy(b.data() + offset, &x, sizeof(x));
+        return b;
+    };
+    const auto huge = std::numeric_limits<std::uint64_t>::max() - 8;
+    EXPECT(test::throws([&] { migraphx::load_buffer(set_field(16, huge), options); }));
+    EXPECT(test::throws([&] { migraphx::load_buffer(set_field(32, huge), options); }));
+}
+
+TEST_CASE(mmap_file_matches_buffer)
+{
+    std::string filename = "migraphx_program_mmap_buffer.mxr";
+    migraphx::file_options options;
+    options.format       = "mmap";
+    migraphx::program p1 = create_program();
+    migraphx::save(p1, filename, options);
+    auto file = migraphx::read_buffer(filename);
+    std::remove(filename.c_str());
+    EXPECT(file == migraphx::save_buffer(p1, options));
+}
+
 TEST_CASE(as_file)
 {
     std::string filename = "migraphx_program.mxr";
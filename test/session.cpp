@@ -0,0 +1,176 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/session.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/ref/target.hpp>
+#include <thread>
+#include "test.hpp"
+
+struct count_target
+{
+    struct context
+    {
+        std::size_t count = 0;
+        void finish() const {}
+    };
+    std::string name() const { return "count"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {};
+    }
+    migraphx::context get_context() const { return context{}; }
+};
+
+struct count_op
+{
+    std::string name() const { return "count_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const
+    {
+        return {migraphx::shape::uint64_type};
+    }
+    migraphx::argument compute(count_target::context& ctx,
+                               const migraphx::shape&,
+                               const std::vector<migraphx::argument>&) const
+    {
+        ctx.count++;
+        return migraphx::literal{ctx.count}.get_argument();
+    }
+};
+
+static std::size_t get_count(const std::vector<migraphx::argument>& results)
+{
+    return results.front().at<std::size_t>();
+}
+
+static migraphx::program create_add_mul()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, y);
+    mm->add_return({mul});
+    return p;
+}
+
+TEST_CASE(session_contexts)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    mm->add_instruction(count_op{});
+    p.compile(count_target{});
+
+    migraphx::session s1{p};
+    migraphx::session s2{p};
+    EXPECT(get_count(s1.eval({})) == 1);
+    EXPECT(get_count(s1.eval({})) == 2);
+    EXPECT(get_count(s2.eval({})) == 1);
+    EXPECT(get_count(p.eval({})) == 1);
+    EXPECT(get_count(s1.eval({})) == 3);
+    EXPECT(s1.get_contexts().size() == 1);
+    EXPECT(&s1.get_program() == &p);
+}
+
+TEST_CASE(session_copy)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    mm->add_instruction(count_op{});
+    p.compile(count_target{});
+
+    migraphx::session s1{p};
+    EXPECT(get_count(s1.eval({})) == 1);
+    // A copy gets new contexts instead of sharing the ones of the session it is copied from
+    migraphx::session s2{s1};
+    EXPECT(get_count(s2.eval({})) == 1);
+    EXPECT(get_count(s1.eval({})) == 2);
+    EXPECT(get_count(s2.eval({})) == 2);
+
+    migraphx::session s3{p};
+    s3 = s1;
+    EXPECT(get_count(s3.eval({})) == 1);
+    EXPECT(get_count(s1.eval({})) == 3);
+    EXPECT(&s3.get_program() == &p);
+}
+
+TEST_CASE(session_eval)
+{
+    auto p = create_add_mul();
+    p.compile(migraphx::make_target("ref"));
+    migraphx::parameter_map params;
+    params["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), 0);
+    params["y"] = migraphx::generate_argument(p.get_parameter_shape("y"), 1);
+    auto expected = p.eval(params);
+
+    migraphx::session s{p};
+    EXPECT(s.eval(params) == expected);
+    s.finish();
+}
+
+TEST_CASE(session_concurrent)
+{
+    auto p = create_add_mul();
+    p.compile(migraphx::make_target("ref"));
+    const std::size_t n = 4;
+    std::vector<migraphx::parameter_map> params(n);
+    std::vector<std::vector<migraphx::argument>> expected(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        params[i]["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), i);
+        params[i]["y"] = migraphx::generate_argument(p.get_parameter_shape("y"), i + n);
+        expected[i]    = p.eval(params[i]);
+    }
+
+    std::vector<migraphx::session> sessions(n, migraphx::session{p});
+    std::vector<std::size_t> mismatches(n, 0);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        threads.emplace_back([&, i] {
+            for(std::size_t j = 0; j < 50; j++)
+            {
+                if(sessions[i].eval(params[i]) != expected[i])
+                    mismatches[i]++;
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(std::all_of(mismatches.begin(), mismatches.end(), [](auto x) { return x == 0; }));
+}
+
+TEST_CASE(session_multi_target)
+{
+    auto p = create_add_mul();
+    p.compile(std::vector<migraphx::target>{migraphx::make_target("ref")});
+    EXPECT(test::throws([&] { migraphx::session{p}; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,155 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/ranges.hpp>
+#include "test.hpp"
+
+static std::vector<std::vector<std::size_t>> all_indices(const migraphx::shape& s)
+{
+    std::vector<std::vector<std::size_t>> result;
+    migraphx::shape_for_each(s, [&](const auto& idx, std::size_t i) {
+        EXPECT(i == result.size());
+        result.push_back(idx);
+    });
+    return result;
+}
+
+// Checks the offsets against shape::index for every element of the shapes
+template <std::size_t N>
+static bool verify_offsets(const migraphx::shape (&shapes)[N])
+{
+    std::vector<std::array<std::size_t, N>> offsets;
+    migraphx::shape_for_each_offset(shapes, [&](auto... xs) { offsets.push_back({xs...}); });
+    if(offsets.size() != shapes[0].elements())
+        return false;
+    return migraphx::all_of(migraphx::range(offsets.size()), [&](auto i) {
+        return migraphx::all_of(migraphx::range(N),
+                                [&](auto n) { return offsets[i][n] == shapes[n].index(i); });
+    });
+}
+
+TEST_CASE(for_each_order)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 2}};
+    auto indices = all_indices(s);
+    EXPECT(indices.size() == s.elements());
+    for(std::size_t i = 0; i < indices.size(); i++)
+        EXPECT(indices[i] == s.multi(i));
+}
+
+TEST_CASE(for_each_non_standard)
+{
+    // The indices only depend on the lens
+    migraphx::shape s{migraphx::shape::float_type, {3, 2}, {1, 3}};
+    std::vector<std::vector<std::size_t>> expected = {
+        {0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 0}, {2, 1}};
+    EXPECT(all_indices(s) == expected);
+}
+
+TEST_CASE(for_each_scalar)
+{
+    migraphx::shape s{migraphx::shape::float_type};
+    EXPECT(all_indices(s) == std::vector<std::vector<std::size_t>>{{0}});
+}
+
+TEST_CASE(offset_standard)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    EXPECT(verify_offsets({s, s}));
+}
+
+TEST_CASE(offset_transposed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape t{migraphx::shape::float_type, {2, 3, 4}, {1, 8, 2}};
+    EXPECT(verify_offsets({s, t}));
+}
+
+TEST_CASE(offset_broadcast)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape b1{migraphx::shape::float_type, {2, 3, 4}, {0, 1, 0}};
+    migraphx::shape b2{migraphx::shape::float_type, {2, 3, 4}, {0, 0, 0}};
+    EXPECT(verify_offsets({s, b1, b2}));
+}
+
+TEST_CASE(offset_sliced)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 2}};
+    migraphx::shape sliced{migraphx::shape::float_type, {2, 3, 2}, {15, 5, 1}};
+    EXPECT(verify_offsets({s, sliced}));
+}
+
+TEST_CASE(offset_single)
+{
+    migraphx::shape s{migraphx::shape::float_type, {5}, {3}};
+    EXPECT(verify_offsets({s}));
+}
+
+TEST_CASE(offset_scalar)
+{
+    migraphx::shape s{migraphx::shape::float_type};
+    EXPECT(verify_offsets({s, s}));
+}
+
+TEST_CASE(offset_empty)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 0, 3}};
+    std::size_t n = 0;
+    migraphx::shape_for_each_offset({s}, [&](auto) { n++; });
+    EXPECT(n == 0);
+}
+
+TEST_CASE(offset_ranges)
+{
+    // Any range of elements can be started on its own
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape t{migraphx::shape::float_type, {2, 3, 4}, {1, 8, 2}};
+    migraphx::detail::shape_offsets<2> offsets{{s, t}};
+    for(std::size_t first = 0; first < s.elements(); first++)
+    {
+        for(std::size_t last = first; last <= s.elements(); last++)
+        {
+            std::size_t i = first;
+            offsets.for_each(first, last, [&](auto x, auto y) {
+                EXPECT(x == s.index(i));
+                EXPECT(y == t.index(i));
+                i++;
+            });
+            EXPECT(i == last);
+        }
+    }
+}
+
+TEST_CASE(par_offset_transposed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {64, 33, 17}};
+    migraphx::shape t{migraphx::shape::float_type, {64, 33, 17}, {1, 64 * 17, 64}};
+    std::vector<std::size_t> result(s.elements());
+    migraphx::par_shape_for_each_offset({s, t}, [&](auto i, auto j) { result[i] = j; });
+    EXPECT(migraphx::all_of(migraphx::range(result.size()),
+                            [&](auto i) { return result[i] == t.index(i); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
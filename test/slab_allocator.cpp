@@ -0,0 +1,163 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/slab_allocator.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <set>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(arena_reuse)
+{
+    migraphx::slab_arena arena;
+    std::vector<void*> blocks;
+    for(int i = 0; i < 1000; i++)
+        blocks.push_back(arena.allocate(24));
+    EXPECT(arena.reserved() >= 1000 * 24);
+    EXPECT(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+
+    // Freed blocks are reused
+    auto reserved = arena.reserved();
+    arena.deallocate(blocks[5], 24);
+    auto* p = arena.allocate(24);
+    EXPECT(p == blocks[5]);
+    EXPECT(arena.reserved() == reserved);
+    for(auto* b : blocks)
+        arena.deallocate(b, 24);
+}
+
+TEST_CASE(arena_sizes)
+{
+    migraphx::slab_arena arena;
+    auto* small = arena.allocate(8);
+    auto* large = arena.allocate(200);
+    EXPECT(small != large);
+    EXPECT(reinterpret_cast<std::uintptr_t>(large) % alignof(std::max_align_t) == 0);
+    arena.deallocate(small, 8);
+    // A freed block is only reused for the same size
+    auto* other = arena.allocate(200);
+    EXPECT(other != small);
+    EXPECT(arena.allocate(8) == small);
+    arena.deallocate(large, 200);
+    arena.deallocate(other, 200);
+    arena.deallocate(small, 8);
+}
+
+TEST_CASE(allocator_list)
+{
+    std::list<int, migraphx::slab_allocator<int>> l1;
+    std::list<int, migraphx::slab_allocator<int>> l2;
+    EXPECT(bool{l1.get_allocator() != l2.get_allocator()});
+    for(int i = 0; i < 100; i++)
+        l1.push_back(i);
+    auto it    = std::next(l1.begin(), 10);
+    auto arena = l1.get_allocator().get_arena();
+
+    // Moving takes the arena with the elements
+    l2 = std::move(l1);
+    EXPECT(l2.get_allocator().get_arena() == arena);
+    EXPECT(*it == 10);
+    l1.push_back(1);
+    EXPECT(l1.size() == 1);
+}
+
+TEST_CASE(module_has_instruction)
+{
+    migraphx::module m1;
+    migraphx::module m2;
+    auto x   = m1.add_parameter("x", {migraphx::shape::float_type, {2}});
+    auto y   = m2.add_parameter("y", {migraphx::shape::float_type, {2}});
+    auto add = m1.add_instruction(migraphx::make_op("add"), x, x);
+    m1.add_return({add});
+    EXPECT(m1.has_instruction(x));
+    EXPECT(m1.has_instruction(add));
+    EXPECT(not m1.has_instruction(y));
+    EXPECT(not m2.has_instruction(x));
+    EXPECT(not m1.has_instruction(m1.end()));
+
+    auto neg = m1.insert_instruction(add, migraphx::make_op("neg"), x);
+    EXPECT(m1.has_instruction(neg));
+    m1.remove_instruction(neg);
+    EXPECT(m1.size() == 3);
+    // Renaming a parameter replaces the instruction in place
+    m1.rename_parameter(x, "z");
+    EXPECT(m1.has_instruction(x));
+
+    // Instructions belong to the module they are in after a move or a copy
+    migraphx::module m3 = std::move(m1);
+    EXPECT(m3.has_instruction(add));
+    migraphx::module m4 = m3;
+    EXPECT(not m4.has_instruction(add));
+    EXPECT(m4.has_instruction(std::prev(m4.end())));
+}
+
+TEST_CASE(module_copy_and_passes)
+{
+    // Enough instructions for the arena to grow past its first chunks
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<migraphx::instruction_ref> results = {m.add_parameter("x", s)};
+    for(std::size_t i = 0; i < 500; i++)
+    {
+        auto x = results[results.size() - 1 - i % std::min<std::size_t>(results.size(), 4)];
+        auto y = results.back();
+        auto op = migraphx::make_op(i % 2 == 0 ? "add" : "mul");
+        results.push_back(m.add_instruction(op, x, y));
+        // A duplicate for eliminate_common_subexpression to merge
+        if(i % 4 == 0)
+            results.push_back(m.add_instruction(op, x, y));
+    }
+    m.add_return({results.back()});
+    EXPECT(std::all_of(m.begin(), m.end(), [&](const auto& ins) {
+        return std::all_of(ins.inputs().begin(), ins.inputs().end(), [&](auto input) {
+            return m.has_instruction(input);
+        });
+    }));
+
+    migraphx::module copy = m;
+    EXPECT(copy.size() == m.size());
+    // The copy refers to its own instructions
+    EXPECT(std::all_of(copy.begin(), copy.end(), [&](const auto& ins) {
+        return std::none_of(ins.inputs().begin(), ins.inputs().end(), [&](auto input) {
+            return m.has_instruction(input);
+        });
+    }));
+
+    auto n = m.size();
+    migraphx::run_passes(m,
+                         {migraphx::eliminate_common_subexpression{},
+                          migraphx::dead_code_elimination{}});
+    EXPECT(m.size() < n);
+    EXPECT(copy.size() == n);
+    EXPECT(not m.has_instruction(std::prev(copy.end())));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <numeric>
+#include "test.hpp"
+
+static migraphx::program create_dyn_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 8}, {3, 3}}};
+    auto x   = mm->add_parameter("x", s);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, x);
+    mm->add_instruction(migraphx::make_op("neg"), add);
+    return p;
+}
+
+static migraphx::argument make_input(std::size_t n, std::vector<float>& data)
+{
+    data.resize(n * 3);
+    std::iota(data.begin(), data.end(), 1);
+    return {{migraphx::shape::float_type, {n, 3}}, data.data()};
+}
+
+static std::vector<float> to_vector(const migraphx::argument& arg)
+{
+    std::vector<float> result;
+    arg.visit([&](auto v) { result.assign(v.begin(), v.end()); });
+    return result;
+}
+
+TEST_CASE(cache_hit_miss)
+{
+    migraphx::specialization_cache cache{create_dyn_program(), migraphx::make_target("ref")};
+    std::vector<float> data;
+    auto r1 = cache.eval({{"x", make_input(2, data)}});
+    EXPECT(r1.front().get_shape() == migraphx::shape{migraphx::shape::float_type, {2, 3}});
+    EXPECT(to_vector(r1.front()) == std::vector<float>{-2, -4, -6, -8, -10, -12});
+    cache.eval({{"x", make_input(2, data)}});
+    auto r3 = cache.eval({{"x", make_input(4, data)}});
+    EXPECT(r3.front().get_shape().lens() == std::vector<std::size_t>{4, 3});
+    EXPECT(cache.size() == 2);
+
+    auto stats = cache.get_stats();
+    EXPECT(stats.hits == 1);
+    EXPECT(stats.misses == 2);
+    EXPECT(stats.evictions == 0);
+    EXPECT(stats.compile_time > 0);
+}
+
+TEST_CASE(cache_buckets)
+{
+    migraphx::specialization_options options;
+    options.buckets = {4, 2};
+    migraphx::specialization_cache cache{
+        create_dyn_program(), migraphx::make_target("ref"), {}, options};
+    std::vector<float> data;
+    auto r1 = cache.eval({{"x", make_input(3, data)}});
+    EXPECT(r1.front().get_shape().lens() == std::vector<std::size_t>{4, 3});
+    EXPECT(to_vector(r1.front()) ==
+           std::vector<float>{-2, -4, -6, -8, -10, -12, -14, -16, -18, 0, 0, 0});
+    cache.eval({{"x", make_input(4, data)}});
+    auto r3 = cache.eval({{"x", make_input(2, data)}});
+    EXPECT(r3.front().get_shape().lens() == std::vector<std::size_t>{2, 3});
+    // Sizes past the last bucket are compiled exactly
+    auto r4 = cache.eval({{"x", make_input(7, data)}});
+    EXPECT(r4.front().get_shape().lens() == std::vector<std::size_t>{7, 3});
+
+    auto stats = cache.get_stats();
+    EXPECT(stats.hits == 1);
+    EXPECT(stats.misses == 3);
+    EXPECT(cache.size() == 3);
+}
+
+TEST_CASE(cache_lru_eviction)
+{
+    migraphx::specialization_options options;
+    options.max_entries = 2;
+    migraphx::specialization_cache cache{
+        create_dyn_program(), migraphx::make_target("ref"), {}, options};
+    std::vector<float> data;
+    cache.eval({{"x", make_input(1, data)}});
+    cache.eval({{"x", make_input(2, data)}});
+    // Use 1 so that 2 is the least recently used
+    cache.eval({{"x", make_input(1, data)}});
+    cache.eval({{"x", make_input(3, data)}});
+    EXPECT(cache.size() == 2);
+    EXPECT(cache.get_stats().evictions == 1);
+    cache.eval({{"x", make_input(1, data)}});
+    EXPECT(cache.get_stats().hits == 2);
+    cache.eval({{"x", make_input(2, data)}});
+    EXPECT(cache.get_stats().misses == 4);
+    EXPECT(cache.get_stats().evictions == 2);
+}
+
+TEST_CASE(cache_max_bytes)
+{
+    migraphx::specialization_options options;
+    options.max_bytes = 1;
+    migraphx::specialization_cache cache{
+        create_dyn_program(), migraphx::make_target("ref"), {}, options};
+    std::vector<float> data;
+    auto r1 = cache.eval({{"x", make_input(1, data)}});
+    EXPECT(cache.size() == 1);
+    EXPECT(to_vector(r1.front()) == std::vector<float>{-2, -4, -6});
+    cache.eval({{"x", make_input(2, data)}});
+    EXPECT(cache.size() == 1);
+    EXPECT(cache.get_stats().evictions == 1);
+}
+
+TEST_CASE(cache_get_program)
+{
+    migraphx::specialization_cache cache{create_dyn_program(), migraphx::make_target("ref")};
+    std::vector<float> data;
+    const auto& p = cache.get_program({{"x", make_input(5, data)}});
+    EXPECT(p.is_compiled());
+    EXPECT(p.get_parameter_shape("x") ==
+           migraphx::shape{migraphx::shape::float_type, {5, 3}});
+    cache.eval({{"x", make_input(5, data)}});
+    EXPECT(cache.get_stats().hits == 1);
+}
+
+TEST_CASE(cache_errors)
+{
+    migraphx::specialization_cache cache{create_dyn_program(), migraphx::make_target("ref")};
+    std::vector<float> data;
+    EXPECT(test::throws([&] { cache.eval({}); }));
+    EXPECT(test::throws([&] { cache.eval({{"x", make_input(9, data)}}); }));
+    migraphx::argument bad{migraphx::shape{migraphx::shape::float_type, {2, 4}}};
+    EXPECT(test::throws([&] { cache.eval({{"x", bad}}); }));
+
+    auto p = create_dyn_program();
+    p.compile(migraphx::make_target("ref"));
+    EXPECT(test::throws([&] { migraphx::specialization_cache{p, migraphx::make_target("ref")}; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/errors.hpp>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(par_for_visits_all)
+{
+    const std::size_t n = 100000;
+    std::vector<std::size_t> visited(n, 0);
+    migraphx::par_for(n, [&](auto i) { visited[i]++; });
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto x) { return x == 1; }));
+}
+
+TEST_CASE(simple_par_for_tid)
+{
+    const std::size_t n = 4096;
+    auto threadsize     = std::max<std::size_t>(2, migraphx::get_num_threads());
+    std::vector<std::size_t> tids(n, threadsize);
+    migraphx::simple_par_for_impl(n, threadsize, [&](auto i, auto tid) { tids[i] = tid; });
+    EXPECT(std::all_of(tids.begin(), tids.end(), [&](auto tid) { return tid < threadsize; }));
+}
+
+TEST_CASE(parallel_range_for_ranges)
+{
+    const std::size_t n = 12345;
+    std::atomic<std::size_t> total{0};
+    std::vector<std::size_t> visited(n, 0);
+    migraphx::parallel_range_for(n, 4, [&](auto start, auto last, auto) {
+        EXPECT(start < last);
+        EXPECT(last <= n);
+        for(auto i = start; i < last; i++)
+            visited[i]++;
+        total += last - start;
+    });
+    EXPECT(total.load() == n);
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto x) { return x == 1; }));
+}
+
+TEST_CASE(nested_par_for)
+{
+    const std::size_t n = 64;
+    std::vector<std::size_t> sums(n, 0);
+    migraphx::set_num_threads(4);
+    EXPECT(not migraphx::in_parallel_region());
+    migraphx::par_for(n, 1, [&](auto i) {
+        EXPECT(migraphx::in_parallel_region());
+        std::vector<std::size_t> inner(n, 1);
+        migraphx::par_for(n, 1, [&](auto j) { inner[j] = j; });
+        sums[i] = std::accumulate(inner.begin(), inner.end(), std::size_t{0});
+    });
+    EXPECT(not migraphx::in_parallel_region());
+    EXPECT(std::all_of(sums.begin(), sums.end(), [&](auto x) { return x == n * (n - 1) / 2; }));
+    migraphx::set_num_threads(0);
+}
+
+TEST_CASE(par_for_exception)
+{
+    EXPECT(test::throws([] {
+        migraphx::par_for(1024, 1, [&](auto i) {
+            if(i == 512)
+                MIGRAPHX_THROW("par_for error");
+        });
+    }));
+    // The pool is still usable after an exception
+    std::atomic<std::size_t> count{0};
+    migraphx::par_for(1024, 1, [&](auto) { count++; });
+    EXPECT(count.load() == 1024);
+}
+
+TEST_CASE(set_num_threads)
+{
+    auto original = migraphx::get_num_threads();
+    migraphx::set_num_threads(3);
+    EXPECT(migraphx::get_num_threads() == 3);
+    const std::size_t n = 1000;
+    std::vector<std::size_t> tids(n, 0);
+    migraphx::simple_par_for_impl(n, 8, [&](auto i, auto tid) { tids[i] = tid; });
+    EXPECT(std::all_of(tids.begin(), tids.end(), [](auto tid) { return tid < 3; }));
+    migraphx::set_num_threads(0);
+    EXPECT(migraphx::get_num_threads() == original);
+}
+
+TEST_CASE(par_for_uses_pool)
+{
+    // par_for without a grain size goes through the pool as well
+    const std::size_t n = 256;
+    std::atomic<std::size_t> outside{0};
+    migraphx::set_num_threads(4);
+    migraphx::par_for(n, [&](auto) {
+        if(not migraphx::in_parallel_region())
+            outside++;
+    });
+    EXPECT(outside.load() == 0);
+
+    std::atomic<std::size_t> other{0};
+    auto id = std::this_thread::get_id();
+    migraphx::set_num_threads(1);
+    migraphx::par_for(n, [&](auto) {
+        if(std::this_thread::get_id() != id)
+            other++;
+    });
+    EXPECT(other.load() == 0);
+    migraphx::set_num_threads(0);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
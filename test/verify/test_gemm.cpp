@@ -44,6 +44,7 @@ struct test_gemm : verify_program<test_gemm<DType>>
 
 template struct test_gemm<migraphx::shape::float_type>;
 template struct test_gemm<migraphx::shape::half_type>;
+template struct test_gemm<migraphx::shape::bf16_type>;
 template struct test_gemm<migraphx::shape::fp8e4m3fnuz_type>;
 template struct test_gemm<migraphx::shape::fp8e5m2fnuz_type>;
 template struct test_gemm<migraphx::shape::fp8e4m3fn_type>;
@@ -41,6 +41,7 @@
 #include <migraphx/serialize.hpp>
 #include <migraphx/auto_any_cast.hpp>
 #include <migraphx/lifetime.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/config.hpp>
 
 namespace migraphx {
@@ -82,6 +83,12 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method to estimate the arithmetic operations and the bytes moved to compute
+    /// the output from the inputs. By default, the inputs are read once and the output is
+    /// written once, and views that alias their input move nothing.
+    op_cost estimate_cost(const shape& output,
+                          const std::vector<shape>& input,
+                          const std::vector<module_ref>& mod_args) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -494,6 +501,63 @@ lifetime get_lifetime_op(const T&)
     return lifetime::local;
 }
 
+template <class T>
+auto estimate_cost_op(rank<3>,
+                      const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>& mod_args)
+    -> decltype(x.estimate_cost(output, inputs, mod_args))
+{
+    return x.estimate_cost(output, inputs, mod_args);
+}
+
+template <class T>
+auto estimate_cost_op(rank<2>,
+                      const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>&) -> decltype(x.estimate_cost(output, inputs))
+{
+    return x.estimate_cost(output, inputs);
+}
+
+template <class T>
+auto estimate_cost_op(rank<1>,
+                      const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>&) -> decltype(x.output_alias(inputs), op_cost{})
+{
+    auto alias = x.output_alias(inputs);
+    if(alias < 0)
+        return memory_cost(output, inputs);
+    // Writes the output into the allocation passed as the last input
+    if(inputs.size() > 1 and static_cast<std::size_t>(alias) == inputs.size() - 1)
+        return memory_cost(output, {inputs.begin(), inputs.end() - 1});
+    // A view of its input
+    return {};
+}
+
+template <class T>
+op_cost estimate_cost_op(rank<0>,
+                         const T&,
+                         const shape& output,
+                         const std::vector<shape>& inputs,
+                         const std::vector<module_ref>&)
+{
+    return memory_cost(output, inputs);
+}
+
+template <class T>
+op_cost estimate_cost_op(const T& x,
+                         const shape& output,
+                         const std::vector<shape>& inputs,
+                         const std::vector<module_ref>& mod_args)
+{
+    return estimate_cost_op(rank<3>{}, x, output, inputs, mod_args);
+}
+
 } // namespace detail
 
 <%
@@ -514,6 +578,13 @@ lifetime get_lifetime_op(const T&)
              input   = 'const std::vector<shape>&',
              const   = True,
              default = 'detail::output_alias_op'),
+     virtual('estimate_cost',
+             returns  = 'op_cost',
+             output   = 'const shape&',
+             input    = 'const std::vector<shape>&',
+             mod_args = 'const std::vector<module_ref>&',
+             const    = True,
+             default  = 'detail::estimate_cost_op'),
      virtual('compile',
              returns = 'value',
              ctx     = 'context&',
@@ -675,6 +746,23 @@ bool has_finalize(const T& x)
     return detail::has_finalize_op(x);
 }
 
+inline op_cost estimate_cost(const operation& op,
+                             const shape& output,
+                             const std::vector<shape>& inputs,
+                             const std::vector<module_ref>& mod_args = {})
+{
+    return op.estimate_cost(output, inputs, mod_args);
+}
+
+template <class T>
+op_cost estimate_cost(const T& x,
+                      const shape& output,
+                      const std::vector<shape>& inputs,
+                      const std::vector<module_ref>& mod_args = {})
+{
+    return detail::estimate_cost_op(x, output, inputs, mod_args);
+}
+
 MIGRAPHX_EXPORT void migraphx_to_value(value& v, const operation& op);
 MIGRAPHX_EXPORT void migraphx_from_value(const value& v, operation& op);
 